@@ -287,6 +287,33 @@ count(InputIterator first,InputIterator last,const T& value){
     return ret;
 }
 
+/*位迭代器版本：按字popcount，首尾不完整的字用掩码截取。*/
+inline ptrdiff_t __bit_count_true(__bit_const_iterator first,__bit_const_iterator last){
+    ptrdiff_t n = last - first;
+    ptrdiff_t ret = 0;
+    const __bit_word* p = first.p;
+    if(n > 0 && first.offset != 0){
+        unsigned k = (unsigned)__bit_min(n,ptrdiff_t(__WORD_BIT - first.offset));
+        ret += __bit_popcount(*p & __bit_mask(first.offset,k));
+        n -= k;
+        ++p;
+    }
+    for(; n >= __WORD_BIT; n -= __WORD_BIT,++p)
+        ret += __bit_popcount(*p);
+    if(n > 0)
+        ret += __bit_popcount(*p & __bit_mask(0,(unsigned)n));
+    return ret;
+}
+
+inline ptrdiff_t count(__bit_const_iterator first,__bit_const_iterator last,const bool& value){
+    const ptrdiff_t ones = __bit_count_true(first,last);
+    return value ? ones : (last - first) - ones;
+}
+
+inline ptrdiff_t count(__bit_iterator first,__bit_iterator last,const bool& value){
+    return count(__bit_const_iterator(first),__bit_const_iterator(last),value);
+}
+
 /***********************************************count_if************************************************
 *   对容器[first,last)范围进行comp操作，返回操作成功的个数。
 ********************************************************************************************************/
@@ -442,16 +469,78 @@ equal_range(ForwardIterator first,ForwardIterator last,const T& value,Compare co
 *   查找容器[first,last)范围第一个找到的元素value，并返回找到元素的迭代器。
 ********************************************************************************************************/
 template<class InputIterator,class T>
-InputIterator find(InputIterator first,InputIterator last,const T& value){
+InputIterator __find_segment(InputIterator first,InputIterator last,const T& value,__false_type){
     while(first != last && *first != value) ++first;
     return first;
 }
 
+/*分段迭代器版本：逐段在连续区间内查找，命中后再合成原迭代器。*/
+template<class SegmentedIterator,class T>
+SegmentedIterator __find_segment(SegmentedIterator first,SegmentedIterator last,
+    const T& value,__true_type){
+    typedef __segmented_iterator_traits<SegmentedIterator> traits;
+    typedef typename traits::local_iterator local_iterator;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    local_iterator l = traits::local(first);
+    for(; sfirst != slast; ++sfirst,l = traits::begin(sfirst)){
+        local_iterator e = traits::end(sfirst);
+        local_iterator it = __find_segment(l,e,value,__false_type());
+        if(it != e) return traits::compose(sfirst,it);
+    }
+    local_iterator e = traits::local(last);
+    local_iterator it = __find_segment(l,e,value,__false_type());
+    return it != e ? traits::compose(sfirst,it) : last;
+}
+
+template<class InputIterator,class T>
+InputIterator find(InputIterator first,InputIterator last,const T& value){
+    typedef typename __segmented_iterator_traits<InputIterator>::is_segmented_iterator seg;
+    return __find_segment(first,last,value,seg());
+}
+
+/*
+*   位迭代器版本：找false时把字取反，统一成找第一个1，
+* 每个字用ctz一次定位，而不是逐位比较。
+*/
+inline __bit_const_iterator find(__bit_const_iterator first,__bit_const_iterator last,
+    const bool& value){
+    const __bit_word flip = value ? __bit_word(0) : ~__bit_word(0);
+    ptrdiff_t n = last - first;
+    const __bit_word* p = first.p;
+    ptrdiff_t pos = 0;
+    if(n > 0 && first.offset != 0){
+        unsigned k = (unsigned)__bit_min(n,ptrdiff_t(__WORD_BIT - first.offset));
+        __bit_word w = (*p ^ flip) & __bit_mask(first.offset,k);
+        if(w != 0)
+            return first + (__bit_ctz(w) - int(first.offset));
+        pos += k;
+        n -= k;
+        ++p;
+    }
+    for(; n >= __WORD_BIT; n -= __WORD_BIT,pos += __WORD_BIT,++p){
+        __bit_word w = *p ^ flip;
+        if(w != 0)
+            return first + (pos + __bit_ctz(w));
+    }
+    if(n > 0){
+        __bit_word w = (*p ^ flip) & __bit_mask(0,(unsigned)n);
+        if(w != 0)
+            return first + (pos + __bit_ctz(w));
+    }
+    return last;
+}
+
+inline __bit_iterator find(__bit_iterator first,__bit_iterator last,const bool& value){
+    return first + (find(__bit_const_iterator(first),__bit_const_iterator(last),value) -
+        __bit_const_iterator(first));
+}
+
 /***********************************************find_if************************************************
 *   查找容器[first,last)范围第一个使得输入自定义函数comp为true的元素，并返回找到元素的迭代器。
 ********************************************************************************************************/
 template<class InputIterator,class Compare>
-InputIterator find(InputIterator first,InputIterator last,Compare comp){
+InputIterator find_if(InputIterator first,InputIterator last,Compare comp){
     while(first != last && !comp(*first))  ++first;
     return first;
 }
@@ -581,9 +670,32 @@ InputIterator find_first_of(InputIterator first1,InputIterator last1,
 *  对[first1,last1)所有元素执行func()操作，但不能改变元素内容，func()可以返回一个值，但会被忽略。
 ************************************************************************************************************/
 template<class InputIterator,class Function>
-Function for_each(InputIterator first,InputIterator last,Function func){
+void __for_each_segment(InputIterator first,InputIterator last,Function& func,__false_type){
     for(;first != last; ++first)
         func(*first);
+}
+
+/*分段迭代器版本：逐段遍历连续区间，省去每次++都要做的段边界判断。*/
+template<class SegmentedIterator,class Function>
+void __for_each_segment(SegmentedIterator first,SegmentedIterator last,
+    Function& func,__true_type){
+    typedef __segmented_iterator_traits<SegmentedIterator> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    if(sfirst == slast){
+        __for_each_segment(traits::local(first),traits::local(last),func,__false_type());
+        return;
+    }
+    __for_each_segment(traits::local(first),traits::end(sfirst),func,__false_type());
+    for(++sfirst; sfirst != slast; ++sfirst)
+        __for_each_segment(traits::begin(sfirst),traits::end(sfirst),func,__false_type());
+    __for_each_segment(traits::begin(slast),traits::local(last),func,__false_type());
+}
+
+template<class InputIterator,class Function>
+Function for_each(InputIterator first,InputIterator last,Function func){
+    typedef typename __segmented_iterator_traits<InputIterator>::is_segmented_iterator seg;
+    __for_each_segment(first,last,func,seg());
     return func;
 }
 
@@ -680,11 +792,11 @@ template<class T>
 inline T median(const T& l,const T& m,const T& r){
     if(l < m){
         if(m < r)       /* l < m < r*/
-            return l;
+            return m;
         else if(l < r)  /* l < r <= m 根据上一个if条件m<r不满足所以 r <= m */ 
             return r;
         else            /* r <= l < m 根据上一个if条件不满足，所以m不可能等于r*/
-            return m;
+            return l;
     }else if(l < r){ /*前一个if条件不满足得： m <= l, 又 l < r,所以 m <= l < r*/
         return l;
     }else if(m < r){/*由上个if条件不满足： l >= m, l >= r, 又 m < r 得 m < r <= l*/
@@ -699,11 +811,11 @@ template<class T,class Compare>
 inline T median(const T& l,const T& m,const T& r,Compare comp){
     if(comp(l, m)){
         if(comp(m,r))       /* l < m < r*/
-            return l;
+            return m;
         else if(comp(l,r))  /* l < r <= m 根据上一个if条件m<r不满足所以 r <= m */ 
             return r;
         else            /* r <= l < m 根据上一个if条件不满足，所以m不可能等于r*/
-            return m;
+            return l;
     }else if(comp(l,r)){ /*前一个if条件不满足得： m <= l, 又 l < r,所以 m <= l < r*/
         return l;
     }else if(comp(m,r)){/*由上个if条件不满足： l >= m, l >= r, 又 m < r 得 m < r <= l*/
@@ -817,7 +929,8 @@ bool next_permutation(BidirectionalIterator first,BidirectionalIterator last,Com
 *  对整个序列做部分排序，保证较小的N个元素以递增顺序位于[first,first + N);
 *****************************************************************************************************************/
 template<class RandomAccessIterator,class T>
-void __partial_sort(RandomAccessIterator first,RandomAccessIterator middle,RandomAccessIterator last){
+void __partial_sort(RandomAccessIterator first,RandomAccessIterator middle,
+    RandomAccessIterator last,T*){
     make_heap(first,middle);
     /*
     *   建好前半段的堆，然后依次判断后半段是否小于堆顶元素，
@@ -834,7 +947,7 @@ void __partial_sort(RandomAccessIterator first,RandomAccessIterator middle,Rando
 
 template<class RandomAccessIterator>
 void partial_sort(RandomAccessIterator first,RandomAccessIterator middle,RandomAccessIterator last){
-    __partial_sort(first,middle,last);
+    __partial_sort(first,middle,last,value_type(first));
 }
 
 /*使用仿函数comp版本*/
@@ -843,8 +956,8 @@ void __partial_sort(RandomAccessIterator first,RandomAccessIterator middle,
     RandomAccessIterator last,Compare comp,T*){
     make_heap(first,middle,comp);
     for(RandomAccessIterator it = middle; it < last; ++it){
-        if(*it < *first)
-            pop_heap_aux(first,middle,it,T(*it),distance_type(first),comp);
+        if(comp(*it,*first))
+            pop_head_aux(first,middle,it,T(*it),distance_type(first),comp);
     }
     sort_heap(first,middle,comp);
 }
@@ -1479,7 +1592,7 @@ ForwardIterator unique(ForwardIterator first,ForwardIterator last,Compare comp){
 template<class Size>
 inline Size __lg(Size n){ /*得到使得 2^result <= n 时，result的最大值。*/
     Size result;
-    for(result = 0; n > 1 ; n >> 1) ++result;
+    for(result = 0; n > 1 ; n >>= 1) ++result;
     return result;
 }
 
@@ -1489,9 +1602,9 @@ __unguarded_partition(RandomAccessIterator first,RandomAccessIterator last,T piv
     while(true){
         while(*first < pivot) ++first; /*找到第一个大于pivot的元素*/
         --last;
-        while(*pivot < *last) --last; /*从右往左找到第一个小于last的元素。*/
+        while(pivot < *last) --last; /*从右往左找到第一个小于last的元素。*/
         if(!(first < last)) return first; /*交错，循环结束。*/
-        iter_swap(first,last); /*交换两个位置。*/
+        mjstl::iter_swap(first,last); /*交换两个位置。*/
         ++first;
     }
 }
@@ -1538,7 +1651,7 @@ template<class RandomAccessIterator,class T>
 inline void __linear_insert(RandomAccessIterator first,RandomAccessIterator last,T*){
     T value = *last;
     if(value < *first){
-        copy_backward(first,last,last+1);
+        mjstl::copy_backward(first,last,last+1);
         *first = value;
     }else  /*前一个if条件不成立，保证了value一定不是第一个元素，那么下面这个函数可以调用。*/
         __unguarded_linear_insert(last,value);
@@ -1591,9 +1704,9 @@ __unguarded_partition(RandomAccessIterator first,RandomAccessIterator last,
     while(true){
         while(comp(*first,pivot)) ++first; /*找到第一个大于pivot的元素*/
         --last;
-        while(comp(*pivot,*last)) --last; /*从右往左找到第一个小于last的元素。*/
+        while(comp(pivot,*last)) --last; /*从右往左找到第一个小于last的元素。*/
         if(!(first < last)) return first; /*交错，循环结束。*/
-        iter_swap(first,last); /*交换两个位置。*/
+        mjstl::iter_swap(first,last); /*交换两个位置。*/
         ++first;
     }
 }
@@ -1610,8 +1723,8 @@ void __introsort_loop(RandomAccessIterator first,RandomAccessIterator last,
 
         --depth_limit;
         RandomAccessIterator cut = __unguarded_partition(first,last,
-            T(median(*first,*(first + (last - first)/2),*(last-1))),comp);
-        __introsort_loop(cut,last,value_type(first),depth_limit);
+            T(median(*first,*(first + (last - first)/2),*(last-1),comp)),comp);
+        __introsort_loop(cut,last,value_type(first),depth_limit,comp);
         last = cut;
     }
 }
@@ -1633,7 +1746,7 @@ inline void __linear_insert(RandomAccessIterator first,
     RandomAccessIterator last,T*,Compare comp){
     T value = *last;
     if(comp(value,*first)){
-        copy_backward(first,last,last+1);
+        mjstl::copy_backward(first,last,last+1);
         *first = value;
     }else  /*前一个if条件不成立，保证了value一定不是第一个元素，那么下面这个函数可以调用。*/
         __unguarded_linear_insert(last,value,comp);
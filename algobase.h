@@ -12,12 +12,29 @@
 #endif//! USE_CMATH
 
 #include "iterator.h"
+#include "bit_iterator.h"
 #include "type_traits.h"
 #include "pair.h"
 #include "util.h"
 
 namespace mjstl{
 
+/*分段迭代器版本会对每一段递归调用以下算法，所以先声明。*/
+template<class InputIterator, class OutputIterator>
+inline OutputIterator
+copy(InputIterator first, InputIterator last, OutputIterator result);
+template<class BidirectionalIterator1, class BidirectionalIterator2>
+inline BidirectionalIterator2
+copy_backward(BidirectionalIterator1 first,BidirectionalIterator1 last,
+    BidirectionalIterator2 result);
+template<class InputIterator1,class InputIterator2>
+inline bool 
+equal(InputIterator1 first1,InputIterator1 last1,
+    InputIterator2 first2,InputIterator2 last2);
+template<class ForwardIterator,class T>
+void fill(ForwardIterator first,ForwardIterator last,const T& value);
+void fill(char* first,char* last,const char& value);
+
 /***********************************************copy***********************************************/
 /*这个copy行为只有在传入的是指针，并且是has_trivial_assignment_operator时才使用memmove。*/
 /*__copy_d*/
@@ -92,12 +109,76 @@ struct __copy_dispatch<const T*,T*>{
 
 
 
+/*
+*   分段迭代器版本(见__segmented_iterator_traits)：
+*   源区间分段时逐段拷贝，每段是连续指针区间；目的区间分段而源区间可随机访问时，
+* 按目的段切块。段内拷贝最终落到指针版本，平凡类型直接memmove。
+*/
 template<class InputIterator, class OutputIterator>
 inline OutputIterator
-copy(InputIterator first, InputIterator last, OutputIterator result){
+__copy_segment(InputIterator first, InputIterator last, 
+    OutputIterator result,__false_type,__false_type){
     return __copy_dispatch<InputIterator,OutputIterator>()(first,last,result);
 }
 
+template<class SegmentedIterator, class OutputIterator, class OutSegmented>
+OutputIterator
+__copy_segment(SegmentedIterator first, SegmentedIterator last, 
+    OutputIterator result,__true_type,OutSegmented){
+    typedef __segmented_iterator_traits<SegmentedIterator> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    if(sfirst == slast)
+        return mjstl::copy(traits::local(first),traits::local(last),result);
+    result = mjstl::copy(traits::local(first),traits::end(sfirst),result);
+    for(++sfirst; sfirst != slast; ++sfirst)
+        result = mjstl::copy(traits::begin(sfirst),traits::end(sfirst),result);
+    return mjstl::copy(traits::begin(slast),traits::local(last),result);
+}
+
+template<class InputIterator, class SegmentedIterator>
+inline SegmentedIterator
+__copy_to_segment(InputIterator first, InputIterator last, 
+    SegmentedIterator result,input_iterator_tag){
+    return __copy_dispatch<InputIterator,SegmentedIterator>()(first,last,result);
+}
+
+template<class RandomAccessIterator, class SegmentedIterator>
+SegmentedIterator
+__copy_to_segment(RandomAccessIterator first, RandomAccessIterator last, 
+    SegmentedIterator result,random_access_iterator_tag){
+    typedef __segmented_iterator_traits<SegmentedIterator> traits;
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    typename traits::segment_iterator seg = traits::segment(result);
+    typename traits::local_iterator l = traits::local(result);
+    Distance n = last - first;
+    while(true){
+        Distance room = static_cast<Distance>(traits::end(seg) - l);
+        Distance len = n < room ? n : room;
+        mjstl::copy(first,first + len,l);
+        first += len;
+        n -= len;
+        if(n == 0) return traits::compose(seg,l + len);
+        ++seg;
+        l = traits::begin(seg);
+    }
+}
+
+template<class InputIterator, class SegmentedIterator>
+inline SegmentedIterator
+__copy_segment(InputIterator first, InputIterator last, 
+    SegmentedIterator result,__false_type,__true_type){
+    return __copy_to_segment(first,last,result,iterator_category(first));
+}
+
+template<class InputIterator, class OutputIterator>
+inline OutputIterator
+copy(InputIterator first, InputIterator last, OutputIterator result){
+    typedef typename __segmented_iterator_traits<InputIterator>::is_segmented_iterator seg1;
+    typedef typename __segmented_iterator_traits<OutputIterator>::is_segmented_iterator seg2;
+    return __copy_segment(first,last,result,seg1(),seg2());
+}
+
 //const char* special version
 inline char* copy(const char* first, const char* last, char* result){
     memmove(result,first,last-first);
@@ -109,6 +190,52 @@ inline wchar_t* copy(const wchar_t* first, const wchar_t* last, wchar_t* result)
     return result + (last - first);
 }
 
+/*
+*   位迭代器版本：一次搬运一个字(__WORD_BIT位)，而不是一位一位地赋值。
+*   源和目的字内偏移相同时，中间整字部分直接memmove。
+*/
+inline void __bit_copy(const __bit_word* sp,unsigned soff,
+    __bit_word* dp,unsigned doff,ptrdiff_t n){
+    if(n <= 0) return;
+    if(soff == doff){
+        if(soff != 0){
+            unsigned k = (unsigned)__bit_min(n,ptrdiff_t(__WORD_BIT - soff));
+            __bit_store(dp,doff,k,__bit_load(sp,soff,k));
+            n -= k;
+            ++sp;
+            ++dp;
+        }
+        const ptrdiff_t words = n / __WORD_BIT;
+        if(words > 0)
+            memmove(dp,sp,size_t(words) * sizeof(__bit_word));
+        n -= words * __WORD_BIT;
+        if(n > 0)
+            __bit_store(dp + words,0,(unsigned)n,__bit_load(sp + words,0,(unsigned)n));
+        return;
+    }
+    /*偏移不同，每次取一个字长的位段，移位后写入。*/
+    while(n > 0){
+        unsigned k = (unsigned)__bit_min(n,ptrdiff_t(__WORD_BIT));
+        __bit_store(dp,doff,k,__bit_load(sp,soff,k));
+        n -= k;
+        sp += (soff + k) / __WORD_BIT;
+        soff = (soff + k) % __WORD_BIT;
+        dp += (doff + k) / __WORD_BIT;
+        doff = (doff + k) % __WORD_BIT;
+    }
+}
+
+inline __bit_iterator copy(__bit_const_iterator first,__bit_const_iterator last,
+    __bit_iterator result){
+    const ptrdiff_t n = last - first;
+    __bit_copy(first.p,first.offset,result.p,result.offset,n);
+    return result + n;
+}
+
+inline __bit_iterator copy(__bit_iterator first,__bit_iterator last,__bit_iterator result){
+    return copy(__bit_const_iterator(first),__bit_const_iterator(last),result);
+}
+
 /***********************************************copy_backward***********************************************/
 /*
 *   用来将元素从背后开始复制，范围也满足左闭右开约定。例如：
@@ -152,49 +279,215 @@ template<class T>
 struct __copy_backward_dispatch<T*,T*,__true_type>{
     static T* copy(T* first,T* last,T* result){
         const ptrdiff_t n = last - first;
-        memmove(result-n,first,n*sizeof(T));
-        return result-n;
+        if(n > 0)
+            memmove(result - n,first,size_t(n) * sizeof(T));
+        return result - n;
     }
 };
 
 template<class T>
 struct __copy_backward_dispatch<const T*,T*,__true_type>{
-    static const T* copy(const T* first,const T* last,T* result){
-        const ptrdiff_t n = last - first;
-        return __copy_backward_dispatch<T*,T*,__true_type>::copy(first,last,result);
+    static T* copy(const T* first,const T* last,T* result){
+        return __copy_backward_dispatch<T*,T*,__true_type>::copy(
+            const_cast<T*>(first),const_cast<T*>(last),result);
     }
 };
 
+/*分段迭代器版本：与copy相同，但从最后一段往前处理。*/
 template<class BidirectionalIterator1, class BidirectionalIterator2>
 inline BidirectionalIterator2
-copy_backward(BidirectionalIterator1 first,BidirectionalIterator1 last,
-    BidirectionalIterator2 result){
+__copy_backward_segment(BidirectionalIterator1 first,BidirectionalIterator1 last,
+    BidirectionalIterator2 result,__false_type,__false_type){
     typedef typename iterator_traits<BidirectionalIterator1>::value_type value_type;
     typedef typename __type_traits<value_type>::has_trivial_assignment_operator trivaial_assign;
-    return __copy_backward_dispatch<BidirectionalIterator1,BidirectionalIterator2,trivaial_assign()>::
+    return __copy_backward_dispatch<BidirectionalIterator1,BidirectionalIterator2,trivaial_assign>::
         copy(first,last,result);
 }
 
+template<class SegmentedIterator, class BidirectionalIterator, class OutSegmented>
+BidirectionalIterator
+__copy_backward_segment(SegmentedIterator first,SegmentedIterator last,
+    BidirectionalIterator result,__true_type,OutSegmented){
+    typedef __segmented_iterator_traits<SegmentedIterator> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    if(sfirst == slast)
+        return mjstl::copy_backward(traits::local(first),traits::local(last),result);
+    result = mjstl::copy_backward(traits::begin(slast),traits::local(last),result);
+    for(--slast; slast != sfirst; --slast)
+        result = mjstl::copy_backward(traits::begin(slast),traits::end(slast),result);
+    return mjstl::copy_backward(traits::local(first),traits::end(sfirst),result);
+}
+
+template<class BidirectionalIterator, class SegmentedIterator>
+inline SegmentedIterator
+__copy_backward_to_segment(BidirectionalIterator first,BidirectionalIterator last,
+    SegmentedIterator result,bidirectional_iterator_tag){
+    return __copy_backward_segment(first,last,result,__false_type(),__false_type());
+}
+
+template<class RandomAccessIterator, class SegmentedIterator>
+SegmentedIterator
+__copy_backward_to_segment(RandomAccessIterator first,RandomAccessIterator last,
+    SegmentedIterator result,random_access_iterator_tag){
+    typedef __segmented_iterator_traits<SegmentedIterator> traits;
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    typename traits::segment_iterator seg = traits::segment(result);
+    typename traits::local_iterator l = traits::local(result);
+    Distance n = last - first;
+    while(true){
+        Distance room = static_cast<Distance>(l - traits::begin(seg));
+        Distance len = n < room ? n : room;
+        mjstl::copy_backward(last - len,last,l);
+        last -= len;
+        n -= len;
+        if(n == 0) return traits::compose(seg,l - len);
+        --seg;
+        l = traits::end(seg);
+    }
+}
+
+template<class BidirectionalIterator, class SegmentedIterator>
+inline SegmentedIterator
+__copy_backward_segment(BidirectionalIterator first,BidirectionalIterator last,
+    SegmentedIterator result,__false_type,__true_type){
+    return __copy_backward_to_segment(first,last,result,iterator_category(first));
+}
+
+template<class BidirectionalIterator1, class BidirectionalIterator2>
+inline BidirectionalIterator2
+copy_backward(BidirectionalIterator1 first,BidirectionalIterator1 last,
+    BidirectionalIterator2 result){
+    typedef typename __segmented_iterator_traits<BidirectionalIterator1>::is_segmented_iterator seg1;
+    typedef typename __segmented_iterator_traits<BidirectionalIterator2>::is_segmented_iterator seg2;
+    return __copy_backward_segment(first,last,result,seg1(),seg2());
+}
+
+/*位迭代器版本：从尾部开始按字搬运，目的区间在源区间之后重叠时也正确。*/
+inline __bit_iterator copy_backward(__bit_const_iterator first,__bit_const_iterator last,
+    __bit_iterator result){
+    ptrdiff_t n = last - first;
+    __bit_iterator dfirst = result - n;
+    while(n > 0){
+        unsigned k = (unsigned)__bit_min(n,ptrdiff_t(__WORD_BIT));
+        n -= k;
+        __bit_const_iterator s = first + n;
+        __bit_iterator d = dfirst + n;
+        __bit_store(d.p,d.offset,k,__bit_load(s.p,s.offset,k));
+    }
+    return dfirst;
+}
+
+inline __bit_iterator copy_backward(__bit_iterator first,__bit_iterator last,__bit_iterator result){
+    return copy_backward(__bit_const_iterator(first),__bit_const_iterator(last),result);
+}
+
 /************************************************equal*************************************************/
 
 
 /*比较第一序列[first,last) 是否和第二序列相等*/
 template<class InputIterator1,class InputIterator2>
 inline bool 
-equal(InputIterator1 first1,InputIterator1 last1,
+__equal_aux(InputIterator1 first1,InputIterator1 last1,
     InputIterator2 first2,InputIterator2 last2){
     for(;(first1 != last1) && (first2 != last2) ; ++first1,++first2)
-        if(!first2 || *first1 != *first2) return false;
+        if(*first1 != *first2) return false;
+    return true;
+}
+
+/*
+*   分段迭代器版本：两个序列都可随机访问时，按分段的那一方逐段比较，
+* 每段是连续指针区间。其他情况退回逐个元素比较。
+*/
+template<class InputIterator1,class InputIterator2,class Category1,class Category2>
+inline bool 
+__equal_segment(InputIterator1 first1,InputIterator1 last1,
+    InputIterator2 first2,InputIterator2 last2,
+    __true_type,Category1,Category2){
+    return __equal_aux(first1,last1,first2,last2);
+}
+
+template<class SegmentedIterator,class RandomAccessIterator>
+bool __equal_segment(SegmentedIterator first1,SegmentedIterator last1,
+    RandomAccessIterator first2,RandomAccessIterator last2,
+    __true_type,random_access_iterator_tag,random_access_iterator_tag){
+    typedef __segmented_iterator_traits<SegmentedIterator> traits;
+    typedef typename traits::local_iterator local_iterator;
+    if(last2 - first2 < last1 - first1)
+        last1 = first1 + (last2 - first2);
+    typename traits::segment_iterator sfirst = traits::segment(first1);
+    typename traits::segment_iterator slast = traits::segment(last1);
+    local_iterator l = traits::local(first1);
+    for(; sfirst != slast; ++sfirst,l = traits::begin(sfirst)){
+        local_iterator e = traits::end(sfirst);
+        if(!mjstl::equal(l,e,first2,first2 + (e - l))) return false;
+        first2 += e - l;
+    }
+    local_iterator e = traits::local(last1);
+    return mjstl::equal(l,e,first2,first2 + (e - l));
+}
+
+template<class InputIterator1,class InputIterator2>
+inline bool 
+__equal_dispatch(InputIterator1 first1,InputIterator1 last1,
+    InputIterator2 first2,InputIterator2 last2,__false_type,__false_type){
+    return __equal_aux(first1,last1,first2,last2);
+}
+
+template<class InputIterator1,class InputIterator2,class Segmented2>
+inline bool 
+__equal_dispatch(InputIterator1 first1,InputIterator1 last1,
+    InputIterator2 first2,InputIterator2 last2,__true_type,Segmented2){
+    return __equal_segment(first1,last1,first2,last2,__true_type(),
+        iterator_category(first1),iterator_category(first2));
+}
+
+/*只有第二序列分段：交换两个序列，相等比较是对称的。*/
+template<class InputIterator1,class InputIterator2>
+inline bool 
+__equal_dispatch(InputIterator1 first1,InputIterator1 last1,
+    InputIterator2 first2,InputIterator2 last2,__false_type,__true_type){
+    return __equal_segment(first2,last2,first1,last1,__true_type(),
+        iterator_category(first2),iterator_category(first1));
+}
+
+template<class InputIterator1,class InputIterator2>
+inline bool 
+equal(InputIterator1 first1,InputIterator1 last1,
+    InputIterator2 first2,InputIterator2 last2){
+    typedef typename __segmented_iterator_traits<InputIterator1>::is_segmented_iterator seg1;
+    typedef typename __segmented_iterator_traits<InputIterator2>::is_segmented_iterator seg2;
+    return __equal_dispatch(first1,last1,first2,last2,seg1(),seg2());
+}
+
+/*位迭代器版本：每次比较一个字长的位段。*/
+inline bool equal(__bit_const_iterator first1,__bit_const_iterator last1,
+    __bit_const_iterator first2,__bit_const_iterator last2){
+    ptrdiff_t n = __bit_min(last1 - first1,last2 - first2);
+    while(n > 0){
+        unsigned k = (unsigned)__bit_min(n,ptrdiff_t(__WORD_BIT));
+        if(__bit_load(first1.p,first1.offset,k) != __bit_load(first2.p,first2.offset,k))
+            return false;
+        first1 += k;
+        first2 += k;
+        n -= k;
+    }
     return true;
 }
 
+inline bool equal(__bit_iterator first1,__bit_iterator last1,
+    __bit_iterator first2,__bit_iterator last2){
+    return equal(__bit_const_iterator(first1),__bit_const_iterator(last1),
+        __bit_const_iterator(first2),__bit_const_iterator(last2));
+}
+
 /*通过cmp仿函数来进行比较*/
 template<class InputIterator1,class InputIterator2,class Compared>
 inline bool 
 equal(InputIterator1 first1,InputIterator1 last1,
     InputIterator2 first2,InputIterator2 last2,Compared cmp){
     for(;(first1 != last1) && (first2 != last2); ++first1,++first2)
-        if(!first2 || !cmp(*first1,*first2)) return false;
+        if(!cmp(*first1,*first2)) return false;
     return true;
 }
 
@@ -224,11 +517,33 @@ mismatch(InputIterator1 first1,InputIterator1 last1,InputIterator2 first2,Compar
 
 /***********************************************fill***********************************************/
 template<class ForwardIterator,class T>
-void fill(ForwardIterator first,ForwardIterator last,const T& value){
+void __fill_segment(ForwardIterator first,ForwardIterator last,const T& value,__false_type){
     for(;first != last; ++first)
         *first = value;
 }
 
+/*分段迭代器版本：逐段填充，段内是连续指针区间，编译器可以向量化或转成memset。*/
+template<class SegmentedIterator,class T>
+void __fill_segment(SegmentedIterator first,SegmentedIterator last,const T& value,__true_type){
+    typedef __segmented_iterator_traits<SegmentedIterator> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    if(sfirst == slast){
+        mjstl::fill(traits::local(first),traits::local(last),value);
+        return;
+    }
+    mjstl::fill(traits::local(first),traits::end(sfirst),value);
+    for(++sfirst; sfirst != slast; ++sfirst)
+        mjstl::fill(traits::begin(sfirst),traits::end(sfirst),value);
+    mjstl::fill(traits::begin(slast),traits::local(last),value);
+}
+
+template<class ForwardIterator,class T>
+void fill(ForwardIterator first,ForwardIterator last,const T& value){
+    typedef typename __segmented_iterator_traits<ForwardIterator>::is_segmented_iterator seg;
+    __fill_segment(first,last,value,seg());
+}
+
 template<class ForwardIterator,class Size,class T>
 ForwardIterator fill_n(ForwardIterator first,Size n, const T& value){
     for(;n > 0; --n,++first)
@@ -251,6 +566,36 @@ void fill(char* first,char* last,const char& value){
     memset(first,static_cast<unsigned char>(tmp),(last-first));
 }
 
+/*位迭代器版本：首尾不完整的字用掩码处理，中间整字直接memset。*/
+inline void fill(__bit_iterator first,__bit_iterator last,const bool& value){
+    ptrdiff_t n = last - first;
+    if(n <= 0) return;
+    __bit_word* p = first.p;
+    if(first.offset != 0){
+        unsigned k = (unsigned)__bit_min(n,ptrdiff_t(__WORD_BIT - first.offset));
+        const __bit_word mask = __bit_mask(first.offset,k);
+        if(value) *p |= mask;
+        else      *p &= ~mask;
+        n -= k;
+        ++p;
+    }
+    const ptrdiff_t words = n / __WORD_BIT;
+    if(words > 0)
+        memset(p,value ? 0xFF : 0,size_t(words) * sizeof(__bit_word));
+    n -= words * __WORD_BIT;
+    if(n > 0){
+        const __bit_word mask = __bit_mask(0,(unsigned)n);
+        if(value) p[words] |= mask;
+        else      p[words] &= ~mask;
+    }
+}
+
+template<class Size>
+inline __bit_iterator fill_n(__bit_iterator first,Size n,const bool& value){
+    fill(first,first + ptrdiff_t(n),value);
+    return first + ptrdiff_t(n);
+}
+
 template<class Size>
 unsigned char* fill_n(unsigned char* first,Size n,unsigned char& value){
     fill(first,first+n,value);
@@ -288,12 +633,6 @@ unchecked_move_cat(InputIterator first,InputIterator last,
     return result;
 }
 
-template<class InputIterator,class OutputIterator>
-OutputIterator 
-unchecked_move(InputIterator first,InputIterator last,OutputIterator result){
-    return unchecked_move_cat(first,last,result,iterator_category(first));
-}
-
 template<class Tp,class Up>
 typename std::enable_if<
   std::is_same<typename std::remove_const<Tp>::type,Up>::value &&
@@ -302,10 +641,64 @@ typename std::enable_if<
 unchecked_move(Tp* first,Tp* last,Up* result){
     const size_t n = static_cast<size_t>(last - first);
     if(n != 0)
-        std::memmove(result,first,n);
+        std::memmove(result,first,n * sizeof(Up));
     return result + n;
 }
 
+template<class InputIterator,class OutputIterator>
+OutputIterator 
+unchecked_move(InputIterator first,InputIterator last,OutputIterator result);
+
+template<class InputIterator,class OutputIterator>
+OutputIterator 
+__unchecked_move_segment(InputIterator first,InputIterator last,
+    OutputIterator result,__false_type){
+    return unchecked_move_cat(first,last,result,iterator_category(first));
+}
+
+/*分段迭代器版本：逐段move，段内是指针区间，平凡类型直接memmove。*/
+template<class SegmentedIterator,class OutputIterator>
+OutputIterator 
+__unchecked_move_segment(SegmentedIterator first,SegmentedIterator last,
+    OutputIterator result,__true_type){
+    typedef __segmented_iterator_traits<SegmentedIterator> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    if(sfirst == slast)
+        return mjstl::unchecked_move(traits::local(first),traits::local(last),result);
+    result = mjstl::unchecked_move(traits::local(first),traits::end(sfirst),result);
+    for(++sfirst; sfirst != slast; ++sfirst)
+        result = mjstl::unchecked_move(traits::begin(sfirst),traits::end(sfirst),result);
+    return mjstl::unchecked_move(traits::begin(slast),traits::local(last),result);
+}
+
+template<class InputIterator,class OutputIterator>
+OutputIterator 
+unchecked_move(InputIterator first,InputIterator last,OutputIterator result){
+    typedef typename __segmented_iterator_traits<InputIterator>::is_segmented_iterator seg;
+    return __unchecked_move_segment(first,last,result,seg());
+}
+
+/*******************************************__remove_if_move*******************************************/
+/*
+*   与remove_if相同，但保留下来的元素用move而不是赋值拷贝挪到前面，
+* 返回新的结尾，[返回值,last)是已被move过的元素，由容器统一析构。
+*/
+template<class ForwardIterator,class Predicate>
+ForwardIterator __remove_if_move(ForwardIterator first,ForwardIterator last,Predicate pred){
+    while(first != last && !pred(*first))
+        ++first;
+    if(first == last)
+        return first;
+    ForwardIterator result = first;
+    for(++first; first != last; ++first){
+        if(!pred(*first)){
+            *result = mjstl::move(*first);
+            ++result;
+        }
+    }
+    return result;
+}
 
 /***********************************************iter_swap***********************************************/
 /*交换两个ForwardIterator 所指对象*/
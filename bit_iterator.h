@@ -0,0 +1,270 @@
+#ifndef __BIT_ITERATOR_H__
+#define __BIT_ITERATOR_H__
+
+#ifndef USE_CSTDDEF
+#define USE_CSTDDEF
+#include <cstddef>
+#endif // !USE_CSTDDEF
+
+#include <climits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "iterator.h"
+
+namespace mjstl
+{
+    /*
+    *   vector<bool>使用的位迭代器。
+    *   元素按位压缩存放在__bit_word数组里，一个字存__WORD_BIT个元素，
+    * 迭代器由(字指针p，字内偏移offset)表示一个位的位置。
+    */
+    typedef unsigned long long __bit_word;
+    enum { __WORD_BIT = int(CHAR_BIT * sizeof(__bit_word)) };
+
+    /*统计x中1的个数。*/
+    inline int __bit_popcount(__bit_word x){
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(x));
+#else
+        return __builtin_popcountll(x);
+#endif
+    }
+
+    /*x最低位1的下标，调用者保证x != 0。*/
+    inline int __bit_ctz(__bit_word x){
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index,x);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(x);
+#endif
+    }
+
+    inline ptrdiff_t __bit_min(ptrdiff_t a,ptrdiff_t b){ return a < b ? a : b;}
+
+    /*从offset开始n位为1的掩码，要求 0 < n && offset + n <= __WORD_BIT。*/
+    inline __bit_word __bit_mask(unsigned offset,unsigned n){
+        return (n == unsigned(__WORD_BIT) ? ~__bit_word(0) : ((__bit_word(1) << n) - 1)) << offset;
+    }
+
+    /*
+    *   从p[0]的offset位开始取n位(1 <= n <= __WORD_BIT)，放到返回值低n位。
+    * 跨字时才会读p[1]。
+    */
+    inline __bit_word __bit_load(const __bit_word* p,unsigned offset,unsigned n){
+        __bit_word bits = p[0] >> offset;
+        if(offset + n > unsigned(__WORD_BIT))
+            bits |= p[1] << (__WORD_BIT - offset);
+        return bits & __bit_mask(0,n);
+    }
+
+    /*把bits的低n位写到p[0]的offset位开始处，跨字时才会写p[1]。*/
+    inline void __bit_store(__bit_word* p,unsigned offset,unsigned n,__bit_word bits){
+        const __bit_word mask = __bit_mask(0,n);
+        bits &= mask;
+        p[0] = (p[0] & ~(mask << offset)) | (bits << offset);
+        if(offset + n > unsigned(__WORD_BIT)){
+            const unsigned shift = __WORD_BIT - offset;
+            p[1] = (p[1] & ~(mask >> shift)) | (bits >> shift);
+        }
+    }
+
+    /*位引用：代理对象，*it返回它而不是bool&。*/
+    struct __bit_reference{
+        __bit_word* p;
+        __bit_word mask;
+
+        __bit_reference():p(0),mask(0){}
+        __bit_reference(__bit_word* x,__bit_word y):p(x),mask(y){}
+
+        operator bool() const { return !(!(*p & mask));}
+        __bit_reference& operator=(bool x){
+            if(x) *p |= mask;
+            else  *p &= ~mask;
+            return *this;
+        }
+        /*赋的是值，而不是让引用重新绑定。*/
+        __bit_reference& operator=(const __bit_reference& x){
+            return *this = bool(x);
+        }
+        bool operator==(const __bit_reference& x) const{
+            return bool(*this) == bool(x);
+        }
+        bool operator<(const __bit_reference& x) const{
+            return !bool(*this) && bool(x);
+        }
+        void flip(){ *p ^= mask;}
+    };
+
+    inline void swap(__bit_reference x,__bit_reference y){
+        bool tmp = x;
+        x = y;
+        y = tmp;
+    }
+
+    struct __bit_iterator_base : public iterator<random_access_iterator_tag,bool>{
+        typedef random_access_iterator_tag  iterator_category;
+        typedef bool                        value_type;
+        typedef ptrdiff_t                   difference_type;
+
+        __bit_word* p;
+        unsigned offset;
+
+        __bit_iterator_base(__bit_word* x,unsigned y):p(x),offset(y){}
+
+        void bump_up(){
+            if(offset++ == unsigned(__WORD_BIT) - 1){
+                offset = 0;
+                ++p;
+            }
+        }
+
+        void bump_down(){
+            if(offset-- == 0){
+                offset = __WORD_BIT - 1;
+                --p;
+            }
+        }
+
+        /*__WORD_BIT是2的幂，这里的除法、取模会被编译成移位和与运算。*/
+        void incr(difference_type n){
+            difference_type k = n + offset;
+            p += k / __WORD_BIT;
+            k = k % __WORD_BIT;
+            if(k < 0){
+                k += __WORD_BIT;
+                --p;
+            }
+            offset = static_cast<unsigned>(k);
+        }
+
+        bool operator==(const __bit_iterator_base& x) const{
+            return p == x.p && offset == x.offset;
+        }
+        bool operator!=(const __bit_iterator_base& x) const{
+            return !(*this == x);
+        }
+        bool operator<(const __bit_iterator_base& x) const{
+            return p < x.p || (p == x.p && offset < x.offset);
+        }
+        bool operator>(const __bit_iterator_base& x) const{
+            return x < *this;
+        }
+        bool operator<=(const __bit_iterator_base& x) const{
+            return !(x < *this);
+        }
+        bool operator>=(const __bit_iterator_base& x) const{
+            return !(*this < x);
+        }
+    };
+
+    inline ptrdiff_t operator-(const __bit_iterator_base& x,const __bit_iterator_base& y){
+        return __WORD_BIT * (x.p - y.p) + x.offset - y.offset;
+    }
+
+    struct __bit_iterator : public __bit_iterator_base{
+        typedef __bit_reference     reference;
+        typedef __bit_reference*    pointer;
+        typedef __bit_iterator      iterator;
+        typedef __bit_iterator      self;
+
+        __bit_iterator():__bit_iterator_base(0,0){}
+        __bit_iterator(__bit_word* x,unsigned y):__bit_iterator_base(x,y){}
+
+        reference operator*() const { return reference(p,__bit_word(1) << offset);}
+        self& operator++(){
+            bump_up();
+            return *this;
+        }
+        self operator++(int){
+            self tmp = *this;
+            bump_up();
+            return tmp;
+        }
+        self& operator--(){
+            bump_down();
+            return *this;
+        }
+        self operator--(int){
+            self tmp = *this;
+            bump_down();
+            return tmp;
+        }
+        self& operator+=(difference_type n){
+            incr(n);
+            return *this;
+        }
+        self& operator-=(difference_type n){
+            return *this += -n;
+        }
+        self operator+(difference_type n) const{
+            self tmp = *this;
+            return tmp += n;
+        }
+        self operator-(difference_type n) const{
+            self tmp = *this;
+            return tmp -= n;
+        }
+        reference operator[](difference_type n) const{ return *(*this + n);}
+    };
+
+    inline __bit_iterator operator+(ptrdiff_t n,const __bit_iterator& x){ return x + n;}
+
+    struct __bit_const_iterator : public __bit_iterator_base{
+        typedef bool                    reference;
+        typedef bool                    const_reference;
+        typedef const bool*             pointer;
+        typedef __bit_const_iterator    const_iterator;
+        typedef __bit_const_iterator    self;
+
+        __bit_const_iterator():__bit_iterator_base(0,0){}
+        __bit_const_iterator(__bit_word* x,unsigned y):__bit_iterator_base(x,y){}
+        __bit_const_iterator(const __bit_iterator& x):__bit_iterator_base(x.p,x.offset){}
+
+        const_reference operator*() const {
+            return __bit_reference(p,__bit_word(1) << offset);
+        }
+        self& operator++(){
+            bump_up();
+            return *this;
+        }
+        self operator++(int){
+            self tmp = *this;
+            bump_up();
+            return tmp;
+        }
+        self& operator--(){
+            bump_down();
+            return *this;
+        }
+        self operator--(int){
+            self tmp = *this;
+            bump_down();
+            return tmp;
+        }
+        self& operator+=(difference_type n){
+            incr(n);
+            return *this;
+        }
+        self& operator-=(difference_type n){
+            return *this += -n;
+        }
+        self operator+(difference_type n) const{
+            self tmp = *this;
+            return tmp += n;
+        }
+        self operator-(difference_type n) const{
+            self tmp = *this;
+            return tmp -= n;
+        }
+        const_reference operator[](difference_type n) const{ return *(*this + n);}
+    };
+
+    inline __bit_const_iterator operator+(ptrdiff_t n,const __bit_const_iterator& x){ return x + n;}
+
+} // namespace mjstl
+#endif // !__BIT_ITERATOR_H__
@@ -0,0 +1,411 @@
+#ifndef __BVECTOR_H__
+#define __BVECTOR_H__
+
+#include <cassert>
+#include <initializer_list>
+
+#include "bit_iterator.h"
+#include "reverse_iterator.h"
+#include "memory.h"
+
+namespace mjstl{
+
+template <typename T,typename Alloc>
+class vector;
+
+/*
+*   vector<bool>特化版本：按位压缩存放，一个__bit_word存__WORD_BIT个元素。
+*   元素不可取地址，operator[]、*it返回的是代理对象__bit_reference。
+*   count、find、fill、copy、equal对位迭代器有按字处理的重载，见algo.h、algobase.h。
+*/
+template <class Alloc>
+class vector<bool,Alloc>{
+public:
+    typedef bool                                value_type;
+    typedef Alloc                               allocate_type;
+    typedef size_t                              size_type;
+    typedef ptrdiff_t                           difference_type;
+    typedef __bit_reference                     reference;
+    typedef bool                                const_reference;
+    typedef __bit_reference*                    pointer;
+    typedef const bool*                         const_pointer;
+
+    /*iterator_type*/
+    typedef __bit_iterator                      iterator;
+    typedef __bit_const_iterator                const_iterator;
+    typedef mjstl::reverse_iterator<const_iterator>    const_reverse_iterator;
+    typedef mjstl::reverse_iterator<iterator>          reverse_iterator;
+protected:
+    typedef mjstl::allocator<__bit_word>        data_allocator;
+
+protected:
+    iterator start;
+    iterator finish;
+    __bit_word* end_of_storage;
+
+public:
+    /*construct,assignment,destruct*/
+    vector():start(),finish(),end_of_storage(nullptr){}
+    explicit vector(size_type n){ __initialize(n); fill(start,finish,false);}
+    vector(size_type n,bool value){ __initialize(n); fill(start,finish,value);}
+    template<class InputIterator,typename std::enable_if<
+        mjstl::is_input_iterator<InputIterator>::value,int>::type = 0>
+    vector(InputIterator first,InputIterator last);
+    vector(std::initializer_list<bool> ilist);
+
+    /*copy construct*/
+    vector(const vector& x);
+    vector(vector&& x);
+
+    /*assignment operator*/
+    vector& operator=(std::initializer_list<bool> ilist);
+    vector& operator=(const vector& x);
+    vector& operator=(vector&& x);
+
+    /*destrust*/
+    ~vector(){ __deallocate(); }
+public:
+    /*about iterator*/
+    iterator begin() { return start; }
+    const_iterator begin() const { return start; }
+    iterator end() { return finish; }
+    const_iterator end() const{ return finish; }
+    reverse_iterator rbegin() { return reverse_iterator(end());}
+    const_reverse_iterator rbegin() const{ return const_reverse_iterator(end());}
+    reverse_iterator rend() { return reverse_iterator(begin());}
+    const_reverse_iterator rend() const{ return const_reverse_iterator(begin());}
+
+    /*about containter*/
+    size_type size() const{ return size_type(end() - begin());}
+    size_type max_size() const{ return size_type(-1);}
+    size_type capacity() const{
+        return size_type(const_iterator(end_of_storage,0) - begin());
+    }
+
+    /*access container*/
+    reference operator[](size_type n){ return *(begin() + difference_type(n));}
+    const_reference operator[](size_type n) const{ return *(begin() + difference_type(n));}
+    reference at(size_type n){
+        assert(n < size());
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const{
+        assert(n < size());
+        return (*this)[n];
+    }
+    reference front(){ return *begin();}
+    const_reference front() const{ return *begin();}
+    reference back(){ return *(end() - 1);}
+    const_reference back() const{ return *(end() - 1);}
+
+    /*modify container*/
+    void assign(size_type n,bool value) { __fill_assign(n,value);}
+    template<class InputIterator,typename std::enable_if<
+        mjstl::is_input_iterator<InputIterator>::value,int>::type = 0>
+    void assign(InputIterator first,InputIterator last);
+    void reserve(size_type n);
+    void push_back(bool value);
+    template<class ...Args>
+    void emplace_back(Args&& ...args){ push_back(bool(mjstl::forward<Args>(args)...));}
+
+    void pop_back(){ if(finish != start) --finish;}
+    iterator erase(iterator position);
+    iterator erase(iterator first,iterator last);
+    void clear(){ finish = start;}
+    iterator insert(iterator position,bool x);
+    iterator insert(iterator position){ return insert(position,false);}
+    void insert(iterator position,size_type n,bool value);
+    template<class InputIterator,typename std::enable_if<
+        mjstl::is_input_iterator<InputIterator>::value,int>::type = 0>
+    void insert(iterator position,InputIterator first,InputIterator last);
+    void swap(vector<bool,Alloc>& rhs);
+    bool empty() const{ return begin() == end();}
+    void resize(size_type new_size,bool value = false);
+    /*整字取反，尾部多余的位不影响结果。*/
+    void flip();
+
+    /*about allocator*/
+    allocate_type get_allocator(){ return allocate_type();}
+
+protected:
+    static size_type __words(size_type n){
+        return (n + __WORD_BIT - 1) / __WORD_BIT;
+    }
+    void __initialize(size_type n);
+    void __deallocate();
+    void __insert_aux(iterator position,bool x);
+    void __fill_assign(size_type n,bool value);
+
+    template<class InputIterator>
+    void __range_insert(iterator position,InputIterator first,InputIterator last,
+        input_iterator_tag);
+    template<class ForwardIterator>
+    void __range_insert(iterator position,ForwardIterator first,ForwardIterator last,
+        forward_iterator_tag);
+};
+
+template<class Alloc>
+template<class InputIterator,typename std::enable_if<
+    mjstl::is_input_iterator<InputIterator>::value,int>::type>
+vector<bool,Alloc>::vector(InputIterator first,InputIterator last)
+  :start(),finish(),end_of_storage(nullptr){
+    __range_insert(end(),first,last,iterator_category(first));
+}
+
+template<class Alloc>
+vector<bool,Alloc>::vector(std::initializer_list<bool> ilist)
+  :start(),finish(),end_of_storage(nullptr){
+    __range_insert(end(),ilist.begin(),ilist.end(),forward_iterator_tag());
+}
+
+template<class Alloc>
+vector<bool,Alloc>::vector(const vector<bool,Alloc>& x){
+    __initialize(x.size());
+    mjstl::copy(x.begin(),x.end(),start);
+}
+
+template<class Alloc>
+vector<bool,Alloc>::vector(vector<bool,Alloc>&& x)
+  :start(x.start),finish(x.finish),end_of_storage(x.end_of_storage){
+    x.start = x.finish = iterator();
+    x.end_of_storage = nullptr;
+}
+
+template<class Alloc>
+vector<bool,Alloc>& vector<bool,Alloc>::operator=(std::initializer_list<bool> ilist){
+    vector<bool,Alloc> tmp(ilist);
+    swap(tmp);
+    return *this;
+}
+
+template<class Alloc>
+vector<bool,Alloc>& vector<bool,Alloc>::operator=(const vector<bool,Alloc>& x){
+    if(this != &x){
+        if(x.size() > capacity()){
+            __deallocate();
+            __initialize(x.size());
+        }
+        mjstl::copy(x.begin(),x.end(),start);
+        finish = start + difference_type(x.size());
+    }
+    return *this;
+}
+
+template<class Alloc>
+vector<bool,Alloc>& vector<bool,Alloc>::operator=(vector<bool,Alloc>&& x){
+    if(this != &x){
+        __deallocate();
+        start = x.start;
+        finish = x.finish;
+        end_of_storage = x.end_of_storage;
+        x.start = x.finish = iterator();
+        x.end_of_storage = nullptr;
+    }
+    return *this;
+}
+
+template<class Alloc>
+template<class InputIterator,typename std::enable_if<
+    mjstl::is_input_iterator<InputIterator>::value,int>::type>
+void vector<bool,Alloc>::assign(InputIterator first,InputIterator last){
+    clear();
+    __range_insert(end(),first,last,iterator_category(first));
+}
+
+template<class Alloc>
+void vector<bool,Alloc>::reserve(size_type n){
+    if(n <= capacity()) return;
+    const size_type len = size();
+    __bit_word* q = data_allocator::allocate(__words(n));
+    mjstl::copy(begin(),end(),iterator(q,0));
+    __deallocate();
+    start = iterator(q,0);
+    finish = start + difference_type(len);
+    end_of_storage = q + __words(n);
+}
+
+template<class Alloc>
+void vector<bool,Alloc>::push_back(bool x){
+    /*finish的偏移非0，或者还有整字没用，都说明有剩余空间。*/
+    if(finish.p != end_of_storage)
+        *finish++ = x;
+    else
+        __insert_aux(end(),x);
+}
+
+template<class Alloc>
+typename vector<bool,Alloc>::iterator
+vector<bool,Alloc>::erase(iterator position){
+    if(position + 1 != end())
+        mjstl::copy(position + 1,end(),position);
+    --finish;
+    return position;
+}
+
+template<class Alloc>
+typename vector<bool,Alloc>::iterator
+vector<bool,Alloc>::erase(iterator first,iterator last){
+    finish = mjstl::copy(last,end(),first);
+    return first;
+}
+
+template<class Alloc>
+typename vector<bool,Alloc>::iterator
+vector<bool,Alloc>::insert(iterator position,bool x){
+    const difference_type n = position - begin();
+    if(finish.p != end_of_storage && position == end())
+        *finish++ = x;
+    else
+        __insert_aux(position,x);
+    return begin() + n;
+}
+
+template<class Alloc>
+void vector<bool,Alloc>::insert(iterator position,size_type n,bool x){
+    if(n == 0) return;
+    if(capacity() - size() >= n){
+        mjstl::copy_backward(position,end(),finish + difference_type(n));
+        mjstl::fill(position,position + difference_type(n),x);
+        finish += difference_type(n);
+    }else{
+        const size_type len = size() + mjstl::max(size(),n);
+        __bit_word* q = data_allocator::allocate(__words(len));
+        iterator i = mjstl::copy(begin(),position,iterator(q,0));
+        mjstl::fill(i,i + difference_type(n),x);
+        iterator new_finish = mjstl::copy(position,end(),i + difference_type(n));
+        __deallocate();
+        start = iterator(q,0);
+        finish = new_finish;
+        end_of_storage = q + __words(len);
+    }
+}
+
+template<class Alloc>
+template<class InputIterator,typename std::enable_if<
+    mjstl::is_input_iterator<InputIterator>::value,int>::type>
+void vector<bool,Alloc>::insert(iterator position,InputIterator first,InputIterator last){
+    __range_insert(position,first,last,iterator_category(first));
+}
+
+template<class Alloc>
+void vector<bool,Alloc>::swap(vector<bool,Alloc>& rhs){
+    mjstl::swap(start,rhs.start);
+    mjstl::swap(finish,rhs.finish);
+    mjstl::swap(end_of_storage,rhs.end_of_storage);
+}
+
+template<class Alloc>
+inline void swap(vector<bool,Alloc>& x,vector<bool,Alloc>& y){
+    x.swap(y);
+}
+
+template<class Alloc>
+void vector<bool,Alloc>::resize(size_type new_size,bool x){
+    if(new_size < size())
+        erase(begin() + difference_type(new_size),end());
+    else
+        insert(end(),new_size - size(),x);
+}
+
+template<class Alloc>
+void vector<bool,Alloc>::flip(){
+    for(__bit_word* p = start.p; p != end_of_storage; ++p)
+        *p = ~*p;
+}
+
+template<class Alloc>
+void vector<bool,Alloc>::__initialize(size_type n){
+    __bit_word* q = data_allocator::allocate(__words(n));
+    start = iterator(q,0);
+    finish = start + difference_type(n);
+    end_of_storage = q + __words(n);
+}
+
+template<class Alloc>
+void vector<bool,Alloc>::__deallocate(){
+    if(start.p)
+        data_allocator::deallocate(start.p,end_of_storage - start.p);
+}
+
+template<class Alloc>
+void vector<bool,Alloc>::__insert_aux(iterator position,bool x){
+    if(finish.p != end_of_storage){
+        mjstl::copy_backward(position,finish,finish + 1);
+        *position = x;
+        ++finish;
+    }else{
+        /*按字扩容，至少一个字。*/
+        const size_type len = size() ? 2 * size() : size_type(__WORD_BIT);
+        __bit_word* q = data_allocator::allocate(__words(len));
+        iterator i = mjstl::copy(begin(),position,iterator(q,0));
+        *i++ = x;
+        finish = mjstl::copy(position,end(),i);
+        __deallocate();
+        start = iterator(q,0);
+        end_of_storage = q + __words(len);
+    }
+}
+
+template<class Alloc>
+void vector<bool,Alloc>::__fill_assign(size_type n,bool value){
+    if(n > capacity()){
+        vector<bool,Alloc> tmp(n,value);
+        tmp.swap(*this);
+    }else{
+        finish = start + difference_type(n);
+        mjstl::fill(start,finish,value);
+    }
+}
+
+template<class Alloc>
+template<class InputIterator>
+void vector<bool,Alloc>::__range_insert(iterator position,InputIterator first,
+    InputIterator last,input_iterator_tag){
+    for(;first != last; ++first){
+        position = insert(position,bool(*first));
+        ++position;
+    }
+}
+
+template<class Alloc>
+template<class ForwardIterator>
+void vector<bool,Alloc>::__range_insert(iterator position,ForwardIterator first,
+    ForwardIterator last,forward_iterator_tag){
+    if(first == last) return;
+    const size_type n = size_type(mjstl::distance(first,last));
+    if(capacity() - size() >= n){
+        mjstl::copy_backward(position,end(),finish + difference_type(n));
+        for(; first != last; ++first,++position)
+            *position = bool(*first);
+        finish += difference_type(n);
+    }else{
+        const size_type len = size() + mjstl::max(size(),n);
+        __bit_word* q = data_allocator::allocate(__words(len));
+        iterator i = mjstl::copy(begin(),position,iterator(q,0));
+        for(; first != last; ++first,++i)
+            *i = bool(*first);
+        iterator new_finish = mjstl::copy(position,end(),i);
+        __deallocate();
+        start = iterator(q,0);
+        finish = new_finish;
+        end_of_storage = q + __words(len);
+    }
+}
+
+template<class Alloc>
+inline bool operator==(const vector<bool,Alloc>& x,const vector<bool,Alloc>& y){
+    return x.size() == y.size() && mjstl::equal(x.begin(),x.end(),y.begin(),y.end());
+}
+
+template<class Alloc>
+inline bool operator!=(const vector<bool,Alloc>& x,const vector<bool,Alloc>& y){
+    return !(x == y);
+}
+
+template<class Alloc>
+inline bool operator<(const vector<bool,Alloc>& x,const vector<bool,Alloc>& y){
+    return mjstl::lexicographical_compare(x.begin(),x.end(),y.begin(),y.end());
+}
+
+}// namespace mjstl
+#endif // !__BVECTOR_H__
@@ -0,0 +1,208 @@
+#ifndef __CONCURRENT_STACK_H__
+#define __CONCURRENT_STACK_H__
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+#include "memory.h"
+#include "sync_util.h"
+
+namespace mjstl
+{
+    /*
+    *   concurrent_stack：Treiber无锁栈。
+    *   栈顶是一个"带标签的指针"(tagged pointer)：64位字里放节点地址和一个计数，
+    * 每次pop成功计数加1。线程A读到栈顶X后被挂起，其他线程弹出X又压回X时，
+    * 地址虽然相同，计数已经变了，A的CAS会失败，这样避免了ABA问题。
+    *   64位平台用户态地址只用低48位，高16位放计数；32位平台地址、计数各占32位。
+    * 开启5级页表(LA57)的x86-64、52位地址的AArch64可能给出超过48位的地址，
+    * pack在debug下用assert检查，release下计数会覆盖地址的高位。
+    *   计数只有16位，每65536次pop回绕一次：被挂起的线程恰好错过65536的整数倍次pop、
+    * 又碰上同一个地址时CAS仍会成功，所以这里的ABA保护是概率性的，不是绝对的。
+    *
+    *   节点按块(__STACK_CHUNK个)从simple_alloc申请，弹出后放回内部的空闲栈，栈析构时才释放。
+    * 所以pop读到一个刚被别的线程弹出的节点时，内存仍然有效，只是CAS会失败重来。
+    *   一个块远大于128字节，由default_alloc_template转给malloc，多线程分配是安全的。
+    *
+    *   pop_all用一次CAS摘下整条链，元素按后进先出的顺序move到out，节点整体还给空闲栈。
+    */
+    enum { __STACK_CHUNK = 64 };
+
+    struct __tagged_ptr{
+        typedef std::uint64_t word;
+#if UINTPTR_MAX > 0xffffffffu
+        enum { ptr_bits = 48 };
+#else
+        enum { ptr_bits = 32 };
+#endif
+        static word pack(void* p,word tag){
+            assert(((word)(std::uintptr_t)p >> ptr_bits) == 0);
+            return (word)(std::uintptr_t)p | (tag << ptr_bits);
+        }
+        template<class Node>
+        static Node* ptr(word w){
+            return reinterpret_cast<Node*>((std::uintptr_t)(w & ((word(1) << ptr_bits) - 1)));
+        }
+        static word tag(word w){ return w >> ptr_bits;}
+    };
+
+    template<class T,class Alloc = alloc>
+    class concurrent_stack{
+    public:
+        typedef T                       value_type;
+        typedef Alloc                   allocate_type;
+        typedef value_type*             pointer;
+        typedef value_type&             reference;
+        typedef const value_type&       const_reference;
+        typedef size_t                  size_type;
+
+    protected:
+        typedef typename std::aligned_storage<sizeof(T),alignof(T)>::type slot_type;
+        typedef __tagged_ptr::word      word;
+
+        struct node{
+            std::atomic<node*> next;
+            slot_type slot;
+
+            pointer value(){ return reinterpret_cast<pointer>(&slot);}
+        };
+        struct chunk{
+            chunk* next;
+            node nodes[__STACK_CHUNK];
+        };
+        typedef simple_alloc<chunk,Alloc>   chunk_allocator;
+
+        alignas(__CACHE_LINE_SIZE) std::atomic<word> head_;
+        alignas(__CACHE_LINE_SIZE) std::atomic<word> free_;
+        alignas(__CACHE_LINE_SIZE) std::atomic<chunk*> chunks_;
+
+    public:
+        concurrent_stack():head_(0),free_(0),chunks_(nullptr){}
+
+        concurrent_stack(const concurrent_stack&) = delete;
+        concurrent_stack& operator=(const concurrent_stack&) = delete;
+
+        ~concurrent_stack();
+
+    public:
+        /*并发修改时只是某一时刻的值。*/
+        bool empty() const {
+            return __tagged_ptr::ptr<node>(head_.load(std::memory_order_acquire)) == nullptr;
+        }
+        bool is_lock_free() const { return head_.is_lock_free();}
+
+        template<class ...Args>
+        void emplace(Args&& ...args);
+        void push(const T& x){ emplace(x);}
+        void push(T&& x){ emplace(mjstl::move(x));}
+
+        bool try_pop(T& out);
+        template<class OutputIterator>
+        OutputIterator pop_all(OutputIterator out);
+
+    protected:
+        static void __push_chain(std::atomic<word>& head,node* first,node* last);
+        static node* __pop_node(std::atomic<word>& head);
+        node* __get_node();
+    };
+
+template<class T,class Alloc>
+void concurrent_stack<T,Alloc>::__push_chain(std::atomic<word>& head,node* first,node* last){
+    word old = head.load(std::memory_order_relaxed);
+    word w;
+    do{
+        last->next.store(__tagged_ptr::ptr<node>(old),std::memory_order_relaxed);
+        w = __tagged_ptr::pack(first,__tagged_ptr::tag(old));
+    }while(!head.compare_exchange_weak(old,w,std::memory_order_release,std::memory_order_relaxed));
+}
+
+/*弹出时计数加1；p可能已被别的线程弹出并复用，读到的next不可靠，但那时CAS一定失败。*/
+template<class T,class Alloc>
+typename concurrent_stack<T,Alloc>::node*
+concurrent_stack<T,Alloc>::__pop_node(std::atomic<word>& head){
+    word old = head.load(std::memory_order_acquire);
+    for(;;){
+        node* p = __tagged_ptr::ptr<node>(old);
+        if(p == nullptr) return nullptr;
+        node* next = p->next.load(std::memory_order_relaxed);
+        word w = __tagged_ptr::pack(next,__tagged_ptr::tag(old) + 1);
+        if(head.compare_exchange_weak(old,w,std::memory_order_acquire,std::memory_order_acquire))
+            return p;
+    }
+}
+
+/*空闲栈为空时申请一块，第一个节点直接使用，其余节点一次压入空闲栈。*/
+template<class T,class Alloc>
+typename concurrent_stack<T,Alloc>::node*
+concurrent_stack<T,Alloc>::__get_node(){
+    node* p = __pop_node(free_);
+    if(p != nullptr) return p;
+    chunk* c = chunk_allocator().allocate();
+    for(int i = 0; i < __STACK_CHUNK; ++i)
+        ::new (&c->nodes[i].next) std::atomic<node*>(i + 1 < __STACK_CHUNK ? &c->nodes[i + 1] : nullptr);
+    c->next = chunks_.load(std::memory_order_relaxed);
+    while(!chunks_.compare_exchange_weak(c->next,c,std::memory_order_release,std::memory_order_relaxed));
+    __push_chain(free_,&c->nodes[1],&c->nodes[__STACK_CHUNK - 1]);
+    return &c->nodes[0];
+}
+
+template<class T,class Alloc>
+template<class ...Args>
+void concurrent_stack<T,Alloc>::emplace(Args&& ...args){
+    node* p = __get_node();
+    try{
+        mjstl::construct(p->value(),std::forward<Args>(args)...);
+    }catch(...){
+        __push_chain(free_,p,p);
+        throw;
+    }
+    __push_chain(head_,p,p);
+}
+
+template<class T,class Alloc>
+bool concurrent_stack<T,Alloc>::try_pop(T& out){
+    node* p = __pop_node(head_);
+    if(p == nullptr) return false;
+    out = mjstl::move(*p->value());
+    mjstl::destory(p->value());
+    __push_chain(free_,p,p);
+    return true;
+}
+
+template<class T,class Alloc>
+template<class OutputIterator>
+OutputIterator concurrent_stack<T,Alloc>::pop_all(OutputIterator out){
+    word old = head_.load(std::memory_order_acquire);
+    while(__tagged_ptr::ptr<node>(old) != nullptr &&
+        !head_.compare_exchange_weak(old,__tagged_ptr::pack(nullptr,__tagged_ptr::tag(old) + 1),
+            std::memory_order_acquire,std::memory_order_acquire));
+    node* first = __tagged_ptr::ptr<node>(old);
+    if(first == nullptr) return out;
+    node* last = first;
+    for(node* p = first; p != nullptr; p = p->next.load(std::memory_order_relaxed)){
+        *out = mjstl::move(*p->value());
+        ++out;
+        mjstl::destory(p->value());
+        last = p;
+    }
+    __push_chain(free_,first,last);
+    return out;
+}
+
+template<class T,class Alloc>
+concurrent_stack<T,Alloc>::~concurrent_stack(){
+    node* p = __tagged_ptr::ptr<node>(head_.load(std::memory_order_relaxed));
+    for(; p != nullptr; p = p->next.load(std::memory_order_relaxed))
+        mjstl::destory(p->value());
+    chunk* c = chunks_.load(std::memory_order_relaxed);
+    while(c != nullptr){
+        chunk* next = c->next;
+        chunk_allocator().deallocate(c);
+        c = next;
+    }
+}
+
+} // namespace mjstl
+#endif // !__CONCURRENT_STACK_H__
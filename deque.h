@@ -10,22 +10,54 @@
 
 namespace mjstl
 {
+#ifndef MJSTL_DEQUE_POW2_BUFFER
+#define MJSTL_DEQUE_POW2_BUFFER 1
+#endif
+
+/*每个deque最多缓存多少个空闲缓冲区，以及默认缓存上限。*/
+#ifndef MJSTL_DEQUE_SPARE_MAX
+#define MJSTL_DEQUE_SPARE_MAX 8
+#endif
+#ifndef MJSTL_DEQUE_SPARE_DEFAULT
+#define MJSTL_DEQUE_SPARE_DEFAULT 2
+#endif
+
+/*新建的deque是否默认开启map自动收缩。*/
+#ifndef MJSTL_DEQUE_AUTO_SHRINK
+#define MJSTL_DEQUE_AUTO_SHRINK 0
+#endif
+
+    /*编译期求log2(N)，向下取整。*/
+    template<size_t N>
+    struct __deque_log2{ enum{ value = 1 + __deque_log2<N/2>::value}; };
+    template<>
+    struct __deque_log2<1>{ enum{ value = 0}; };
+    template<>
+    struct __deque_log2<0>{ enum{ value = 0}; };
+
     /*
-    *   决定缓冲区大小：
-    *   @n: 多少个元素。
-    *   @sz：每个元素大小。
-    *   如果n为0时，并且每个元素大小小于512字节，则缓冲区大小不小于1个的元素空间，
-    *  如果每个元素大小大于等于512字节，缓冲区只给定1个元素空间。
+    *   编译期决定缓冲区大小，并给出迭代器运算用的shift、mask。
+    *   用户指定了BufSize时原样使用；否则在开启MJSTL_DEQUE_POW2_BUFFER时，
+    * 取不超过512/sz的最大2的幂，若翻倍后整块仍不超过768字节则取翻倍值，
+    * 这样块的字节数始终落在[256,768]附近，而块内下标、块偏移都只需要位运算。
     */
-    inline size_t __deque_buf_size(size_t n,size_t sz){
-        return n != 0 ? n : (sz < 512 ? size_t(512/sz) : size_t(1));
-    }
+    template<class T,size_t BufSize>
+    struct __deque_buf_traits{
+        enum{ raw = sizeof(T) < 512 ? 512 / sizeof(T) : 1};
+        enum{ down = size_t(1) << __deque_log2<raw>::value};
+        enum{ pow2 = 2 * down * sizeof(T) <= 768 ? 2 * down : down};
+        enum{ size = BufSize != 0 ? BufSize : (MJSTL_DEQUE_POW2_BUFFER ? size_t(pow2) : size_t(raw))};
+        enum{ is_pow2 = (size & (size - 1)) == 0};
+        enum{ shift = __deque_log2<size>::value};
+        enum{ mask = size - 1};
+    };
 
     template<class T,class Ref,class Ptr,size_t BufSize>
     struct __deque_iterator : public iterator<random_access_iterator_tag,T>{
         typedef __deque_iterator<T,T&,T*,BufSize>               iterator;
         typedef __deque_iterator<T,const T&,const T*,BufSize>   const_iterator;
-        static size_t buffer_size() { return __deque_buf_size(BufSize,sizeof(T));}
+        typedef __deque_buf_traits<T,BufSize>                   buf_traits;
+        static size_t buffer_size() { return size_t(buf_traits::size);}
 
         typedef T               value_type;
         typedef T*              pointer;
@@ -116,21 +148,38 @@ namespace mjstl
             return tmp;
         }
 
+        /*
+        *   相对某块first位置偏移offset个元素，落在第几个块上(向下取整)。
+        *   缓冲区大小是2的幂时直接算术右移，负数右移正好是向下取整。
+        */
+        static difference_type __node_offset(difference_type offset){
+            if(buf_traits::is_pow2)
+                return offset >> buf_traits::shift;
+            /*      offset为负的情况，说明从当前块first位置往前面的块偏移，
+            *   因此new_node一开始就应该是-1，而-offset是为了变成正数好计算
+            *   有多少个偏移块，-offset-1，是因为从当前块first开始偏移的，所以
+            *   应该多偏移-1。
+            */
+            return offset >= 0 ? 
+                difference_type(offset / difference_type(buffer_size())):
+                (-difference_type((-offset - 1) / difference_type(buffer_size())) - 1);
+        }
+
+        /*偏移offset后在所落块内的下标，new_node为__node_offset(offset)。*/
+        static difference_type __buf_index(difference_type offset,difference_type new_node){
+            if(buf_traits::is_pow2)
+                return offset & difference_type(buf_traits::mask);
+            return offset - new_node * difference_type(buffer_size());
+        }
+
         self& operator+=(difference_type n){
             difference_type offset = n + (cur - first);
             if(offset >= 0 && offset < difference_type(buffer_size())){
                 cur += n;
             }else{
-                /*      offset为负的情况，说明从当前块first位置往前面的块偏移，
-                *   因此new_node一开始就应该是-1，而-offset是为了变成正数好计算
-                *   有多少个偏移块，-offset-1，是因为从当前块first开始偏移的，所以
-                *   应该多偏移-1。
-                */
-                difference_type new_node = offset > 0 ? 
-                    difference_type(offset/buffer_size()):
-                    (-difference_type((-offset - 1) / buffer_size()) - 1);
+                difference_type new_node = __node_offset(offset);
                 set_node(node + new_node);
-                cur = first + (offset - difference_type(buffer_size() * new_node));
+                cur = first + __buf_index(offset,new_node);
             }
             return *this;
         }
@@ -178,6 +227,29 @@ namespace mjstl
         }
     };
 
+    /*deque迭代器的分段协议：每个缓冲区是一段，段迭代器就是map_pointer。*/
+    template<class T,class Ref,class Ptr,size_t BufSize>
+    struct __segmented_iterator_traits<__deque_iterator<T,Ref,Ptr,BufSize>>{
+        typedef __true_type                             is_segmented_iterator;
+        typedef __deque_iterator<T,Ref,Ptr,BufSize>     iterator;
+        typedef T**                                     segment_iterator;
+        typedef Ptr                                     local_iterator;
+
+        static segment_iterator segment(const iterator& it){ return it.node;}
+        static local_iterator local(const iterator& it){ return it.cur;}
+        static local_iterator begin(segment_iterator seg){ return *seg;}
+        static local_iterator end(segment_iterator seg){ return *seg + iterator::buffer_size();}
+
+        /*落在段尾时规范化到下一段段首，与deque迭代器cur永远不等于last保持一致。*/
+        static iterator compose(segment_iterator seg,local_iterator l){
+            if(l == end(seg)){
+                ++seg;
+                l = begin(seg);
+            }
+            return iterator(const_cast<T*>(l),seg);
+        }
+    };
+
 
     template<class T,class Alloc = alloc,size_t BufSize = 0>
     class deque{
@@ -206,7 +278,7 @@ namespace mjstl
         typedef mjstl::reverse_iterator<iterator>  reverse_iterator;
         typedef mjstl::reverse_iterator<const_iterator> const_reverse_iterator;
 
-        static size_t buffer_size(){ return __deque_buf_size(BufSize,sizeof(T));}
+        static size_t buffer_size(){ return size_t(__deque_buf_traits<T,BufSize>::size);}
 
     protected:
         typedef pointer* map_pointer;
@@ -215,6 +287,22 @@ namespace mjstl
         map_pointer map;/*指向一块map区域，map内都是指针，指向一个缓冲区。*/
         size_type map_size;/*map内的指针数量*/
         enum{ __initial_map_size = 8};
+        /*
+        *   空闲缓冲区缓存：pop释放的缓冲区先放进spare，下次需要新缓冲区时优先取用，
+        * 队列式的先进后出流量就不会反复调用分配器。缓存上限可由set_spare_limit调整，
+        * 但不超过__spare_max。
+        */
+        enum{ __spare_max = MJSTL_DEQUE_SPARE_MAX};
+        pointer spare[__spare_max > 0 ? __spare_max : 1];
+        size_type spare_count;
+        size_type spare_limit;
+        /*
+        *   自动收缩：释放缓冲区后，若在用节点数不足map_size的1/__shrink_ratio，
+        * 就把map缩小到在用节点数的两倍，收缩与扩张之间留有余量，不会来回抖动。
+        *   收缩会换掉map，所有迭代器随之失效，因此默认关闭。
+        */
+        enum{ __shrink_ratio = 4};
+        bool auto_shrink;
 
     public:
         /*constructor*/
@@ -258,8 +346,8 @@ namespace mjstl
         const_reference front() const { return *begin();}
         reference back() { return *(end() - 1);}
         const_reference back() const { return *(end() - 1);}
-        reference operator[](size_type n){ return start[difference_type(n)];}
-        const_reference operator[](size_type n) const { return start[difference_type(n)];}
+        reference operator[](size_type n){ return *__index_pointer(n);}
+        const_reference operator[](size_type n) const { return *__index_pointer(n);}
         reference at(size_type n){ assert(n>=0 && n < size()); return (*this)[n];}
         const_reference at(size_type n) const { assert(n>=0 && n < size()); return (*this)[n];}
 
@@ -293,13 +381,59 @@ namespace mjstl
         void pop_back();
         void pop_front();
 
+        /*
+        *   批量操作：一次预留map与缓冲区，再逐段拷贝(平凡类型为memmove)。
+        *   append、prepend：把[first,last)按原顺序接到尾部、头部。
+        *   pop_front_n、pop_back_n：把头部、尾部最多n个元素按原顺序move到out，
+        * 返回out的结尾。
+        */
+        template<class InputIterator>
+        void append(InputIterator first,InputIterator last){
+            __append_aux(first,last,iterator_category(first));
+        }
+        template<class InputIterator>
+        void prepend(InputIterator first,InputIterator last){
+            __prepend_aux(first,last,iterator_category(first));
+        }
+        template<class OutputIterator>
+        OutputIterator pop_front_n(size_type n,OutputIterator out);
+        template<class OutputIterator>
+        OutputIterator pop_back_n(size_type n,OutputIterator out);
+
         void resize(size_type new_size,const T& x);
         void resize(size_type new_size){ resize(new_size,T());}
         void swap(deque& x);
 
         allocate_type get_allocate() { return allocate_type();}
+
+        /*空闲缓冲区缓存的上限，调小时立即释放多余的缓冲区。*/
+        size_type get_spare_limit() const { return spare_limit;}
+        void set_spare_limit(size_type n);
+
+        /*释放空闲缓冲区，并把map缩小到刚好容纳现有节点，节点居中。*/
+        void shrink_to_fit();
+        bool get_auto_shrink() const { return auto_shrink;}
+        void set_auto_shrink(bool on){ auto_shrink = on;}
     
     protected:
+        pointer __allocate_node();
+        void __deallocate_node(pointer p);
+        void __release_spare(size_type keep);
+        void __resize_map(size_type new_map_size);
+        void __auto_shrink(){
+            if(auto_shrink && map_size > size_type(__initial_map_size) &&
+                size_type(finish.node - start.node + 1) * __shrink_ratio < map_size)
+                __resize_map(mjstl::max((size_type)__initial_map_size,
+                    2 * size_type(finish.node - start.node + 1) + 2));
+        }
+
+        /*直接由map定位第n个元素，不构造临时迭代器。*/
+        pointer __index_pointer(size_type n) const{
+            difference_type offset = difference_type(n) + (start.cur - start.first);
+            difference_type new_node = iterator::__node_offset(offset);
+            return start.node[new_node] + iterator::__buf_index(offset,new_node);
+        }
+
         void __create_node(map_pointer nstart,map_pointer nfinish);
         void __destory_node(map_pointer nstart,map_pointer nfinish);
         void __map_initialize(size_t nelem);
@@ -336,6 +470,14 @@ namespace mjstl
         void __insert_dispatch_aux(iterator,ForwardIterator,ForwardIterator,forward_iterator_tag);
         template<class ...Args>
         iterator __emplace_aux(iterator position,Args&& ...args);
+        template<class InputIterator>
+        void __append_aux(InputIterator first,InputIterator last,input_iterator_tag);
+        template<class ForwardIterator>
+        void __append_aux(ForwardIterator first,ForwardIterator last,forward_iterator_tag);
+        template<class InputIterator>
+        void __prepend_aux(InputIterator first,InputIterator last,input_iterator_tag);
+        template<class ForwardIterator>
+        void __prepend_aux(ForwardIterator first,ForwardIterator last,forward_iterator_tag);
         void __push_back_aux(const T& x);
         void __push_front_aux(const T& x);
         void __pop_back_aux();
@@ -361,6 +503,8 @@ deque<T,Alloc,BufSize>::deque(InputIterator first,InputIterator last){
 template<class T,class Alloc,size_t BufSize>
 deque<T,Alloc,BufSize>::deque(const deque<T,Alloc,BufSize>& x){
     __map_initialize(x.size());
+    spare_limit = x.spare_limit;
+    auto_shrink = x.auto_shrink;
     mjstl::uninitialized_copy(x.begin(),x.end(),start);
 }
 
@@ -375,7 +519,10 @@ deque<T,Alloc,BufSize>::deque(deque<T,Alloc,BufSize>&& x):
     start(std::move(x.start)),
     finish(std::move(x.finish)),
     map(x.map),
-    map_size(x.map_size)
+    map_size(x.map_size),
+    spare_count(0),
+    spare_limit(x.spare_limit),
+    auto_shrink(x.auto_shrink)
 {
     x.finish = x.start;
     x.map = nullptr;
@@ -401,9 +548,12 @@ deque<T,Alloc,BufSize>& deque<T,Alloc,BufSize>::operator=(const deque<T,Alloc,Bu
 template<class T,class Alloc,size_t BufSize>
 deque<T,Alloc,BufSize>& 
 deque<T,Alloc,BufSize>::operator=(deque<T,Alloc,BufSize>&& x){
+    if(this == &x) return *this;
     clear();
-    // data_allocator::deallocate(*(start.node),buffer_size());
-    // map_allocator::deallocate(map,map_size);
+    if(map){
+        __destory_node(start.node,finish.node + 1);
+        map_allocator::deallocate(map,map_size);
+    }
 
     start = std::move(x.start);
     finish = std::move(x.finish);
@@ -428,10 +578,12 @@ deque<T,Alloc,BufSize>::operator=(std::initializer_list<value_type> ilist){
 template<class T,class Alloc,size_t BufSize>
 deque<T,Alloc,BufSize>::~deque(){
     if(map){
+        mjstl::destory(start,finish);
         /*这里finish的node指向最后区块，而区块数组是最后一块的下一块，左闭右开原则。*/
         __destory_node(start.node,finish.node + 1);
         map_allocator::deallocate(map,map_size);
     }
+    __release_spare(0);
 }
 
 /*initialize container*/
@@ -514,20 +666,22 @@ deque<T,Alloc,BufSize>::erase(iterator first,iterator last){
         if(elem_before < (size() - n) / 2){
             mjstl::copy_backward(start,first,last);
             iterator new_start = start + n;
-            data_allocator::destory(start.cur,new_start.cur);
+            /*[start,new_start)可能跨越多个缓冲区，要按迭代器逐个析构。*/
+            mjstl::destory(start,new_start);
             /*释放缓冲区，是否必要？*/
             for(map_pointer cur = start.node; cur != new_start.node; ++cur)
-                data_allocator::deallocate(*cur,buffer_size());
+                __deallocate_node(*cur);
             start = new_start;
         }else{
             mjstl::copy(last,finish,first);
             iterator new_finish = finish - n;
-            data_allocator::destory(new_finish.cur,finish.cur);
+            mjstl::destory(new_finish,finish);
             /*finish也在具体缓冲块中，不能直接删除。*/
             for(map_pointer cur = new_finish.node + 1; cur <= finish.node; ++cur)
-                data_allocator::deallocate(*cur,buffer_size());
+                __deallocate_node(*cur);
             finish = new_finish;
         }
+        __auto_shrink();
         return start + elem_before;
     }
 }
@@ -538,7 +692,7 @@ void deque<T,Alloc,BufSize>::clear(){
     /*此处，先释放start和finish之间的map_pointer所指的缓冲区的元素。*/
     for(map_pointer cur = start.node + 1; cur < finish.node; ++cur){
         data_allocator::destory(*cur,*cur + buffer_size());
-        data_allocator::deallocate(*cur,buffer_size());
+        __deallocate_node(*cur);
         *cur = nullptr;
     }
 
@@ -547,12 +701,13 @@ void deque<T,Alloc,BufSize>::clear(){
     if(start.node != finish.node){
         data_allocator::destory(start.cur,start.last);
         data_allocator::destory(finish.first,finish.cur);
-        data_allocator::deallocate(*(finish.node),buffer_size());
+        __deallocate_node(*(finish.node));
         *(finish.node) = nullptr;
     }else{
         data_allocator::destory(start.cur,finish.cur);
     }
     finish = start;
+    __auto_shrink();
 }
 
 template<class T,class Alloc,size_t BufSize>
@@ -608,15 +763,16 @@ void deque<T,Alloc,BufSize>::emplace_front(Args&&... args){
         --start.cur;
     }else{
         __reserve_map_at_front();
-        *(start.node - 1) = data_allocator::allocate(buffer_size());
-        start.set_node(start.node - 1);
-        start.cur = start.last - 1;
+        *(start.node - 1) = __allocate_node();
         try{
-            data_allocator::construct(start.cur,std::forward<Args>(args)...);
+            data_allocator::construct(*(start.node - 1) + (buffer_size() - 1),
+                std::forward<Args>(args)...);
         }catch(...){
-            ++start.cur;
+            __deallocate_node(*(start.node - 1));
             throw;
         }
+        start.set_node(start.node - 1);
+        start.cur = start.last - 1;
     }
 }
 
@@ -627,17 +783,17 @@ void deque<T,Alloc,BufSize>::emplace_back(Args&&... args){
         mjstl::construct((finish.cur),std::forward<Args>(args)...);
         ++finish.cur;
     }else{
+        /*在当前块最后一个位置构造，再把finish移到新块的开头。*/
         __reserve_map_at_back();
-        *(finish.node + 1) = data_allocator::allocate(buffer_size());
-        finish.set_node(finish.node + 1);
-        finish.cur = finish.first;
+        *(finish.node + 1) = __allocate_node();
         try{
             data_allocator::construct(finish.cur,std::forward<Args>(args)...);
-            ++finish.cur;
         }catch(...){
-            --finish.cur;
+            __deallocate_node(*(finish.node + 1));
             throw;
         }
+        finish.set_node(finish.node + 1);
+        finish.cur = finish.first;
     }
 }
 
@@ -711,12 +867,43 @@ void deque<T,Alloc,BufSize>::swap(deque& x){
     mjstl::swap(map_size,x.map_size);
 }
 
+template<class T,class Alloc,size_t BufSize>
+void deque<T,Alloc,BufSize>::set_spare_limit(size_type n){
+    spare_limit = mjstl::min(n,(size_type)__spare_max);
+    __release_spare(spare_limit);
+}
+
+/*优先从空闲缓存中取缓冲区，缓存为空时才向分配器申请。*/
+template<class T,class Alloc,size_t BufSize>
+typename deque<T,Alloc,BufSize>::pointer 
+deque<T,Alloc,BufSize>::__allocate_node(){
+    if(spare_count > 0)
+        return spare[--spare_count];
+    return data_allocator::allocate(buffer_size());
+}
+
+/*缓存未满时留下缓冲区，否则归还分配器。*/
+template<class T,class Alloc,size_t BufSize>
+void deque<T,Alloc,BufSize>::__deallocate_node(pointer p){
+    if(spare_count < spare_limit)
+        spare[spare_count++] = p;
+    else
+        data_allocator::deallocate(p,buffer_size());
+}
+
+/*释放缓存中的缓冲区，只保留keep个。*/
+template<class T,class Alloc,size_t BufSize>
+void deque<T,Alloc,BufSize>::__release_spare(size_type keep){
+    while(spare_count > keep)
+        data_allocator::deallocate(spare[--spare_count],buffer_size());
+}
+
 template<class T,class Alloc,size_t BufSize>
 void deque<T,Alloc,BufSize>::__create_node(map_pointer nstart,map_pointer nfinish){
     map_pointer cur;
     try{
         for(cur = nstart; cur <= nfinish; ++cur)
-            *cur = data_allocator::allocate(buffer_size());
+            *cur = __allocate_node();
     }catch(...){
         __destory_node(nstart,cur);
         throw;
@@ -727,13 +914,16 @@ template<class T,class Alloc,size_t BufSize>
 void deque<T,Alloc,BufSize>::__destory_node(map_pointer nstart,map_pointer nfinish){
     /*这里释放内存还保留了最后一个缓冲块*/
     for(map_pointer n = nstart; n < nfinish; ++n){
-        data_allocator::deallocate(*n,buffer_size());
+        __deallocate_node(*n);
         *n = nullptr;
     }
 }  
 
 template<class T,class Alloc,size_t BufSize>
 void deque<T,Alloc,BufSize>::__map_initialize(size_t nElem){
+    spare_count = 0;
+    spare_limit = mjstl::min((size_type)MJSTL_DEQUE_SPARE_DEFAULT,(size_type)__spare_max);
+    auto_shrink = MJSTL_DEQUE_AUTO_SHRINK != 0;
     /*至少分配1个用来做finish。*/
     size_type nNode = nElem / buffer_size() + 1;
     /*为什么+2？*/
@@ -945,8 +1135,9 @@ void deque<T,Alloc,BufSize>::__fill_insert_aux(iterator position,size_type n,con
     size_type len = size();
     value_type x_copy = x;
     if(elements_before < size_type(len/2)){
-        iterator old_start = start;
+        /*__reserve_elements_at_front可能重新分配map，所以之后再记录old_start。*/
         iterator new_start = __reserve_elements_at_front(n);
+        iterator old_start = start;
         position = start + elements_before;
 
         try{
@@ -981,8 +1172,9 @@ void deque<T,Alloc,BufSize>::__fill_insert_aux(iterator position,size_type n,con
             __destory_node(new_start.node,start.node);
         }
     }else{
-        iterator old_finish = finish;
+        /*__reserve_elements_at_back可能重新分配map，所以之后再记录old_finish。*/
         iterator new_finish = __reserve_elements_at_back(n);
+        iterator old_finish = finish;
         const size_type elements_after = len - elements_before;
         position = finish - elements_after;
 
@@ -1020,8 +1212,9 @@ void deque<T,Alloc,BufSize>::__fill_insert_aux(iterator position,
     size_type elements_before = static_cast<size_type>(mjstl::abs(position - start));
     size_type len = size();
     if(elements_before < size_type(len/2)){
-        iterator old_start = start;
+        /*__reserve_elements_at_front可能重新分配map，所以之后再记录old_start。*/
         iterator new_start = __reserve_elements_at_front(n);
+        iterator old_start = start;
         position = start + elements_before;
         try{
             if(elements_before >= n){
@@ -1042,8 +1235,9 @@ void deque<T,Alloc,BufSize>::__fill_insert_aux(iterator position,
             __destory_node(new_start.node,start.node);
         }
     }else{
-        iterator old_finish = finish;
+        /*__reserve_elements_at_back可能重新分配map，所以之后再记录old_finish。*/
         iterator new_finish = __reserve_elements_at_back(n);
+        iterator old_finish = finish;
         difference_type elements_after = len - elements_before;
         position = finish - elements_after;
 
@@ -1119,13 +1313,14 @@ template<class T,class Alloc,size_t BufSize>
 void deque<T,Alloc,BufSize>::__push_back_aux(const T& x){
     value_type x_copy = x;
     __reserve_map_at_back();
-    *(finish.node + 1) = data_allocator::allocate(buffer_size());
+    *(finish.node + 1) = __allocate_node();
     try{
         data_allocator::construct(finish.cur,x_copy);
         finish.set_node(finish.node + 1);
         finish.cur = finish.first;
     }catch(...){
-        data_allocator::deallocate(*(finish.node + 1));
+        __deallocate_node(*(finish.node + 1));
+        throw;
     }
 }
 
@@ -1133,49 +1328,54 @@ template<class T,class Alloc,size_t BufSize>
 void deque<T,Alloc,BufSize>::__push_front_aux(const T& x){
     value_type x_copy = x;
     __reserve_map_at_front();
-    *(start.node - 1) = data_allocator::allocate(buffer_size());
+    *(start.node - 1) = __allocate_node();
     try{
         start.set_node(start.node - 1);
         start.cur = start.last - 1;
         data_allocator::construct(start.cur,x_copy);
     }catch(...){
         ++start;
-        data_allocator::deallocate(*(start.node - 1));
+        __deallocate_node(*(start.node - 1));
+        throw;
     }
 }
 
 template<class T,class Alloc,size_t BufSize>
 void deque<T,Alloc,BufSize>::__pop_back_aux(){
-    data_allocator::deallocate(finish.first);
+    __deallocate_node(finish.first);
     finish.set_node(finish.node - 1);
     finish.cur = finish.last - 1;
     data_allocator::destory(finish.cur);
+    __auto_shrink();
 }
 
 template<class T,class Alloc,size_t BufSize>
 void deque<T,Alloc,BufSize>::__pop_front_aux(){
     data_allocator::destory(start.cur);
-    data_allocator::deallocate(start.first);
+    __deallocate_node(start.first);
     start.set_node(start.node + 1);
     start.cur = start.first;
+    __auto_shrink();
 }
 
 template<class T,class Alloc,size_t BufSize>
 typename deque<T,Alloc,BufSize>::iterator 
 deque<T,Alloc,BufSize>::__reserve_elements_at_back(size_type n){
-    /*finish.last - finish.cur - 1为什么要多减1？？*/
-    if(n > (size_type)(finish.last - finish.cur - 1)){
-        /*使其至少为1*/
-        size_type new_node = (n + buffer_size() - 1) / buffer_size();
+    /*finish.cur必须指向一个已分配的位置，所以当前块末尾的一个位置不能算作空闲。*/
+    size_type vacancies = static_cast<size_type>(finish.last - finish.cur - 1);
+    if(n > vacancies){
+        /*使其至少为1，只分配超出当前块空闲位置的部分。*/
+        size_type new_node = (n - vacancies + buffer_size() - 1) / buffer_size();
         __reserve_map_at_back(new_node);
 
         size_type i;
         try{
             for(i = 1; i <= new_node; ++i)
-                *(finish.node + i) = data_allocator::allocate(buffer_size());
+                *(finish.node + i) = __allocate_node();
         }catch(...){
             for(size_type j = 1; j < i; ++j)
-                data_allocator::deallocate(*(finish.node + j));
+                __deallocate_node(*(finish.node + j));
+            throw;
         }
     }
     return finish + difference_type(n);
@@ -1196,10 +1396,10 @@ deque<T,Alloc,BufSize>::__reserve_elements_at_front(size_type n){
         size_type i;
         try{
             for(i = 1; i <= new_node; ++i)
-                *(start.node - i) = data_allocator::allocate(buffer_size());
+                *(start.node - i) = __allocate_node();
         }catch(...){
             for(size_type j = 1; j < i; ++j)
-                data_allocator::deallocate(*(start.node - j));
+                __deallocate_node(*(start.node - j));
             throw;
         }
     }
@@ -1253,6 +1453,112 @@ void deque<T,Alloc,BufSize>::__reallocate_map(size_type node_to_add,bool add_at_
     finish.set_node(new_start + old_nodes_num - 1);
 }
 
+/*bulk operation*/
+template<class T,class Alloc,size_t BufSize>
+template<class InputIterator>
+void deque<T,Alloc,BufSize>::__append_aux(InputIterator first,InputIterator last,input_iterator_tag){
+    for(; first != last; ++first)
+        emplace_back(*first);
+}
+
+template<class T,class Alloc,size_t BufSize>
+template<class ForwardIterator>
+void deque<T,Alloc,BufSize>::__append_aux(ForwardIterator first,ForwardIterator last,forward_iterator_tag){
+    size_type n = static_cast<size_type>(mjstl::distance(first,last));
+    iterator new_finish = __reserve_elements_at_back(n);
+    try{
+        mjstl::uninitialized_copy(first,last,finish);
+        finish = new_finish;
+    }catch(...){
+        __destory_node(finish.node + 1,new_finish.node + 1);
+        throw;
+    }
+}
+
+/*输入迭代器只能逐个插到头部，插完后再把这一段翻转回原顺序。*/
+template<class T,class Alloc,size_t BufSize>
+template<class InputIterator>
+void deque<T,Alloc,BufSize>::__prepend_aux(InputIterator first,InputIterator last,input_iterator_tag){
+    size_type n = 0;
+    for(; first != last; ++first,++n)
+        emplace_front(*first);
+    iterator left = start;
+    iterator right = start + difference_type(n);
+    while(left != right && left != --right){
+        mjstl::iter_swap(left,right);
+        ++left;
+    }
+}
+
+template<class T,class Alloc,size_t BufSize>
+template<class ForwardIterator>
+void deque<T,Alloc,BufSize>::__prepend_aux(ForwardIterator first,ForwardIterator last,forward_iterator_tag){
+    size_type n = static_cast<size_type>(mjstl::distance(first,last));
+    iterator new_start = __reserve_elements_at_front(n);
+    try{
+        mjstl::uninitialized_copy(first,last,new_start);
+        start = new_start;
+    }catch(...){
+        __destory_node(new_start.node,start.node);
+        throw;
+    }
+}
+
+template<class T,class Alloc,size_t BufSize>
+template<class OutputIterator>
+OutputIterator deque<T,Alloc,BufSize>::pop_front_n(size_type n,OutputIterator out){
+    if(n > size()) n = size();
+    iterator new_start = start + difference_type(n);
+    out = mjstl::unchecked_move(start,new_start,out);
+    mjstl::destory(start,new_start);
+    /*[start.node,new_start.node)这些缓冲区已全部取空。*/
+    __destory_node(start.node,new_start.node);
+    start = new_start;
+    __auto_shrink();
+    return out;
+}
+
+template<class T,class Alloc,size_t BufSize>
+template<class OutputIterator>
+OutputIterator deque<T,Alloc,BufSize>::pop_back_n(size_type n,OutputIterator out){
+    if(n > size()) n = size();
+    iterator new_finish = finish - difference_type(n);
+    out = mjstl::unchecked_move(new_finish,finish,out);
+    mjstl::destory(new_finish,finish);
+    __destory_node(new_finish.node + 1,finish.node + 1);
+    finish = new_finish;
+    __auto_shrink();
+    return out;
+}
+
+/*
+*   把map换成new_map_size大小的新map，现有节点居中放置。
+*   节点指向的缓冲区不动，start、finish只需重新set_node，cur保持不变。
+*/
+template<class T,class Alloc,size_t BufSize>
+void deque<T,Alloc,BufSize>::__resize_map(size_type new_map_size){
+    size_type nodes_num = finish.node - start.node + 1;
+    map_pointer new_map = map_allocator::allocate(new_map_size);
+    map_pointer new_start = new_map + (new_map_size - nodes_num) / 2;
+    mjstl::copy(start.node,finish.node + 1,new_start);
+    map_allocator::deallocate(map,map_size);
+    map = new_map;
+    map_size = new_map_size;
+    start.set_node(new_start);
+    finish.set_node(new_start + nodes_num - 1);
+}
+
+template<class T,class Alloc,size_t BufSize>
+void deque<T,Alloc,BufSize>::shrink_to_fit(){
+    __release_spare(0);
+    if(!map) return;
+    /*与__map_initialize一致，两端各留一个空位。*/
+    size_type new_map_size = mjstl::max((size_type)__initial_map_size,
+        size_type(finish.node - start.node + 1) + 2);
+    if(new_map_size < map_size)
+        __resize_map(new_map_size);
+}
+
 template<class T,class Alloc,size_t BufSize>
 bool operator==(const deque<T,Alloc,BufSize>& lhs,const deque<T,Alloc,BufSize>& rhs)
 {
@@ -1296,5 +1602,19 @@ void swap(deque<T,Alloc,BufSize>& lhs,deque<T,Alloc,BufSize>& rhs)
     lhs.swap(rhs);
 }
 
+/*
+*   删除所有使pred为true的元素，返回删除个数。
+*   保留的元素一趟move到前面，尾部[it,end)一次erase，整段析构并释放多余缓冲区。
+*/
+template<class T,class Alloc,size_t BufSize,class Predicate>
+typename deque<T,Alloc,BufSize>::size_type 
+erase_if(deque<T,Alloc,BufSize>& d,Predicate pred)
+{
+    typename deque<T,Alloc,BufSize>::iterator it = __remove_if_move(d.begin(),d.end(),pred);
+    typename deque<T,Alloc,BufSize>::size_type n = d.end() - it;
+    d.erase(it,d.end());
+    return n;
+}
+
 } // namespace mjstl
 #endif// !__DEQUE_H__
\ No newline at end of file
@@ -0,0 +1,220 @@
+#ifndef __FLAT_COMBINING_H__
+#define __FLAT_COMBINING_H__
+
+#include <atomic>
+#include <exception>
+
+#include "stack.h"
+#include "queue.h"
+#include "sync_util.h"
+
+namespace mjstl
+{
+    /*
+    *   flat_combining：把stack、queue、priority_queue这类顺序适配器变成并发的。
+    *   每个线程把要做的操作发布到自己的槽(slot)里，槽按缓存行对齐。
+    * 抢到锁的线程成为combiner，扫描所有槽，一次性执行别人发布的一批操作，
+    * 其他线程只是在自己的槽上自旋等结果。
+    *   容器只被combiner一个线程访问，缓存一直是热的；竞争激烈时，
+    * 一次加锁完成一批操作，锁所在的缓存行不会在所有核之间来回传递。
+    *
+    *   槽的状态：__FC_FREE空闲 -> __FC_OWNED被某线程占用 -> __FC_PENDING已发布
+    * -> __FC_DONE已执行 -> __FC_FREE。
+    *   线程按自己的编号选起始槽，被占用就往后找，所以线程数可以超过Slots，只是要等槽空出来。
+    * combiner只扫描到用过的最大槽号used_为止。
+    *   没有竞争时锁是空闲的，线程直接拿锁执行自己的操作，不经过槽，
+    * 顺便执行别人已发布的操作后放锁。
+    *   combiner执行的操作抛出异常时，异常保存在槽里，由发布者重新抛出。
+    *
+    *   apply(f)：在combiner线程里执行f(adapter)，可以组合多个操作，f不能再调用本对象。
+    */
+    enum { __FC_FREE = 0, __FC_OWNED = 1, __FC_PENDING = 2, __FC_DONE = 3 };
+    enum { __FC_PASSES = 2 };
+
+    /*每个线程一个编号，只用来分散起始槽。*/
+    inline unsigned __fc_thread_index(){
+        static std::atomic<unsigned> next(0);
+        static thread_local unsigned index = next.fetch_add(1,std::memory_order_relaxed);
+        return index;
+    }
+
+    /*从各适配器取出"下一个"元素：stack取栈顶，queue取队头，priority_queue取堆顶。*/
+    template<class T,class Container>
+    bool __fc_take(stack<T,Container>& s,T& out){
+        if(s.empty()) return false;
+        out = mjstl::move(s.top());
+        s.pop();
+        return true;
+    }
+
+    template<class T,class Container>
+    bool __fc_take(queue<T,Container>& q,T& out){
+        if(q.empty()) return false;
+        out = mjstl::move(q.front());
+        q.pop();
+        return true;
+    }
+
+    template<class T,class Container,class Compare,size_t Arity>
+    bool __fc_take(priority_queue<T,Container,Compare,Arity>& q,T& out){
+        if(q.empty()) return false;
+        out = q.top();
+        q.pop();
+        return true;
+    }
+
+    template<class Adapter,size_t Slots = 32>
+    class flat_combining{
+    public:
+        typedef Adapter                                 adapter_type;
+        typedef typename Adapter::value_type            value_type;
+        typedef typename Adapter::size_type             size_type;
+        typedef value_type&                             reference;
+        typedef const value_type&                       const_reference;
+
+    protected:
+        typedef void (*op_type)(adapter_type&,void*);
+
+        struct alignas(__CACHE_LINE_SIZE) slot{
+            std::atomic<int> state;
+            op_type op;
+            void* arg;
+            std::exception_ptr error;
+
+            slot():state(__FC_FREE),op(nullptr),arg(nullptr){}
+        };
+
+        alignas(__CACHE_LINE_SIZE) std::atomic<bool> lock_;
+        std::atomic<size_t> used_;
+        alignas(__CACHE_LINE_SIZE) adapter_type c_;
+        slot slots_[Slots];
+
+    public:
+        flat_combining():lock_(false),used_(0),c_(){}
+        explicit flat_combining(const adapter_type& c):lock_(false),used_(0),c_(c){}
+
+        flat_combining(const flat_combining&) = delete;
+        flat_combining& operator=(const flat_combining&) = delete;
+
+    public:
+        void push(const value_type& x){ __run(&__push_copy,const_cast<value_type*>(&x));}
+        void push(value_type&& x){ __run(&__push_move,&x);}
+
+        /*取出下一个元素move到out，为空时返回false。*/
+        bool try_pop(value_type& out){
+            pop_arg a = { &out, false };
+            __run(&__pop,&a);
+            return a.ok;
+        }
+
+        template<class Function>
+        void apply(Function f){ __run(&__invoke<Function>,&f);}
+
+        /*并发修改时只是某一时刻的值。*/
+        size_type size(){
+            size_type n = 0;
+            __run(&__size,&n);
+            return n;
+        }
+        bool empty(){ return size() == 0;}
+
+    protected:
+        struct pop_arg{
+            value_type* out;
+            bool ok;
+        };
+
+        static void __push_copy(adapter_type& c,void* p){ c.push(*static_cast<const value_type*>(p));}
+        static void __push_move(adapter_type& c,void* p){ c.push(mjstl::move(*static_cast<value_type*>(p)));}
+        static void __pop(adapter_type& c,void* p){
+            pop_arg* a = static_cast<pop_arg*>(p);
+            a->ok = __fc_take(c,*a->out);
+        }
+        static void __size(adapter_type& c,void* p){ *static_cast<size_type*>(p) = c.size();}
+        template<class Function>
+        static void __invoke(adapter_type& c,void* p){ (*static_cast<Function*>(p))(c);}
+
+        bool __try_lock(){
+            return !lock_.load(std::memory_order_relaxed) &&
+                !lock_.exchange(true,std::memory_order_acquire);
+        }
+        void __unlock(){ lock_.store(false,std::memory_order_release);}
+
+        slot* __acquire_slot();
+        void __combine();
+        void __run(op_type op,void* arg);
+    };
+
+template<class Adapter,size_t Slots>
+typename flat_combining<Adapter,Slots>::slot*
+flat_combining<Adapter,Slots>::__acquire_slot(){
+    unsigned spins = 0;
+    for(size_t i = __fc_thread_index() % Slots;; i = (i + 1) % Slots){
+        int s = __FC_FREE;
+        if(slots_[i].state.load(std::memory_order_relaxed) == __FC_FREE &&
+            slots_[i].state.compare_exchange_strong(s,__FC_OWNED,std::memory_order_acquire)){
+            size_t used = used_.load(std::memory_order_relaxed);
+            while(used <= i && !used_.compare_exchange_weak(used,i + 1,std::memory_order_relaxed));
+            return &slots_[i];
+        }
+        if(i + 1 == Slots) __spin_wait(spins);
+    }
+}
+
+/*持有锁时调用：扫描__FC_PASSES遍，执行所有已发布的操作。*/
+template<class Adapter,size_t Slots>
+void flat_combining<Adapter,Slots>::__combine(){
+    for(int pass = 0; pass < __FC_PASSES; ++pass){
+        bool any = false;
+        size_t used = used_.load(std::memory_order_relaxed);
+        for(size_t i = 0; i < used; ++i){
+            slot& s = slots_[i];
+            if(s.state.load(std::memory_order_acquire) != __FC_PENDING) continue;
+            try{
+                s.op(c_,s.arg);
+            }catch(...){
+                s.error = std::current_exception();
+            }
+            s.state.store(__FC_DONE,std::memory_order_release);
+            any = true;
+        }
+        if(!any) break;
+    }
+}
+
+template<class Adapter,size_t Slots>
+void flat_combining<Adapter,Slots>::__run(op_type op,void* arg){
+    if(__try_lock()){
+        std::exception_ptr e;
+        try{
+            op(c_,arg);
+        }catch(...){
+            e = std::current_exception();
+        }
+        __combine();
+        __unlock();
+        if(e) std::rethrow_exception(e);
+        return;
+    }
+    slot* s = __acquire_slot();
+    s->op = op;
+    s->arg = arg;
+    s->state.store(__FC_PENDING,std::memory_order_release);
+    unsigned spins = 0;
+    while(s->state.load(std::memory_order_acquire) != __FC_DONE){
+        if(__try_lock()){
+            __combine();
+            __unlock();
+            spins = 0;
+        }else{
+            __spin_wait(spins);
+        }
+    }
+    std::exception_ptr e = s->error;
+    s->error = nullptr;
+    s->state.store(__FC_FREE,std::memory_order_release);
+    if(e) std::rethrow_exception(e);
+}
+
+} // namespace mjstl
+#endif // !__FLAT_COMBINING_H__
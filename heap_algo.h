@@ -1,7 +1,11 @@
 #ifndef __HEAP_ALGO_H__
 #define __HEAP_ALGO_H__
 
+#include <functional>
+#include <type_traits>
+
 #include "iterator.h"
+#include "util.h"
 namespace mjstl{
 
 /* heap算法： push_heap , pop_heap , sort_heap , make_heap */
@@ -26,7 +30,7 @@ void push_heap_aux(RandomAccessIterator first, Distance holeIndex, Distance topI
 /*将容器最后一个元素作为参数传入push_head_aux，使得最后元素不会在上率时被覆盖，因为参数传递产生了副本。*/
 template<class RandomAccessIterator, class Distance>
 inline void push_heap_d(RandomAccessIterator first, RandomAccessIterator last, Distance*){
-    push_head_aux(first,Distance(last-first - 1),Distance(0),*(last-1));
+    push_heap_aux(first,Distance(last-first - 1),Distance(0),*(last-1));
 }
 
 /*需要push的元素已经在容器最尾端！*/
@@ -61,6 +65,78 @@ inline void push_heap(RandomAccessIterator first, RandomAccessIterator last, Com
 }
 
 
+/*************************************************bottom-up pop**************************************************/
+/*
+*   pop时先把空位从根沿较大的孩子一直移到叶子，每层只比较两个孩子，再把原来的尾元素从叶子上滤回去。
+* 尾元素通常很小，上滤一两步就停，总比较次数接近log(n)，而不是自上而下时的2log(n)。
+*   元素是算术类型、比较器是小于或大于时，选孩子写成child + (a < b)，没有分支，
+* 随机数据时不会误预测；但下一层的地址要等比较结果才知道，堆比缓存大时每层都要等一次访存，
+* 所以提前预取空位下面两层、三层的后代(4h+3起4个、8h+7起8个)，它们在数组里是连续的。
+* 其他类型保留分支。
+*/
+template<class T>
+struct __heap_less{
+    bool operator()(const T& a,const T& b) const { return a < b;}
+};
+
+template<class T,class Compare>
+struct __heap_branchless : public m_false_type{};
+
+template<class T>
+struct __heap_branchless<T,__heap_less<T>> : public m_bool_constant<std::is_arithmetic<T>::value>{};
+
+template<class T>
+struct __heap_branchless<T,std::less<T>> : public m_bool_constant<std::is_arithmetic<T>::value>{};
+
+template<class T>
+struct __heap_branchless<T,std::greater<T>> : public m_bool_constant<std::is_arithmetic<T>::value>{};
+
+template<class RandomAccessIterator>
+inline void __heap_prefetch(RandomAccessIterator it){
+#if defined(_MSC_VER)
+    (void)it;
+#else
+    __builtin_prefetch(&*it);
+#endif
+}
+
+/*child是左孩子，返回两个孩子中较大的一个。*/
+template<class RandomAccessIterator,class Distance,class Compare>
+inline Distance __heap_larger_child(RandomAccessIterator first,Distance child,Compare& comp,m_true_type){
+    return child + Distance(comp(*(first + child),*(first + child + 1)));
+}
+
+template<class RandomAccessIterator,class Distance,class Compare>
+inline Distance __heap_larger_child(RandomAccessIterator first,Distance child,Compare& comp,m_false_type){
+    if(comp(*(first + child),*(first + child + 1))) ++child;
+    return child;
+}
+
+/*[first,first+len)是去掉堆顶后的堆，堆顶已经移走，把value放进去。*/
+template<class RandomAccessIterator,class Distance,class T,class Compare>
+void __pop_heap_bottom_up(RandomAccessIterator first,Distance len,T value,Compare comp){
+    typedef __heap_branchless<typename iterator_traits<RandomAccessIterator>::value_type,
+        Compare> branchless;
+    Distance holeIndex = 0;
+    Distance rchild = 2;
+    while(rchild < len){
+        if(branchless::value && 8 * holeIndex + 14 < len){
+            __heap_prefetch(first + (4 * holeIndex + 3));
+            __heap_prefetch(first + (8 * holeIndex + 7));
+            __heap_prefetch(first + (8 * holeIndex + 14));
+        }
+        rchild = __heap_larger_child(first,rchild - 1,comp,branchless());
+        *(first + holeIndex) = mjstl::move(*(first + rchild));
+        holeIndex = rchild;
+        rchild = 2 * holeIndex + 2;
+    }
+    if(rchild == len){
+        *(first + holeIndex) = mjstl::move(*(first + rchild - 1));
+        holeIndex = rchild - 1;
+    }
+    push_heap_aux(first,holeIndex,Distance(0),mjstl::move(value),comp);
+}
+
 /*************************************************pop_heap**************************************************/
 /* [first,last) 表示容器的首尾,将会把heap根元素放入尾部，并调整heap*/
 
@@ -93,11 +169,11 @@ template<class RandomAccessIterator, class T, class Distance>
 void pop_heap_aux(RandomAccessIterator first, RandomAccessIterator last,
     RandomAccessIterator result,T value,Distance*){
     *result = *first;/*尾值被覆盖，难道不是跟尾值交换？并不会，原尾值被作为value参数传递进来！*/
-    adjust_heap(first,Distance(0),Distance(last - first),value);
+    __pop_heap_bottom_up(first,Distance(last - first),mjstl::move(value),__heap_less<T>());
 }
 
-template<class RandomAccessIterator, class T>
-void pop_heap(RandomAccessIterator first, RandomAccessIterator last, T*){
+template<class RandomAccessIterator>
+void pop_heap(RandomAccessIterator first, RandomAccessIterator last){
     pop_heap_aux(first,last-1,last-1,*(last-1),distance_type(first));
 }
 
@@ -123,7 +199,7 @@ template<class RandomAccessIterator,class T,class Distance,class Compare>
 void pop_head_aux(RandomAccessIterator first, RandomAccessIterator last,
     RandomAccessIterator result, T value, Distance*,Compare comp){
     *result = *first;
-    adjust_heap(first,(Distance)0,last - first,value,comp);
+    __pop_heap_bottom_up(first,Distance(last - first),mjstl::move(value),comp);
 }
 
 template<class RandomAccessIterator,class Compare>
@@ -131,13 +207,18 @@ void pop_head(RandomAccessIterator first,RandomAccessIterator last,Compare comp)
     pop_head_aux(first,last-1,last-1,*(last-1),distance_type(first),comp);
 }
 
+template<class RandomAccessIterator,class Compare>
+void pop_heap(RandomAccessIterator first,RandomAccessIterator last,Compare comp){
+    pop_head(first,last,comp);
+}
+
 /*************************************************sort_heap**************************************************/
 /*前提条件： [first,last) 符合堆序性。*/
 template<class RandomAccessIterator>
 void sort_heap(RandomAccessIterator first, RandomAccessIterator last){
     /*每次元素出栈后都放到了队尾，然后last-1，相当于last维护无序区，而last后面是有序区*/
     while(last - first > 1){
-        pop_head(first,last--);
+        pop_heap(first,last--);
     }
 }
 
@@ -188,6 +269,145 @@ void make_heap(RandomAccessIterator first, RandomAccessIterator last,Compare com
     make_heap_aux(first,last,distance_type(first),comp);
 }
 
+/*************************************************d-ary heap**************************************************/
+/*
+*   d叉堆：下标i的孩子是D*i+1 ... D*i+D，父节点是(i-1)/D。用法push_heap<4>(first,last)。
+*   树高是log_D(n)，D=4、8时比二叉堆矮一半、三分之二，上滤比较次数少；
+* 下滤每层要在D个孩子里挑最大的，D-1次比较，但这D个孩子是连续的，int元素时在一两条缓存行里，
+* 元素很多、堆放不进缓存时，减少的层数就是减少的缓存缺失。
+*   下滤和adjust_heap一样，先把空位沿较大的孩子一直移到叶子，再把value上滤回去。
+*/
+template<size_t D,class RandomAccessIterator,class Distance,class T,class Compare>
+void __dary_push_heap_aux(RandomAccessIterator first,Distance holeIndex,
+    Distance topIndex,T value,Compare& comp){
+    Distance parent = (holeIndex - 1) / Distance(D);
+    while(holeIndex > topIndex && comp(*(first + parent),value)){
+        *(first + holeIndex) = mjstl::move(*(first + parent));
+        holeIndex = parent;
+        parent = (holeIndex - 1) / Distance(D);
+    }
+    *(first + holeIndex) = mjstl::move(value);
+}
+
+/*
+*   在[i,i+K)里选最大的下标：两半各选一个再比一次，比较次数仍是K-1，
+* 但依赖链只有log2(K)层。选下标用乘法而不用分支，随机数据时不会误预测。
+*/
+template<size_t K>
+struct __dary_max_child{
+    template<class RandomAccessIterator,class Distance,class Compare>
+    static Distance select(RandomAccessIterator first,Distance i,Compare& comp){
+        Distance a = __dary_max_child<K / 2>::select(first,i,comp);
+        Distance b = __dary_max_child<K - K / 2>::select(first,i + Distance(K / 2),comp);
+        return a + (b - a) * Distance(comp(*(first + a),*(first + b)));
+    }
+};
+
+template<>
+struct __dary_max_child<1>{
+    template<class RandomAccessIterator,class Distance,class Compare>
+    static Distance select(RandomAccessIterator,Distance i,Compare&){ return i;}
+};
+
+template<size_t D,class RandomAccessIterator,class Distance,class T,class Compare>
+void __dary_adjust_heap(RandomAccessIterator first,Distance holeIndex,
+    Distance len,T value,Compare& comp){
+    Distance topIndex = holeIndex;
+    Distance child = Distance(D) * holeIndex + 1;
+    while(child + Distance(D) <= len){
+        Distance best = child;
+        /*
+        *   二叉时保留分支：下一层的地址取决于比较结果，有分支时CPU猜一边先去取，
+        * 堆放不进缓存时比等比较结果快；D更大时一层要比D-1次，分支猜不准的代价更大。
+        */
+        if(D == 2){
+            if(comp(*(first + child),*(first + child + 1))) ++best;
+        }else
+            best = __dary_max_child<D>::select(first,child,comp);
+        *(first + holeIndex) = mjstl::move(*(first + best));
+        holeIndex = best;
+        child = Distance(D) * holeIndex + 1;
+    }
+    if(child < len){
+        Distance best = child;
+        for(Distance i = child + 1; i < len; ++i)
+            if(comp(*(first + best),*(first + i))) best = i;
+        *(first + holeIndex) = mjstl::move(*(first + best));
+        holeIndex = best;
+    }
+    __dary_push_heap_aux<D>(first,holeIndex,topIndex,mjstl::move(value),comp);
+}
+
+template<size_t D,class RandomAccessIterator,class Compare>
+void push_heap(RandomAccessIterator first,RandomAccessIterator last,Compare comp){
+    static_assert(D >= 2,"heap arity must be at least 2");
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    if(last - first < 2) return;
+    T value = mjstl::move(*(last - 1));
+    __dary_push_heap_aux<D>(first,Distance(last - first - 1),Distance(0),mjstl::move(value),comp);
+}
+
+template<size_t D,class RandomAccessIterator>
+void push_heap(RandomAccessIterator first,RandomAccessIterator last){
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    mjstl::push_heap<D>(first,last,__heap_less<T>());
+}
+
+/*堆顶移到last-1，[first,last-1)重新成为堆。*/
+template<size_t D,class RandomAccessIterator,class Compare>
+void pop_heap(RandomAccessIterator first,RandomAccessIterator last,Compare comp){
+    static_assert(D >= 2,"heap arity must be at least 2");
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    if(last - first < 2) return;
+    T value = mjstl::move(*(last - 1));
+    *(last - 1) = mjstl::move(*first);
+    if(D == 2)
+        __pop_heap_bottom_up(first,Distance(last - first - 1),mjstl::move(value),comp);
+    else
+        __dary_adjust_heap<D>(first,Distance(0),Distance(last - first - 1),mjstl::move(value),comp);
+}
+
+template<size_t D,class RandomAccessIterator>
+void pop_heap(RandomAccessIterator first,RandomAccessIterator last){
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    mjstl::pop_heap<D>(first,last,__heap_less<T>());
+}
+
+/*从最后一个非叶子节点(len-2)/D开始，自底向上逐个下滤。*/
+template<size_t D,class RandomAccessIterator,class Compare>
+void make_heap(RandomAccessIterator first,RandomAccessIterator last,Compare comp){
+    static_assert(D >= 2,"heap arity must be at least 2");
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    Distance len = last - first;
+    if(len < 2) return;
+    for(Distance holeIndex = (len - 2) / Distance(D);; --holeIndex){
+        T value = mjstl::move(*(first + holeIndex));
+        __dary_adjust_heap<D>(first,holeIndex,len,mjstl::move(value),comp);
+        if(holeIndex == 0) return;
+    }
+}
+
+template<size_t D,class RandomAccessIterator>
+void make_heap(RandomAccessIterator first,RandomAccessIterator last){
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    mjstl::make_heap<D>(first,last,__heap_less<T>());
+}
+
+template<size_t D,class RandomAccessIterator,class Compare>
+void sort_heap(RandomAccessIterator first,RandomAccessIterator last,Compare comp){
+    while(last - first > 1)
+        mjstl::pop_heap<D>(first,last--,comp);
+}
+
+template<size_t D,class RandomAccessIterator>
+void sort_heap(RandomAccessIterator first,RandomAccessIterator last){
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    mjstl::sort_heap<D>(first,last,__heap_less<T>());
+}
+
 }//namespace mjstl
 
 #endif//__HEAP_ALGO_H__
\ No newline at end of file
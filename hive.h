@@ -0,0 +1,571 @@
+#ifndef __HIVE_H__
+#define __HIVE_H__
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "iterator.h"
+#include "reverse_iterator.h"
+#include "memory.h"
+
+namespace mjstl
+{
+    /*
+    *   hive：地址稳定的分块容器(colony/hive)。
+    *   元素存放在一组按几何级数增长的块(group)里，块之间用双向链表串起来，
+    * 插入、删除都不会移动已有元素，所以指向元素的指针、迭代器一直有效(直到该元素被删除)。
+    *
+    *   被删除的位置用"跳跃计数跳表"(low-complexity jump-counting skipfield)标记：
+    * skipfield[i] == 0表示i处有元素；一段连续的空位(skipblock)长度为L，
+    * 则它的第一个和最后一个位置都记为L，中间的值不关心。
+    *   遍历时 ++i; i += skipfield[i]; 一次跳过整段空位，不需要逐个判断。
+    *
+    *   每个块内的skipblock用双向链表(free list)串起来，链表节点就存放在空位的元素内存里，
+    * 有空位的块再串成一个链表，插入时优先复用空位，所以插入、删除都是O(1)。
+    */
+    enum { __HIVE_MIN_GROUP = 8, __HIVE_MAX_GROUP = 8192 };
+
+    template<class T>
+    struct __hive_group{
+        typedef unsigned short skip_type;
+        /*空位里存放的free list节点，记录前后skipblock的起始下标。*/
+        struct free_link{
+            skip_type prev;
+            skip_type next;
+        };
+        enum { none = 0xffff };
+
+        typedef typename std::aligned_storage<
+            (sizeof(T) > sizeof(free_link) ? sizeof(T) : sizeof(free_link)),
+            (alignof(T) > alignof(free_link) ? alignof(T) : alignof(free_link))>::type slot_type;
+
+        slot_type* elements;
+        skip_type* skipfield;      /*capacity + 1个，最后一个恒为0，作为哨兵。*/
+        __hive_group* prev;
+        __hive_group* next;
+        __hive_group* erasures_prev;/*有空位的块组成的链表。*/
+        __hive_group* erasures_next;
+        skip_type capacity;
+        skip_type last_endpoint;    /*[0,last_endpoint)是用过的位置，之后从未构造过元素。*/
+        skip_type size;             /*块内元素个数。*/
+        skip_type free_head;        /*第一个skipblock的起始下标，none表示没有空位。*/
+
+        T* value(skip_type i){ return reinterpret_cast<T*>(elements + i);}
+        free_link* link(skip_type i){ return reinterpret_cast<free_link*>(elements + i);}
+    };
+
+    template<class T,class Ref,class Ptr>
+    struct __hive_iterator : public iterator<bidirectional_iterator_tag,T>{
+        typedef __hive_iterator<T,T&,T*>                iterator;
+        typedef __hive_iterator<T,const T&,const T*>    const_iterator;
+        typedef __hive_iterator<T,Ref,Ptr>              self;
+
+        typedef bidirectional_iterator_tag  iterator_category;
+        typedef T                           value_type;
+        typedef Ptr                         pointer;
+        typedef Ref                         reference;
+        typedef size_t                      size_type;
+        typedef ptrdiff_t                   difference_type;
+
+        typedef __hive_group<T>*            group_pointer;
+        typedef typename __hive_group<T>::skip_type skip_type;
+
+        group_pointer group;
+        skip_type index;
+
+        __hive_iterator():group(nullptr),index(0){}
+        __hive_iterator(group_pointer g,skip_type i):group(g),index(i){}
+        __hive_iterator(const iterator& x):group(x.group),index(x.index){}
+
+        bool operator==(const self& x) const{ return group == x.group && index == x.index;}
+        bool operator!=(const self& x) const{ return !(*this == x);}
+        reference operator*() const { return *group->value(index);}
+        pointer operator->() const { return &(operator*());}
+
+        /*跳过空位；走出当前块时转到下一块的第一个元素，最后一块停在last_endpoint，即end()。*/
+        self& operator++(){
+            ++index;
+            index += group->skipfield[index];
+            if(index == group->last_endpoint && group->next != nullptr){
+                group = group->next;
+                index = group->skipfield[0];
+            }
+            return *this;
+        }
+
+        self operator++(int){
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        /*每个块都至少有一个元素，所以最多退回到前一块一次。*/
+        self& operator--(){
+            if(index != 0){
+                --index;
+                const skip_type skip = group->skipfield[index];
+                if(skip <= index){
+                    index -= skip;
+                    return *this;
+                }
+            }
+            group = group->prev;
+            index = group->last_endpoint - 1;
+            index -= group->skipfield[index];
+            return *this;
+        }
+
+        self operator--(int){
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+    };
+
+    template<class T,class Alloc = alloc>
+    class hive{
+    public:
+        typedef T                       value_type;
+        typedef Alloc                   allocate_type;
+        typedef value_type*             pointer;
+        typedef const value_type*       const_pointer;
+        typedef value_type&             reference;
+        typedef const value_type&       const_reference;
+        typedef size_t                  size_type;
+        typedef ptrdiff_t               difference_type;
+
+        typedef __hive_iterator<T,T&,T*>                iterator;
+        typedef __hive_iterator<T,const T&,const T*>    const_iterator;
+        typedef mjstl::reverse_iterator<iterator>       reverse_iterator;
+        typedef mjstl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    protected:
+        typedef __hive_group<T>                 group;
+        typedef group*                          group_pointer;
+        typedef typename group::skip_type       skip_type;
+        typedef typename group::slot_type       slot_type;
+        typedef simple_alloc<group,Alloc>       group_allocator;
+        typedef simple_alloc<slot_type,Alloc>   slot_allocator;
+        typedef simple_alloc<skip_type,Alloc>   skip_allocator;
+
+    protected:
+        group_pointer begin_group;
+        group_pointer end_group;
+        group_pointer erasures_head;
+        size_type size_;
+        size_type capacity_;
+
+    public:
+        hive():begin_group(nullptr),end_group(nullptr),erasures_head(nullptr),size_(0),capacity_(0){}
+        hive(size_type n,const T& value);
+        hive(std::initializer_list<value_type> ilist);
+        template<class InputIterator,typename std::enable_if<
+            mjstl::is_input_iterator<InputIterator>::value,int>::type = 0>
+        hive(InputIterator first,InputIterator last);
+
+        hive(const hive& x);
+        hive(hive&& x);
+
+        hive& operator=(const hive& x);
+        hive& operator=(hive&& x);
+
+        ~hive(){ __destory_all();}
+
+    public:
+        /*about iterator*/
+        iterator begin(){
+            return begin_group == nullptr ? iterator() : iterator(begin_group,begin_group->skipfield[0]);
+        }
+        const_iterator begin() const {
+            return begin_group == nullptr ? const_iterator() : iterator(begin_group,begin_group->skipfield[0]);
+        }
+        iterator end(){
+            return end_group == nullptr ? iterator() : iterator(end_group,end_group->last_endpoint);
+        }
+        const_iterator end() const {
+            return end_group == nullptr ? const_iterator() : iterator(end_group,end_group->last_endpoint);
+        }
+        reverse_iterator rbegin(){ return reverse_iterator(end());}
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end());}
+        reverse_iterator rend(){ return reverse_iterator(begin());}
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin());}
+
+        /*about container*/
+        bool empty() const { return size_ == 0;}
+        size_type size() const { return size_;}
+        size_type capacity() const { return capacity_;}
+        size_type max_size() const { return size_type(-1) / sizeof(slot_type);}
+
+        /*modify container*/
+        template<class ...Args>
+        iterator emplace(Args&& ...args);
+        iterator insert(const T& value){ return emplace(value);}
+        iterator insert(T&& value){ return emplace(mjstl::move(value));}
+        void insert(size_type n,const T& value);
+        template<class InputIterator,typename std::enable_if<
+            mjstl::is_input_iterator<InputIterator>::value,int>::type = 0>
+        void insert(InputIterator first,InputIterator last);
+        iterator erase(const_iterator position);
+        iterator erase(const_iterator first,const_iterator last);
+        void clear();
+        void swap(hive& x);
+
+        /*由元素地址找回迭代器，要逐块比较地址范围。*/
+        iterator get_iterator(const_pointer p);
+
+    protected:
+        group_pointer __create_group(size_type capacity);
+        void __destory_group(group_pointer g);
+        void __destory_all();
+        void __add_erasures(group_pointer g);
+        void __remove_erasures(group_pointer g);
+        void __remove_group(group_pointer g);
+        iterator __erase_slot(group_pointer g,skip_type index);
+        void __free_list_replace(group_pointer g,skip_type old_index,skip_type new_index);
+        void __free_list_remove(group_pointer g,skip_type index);
+        void __free_list_push(group_pointer g,skip_type index);
+        skip_type __acquire_slot(group_pointer& g);
+    };
+
+template<class T,class Alloc>
+hive<T,Alloc>::hive(size_type n,const T& value)
+  :begin_group(nullptr),end_group(nullptr),erasures_head(nullptr),size_(0),capacity_(0)
+{
+    insert(n,value);
+}
+
+template<class T,class Alloc>
+hive<T,Alloc>::hive(std::initializer_list<value_type> ilist)
+  :begin_group(nullptr),end_group(nullptr),erasures_head(nullptr),size_(0),capacity_(0)
+{
+    insert(ilist.begin(),ilist.end());
+}
+
+template<class T,class Alloc>
+template<class InputIterator,typename std::enable_if<
+  mjstl::is_input_iterator<InputIterator>::value,int>::type>
+hive<T,Alloc>::hive(InputIterator first,InputIterator last)
+  :begin_group(nullptr),end_group(nullptr),erasures_head(nullptr),size_(0),capacity_(0)
+{
+    insert(first,last);
+}
+
+template<class T,class Alloc>
+hive<T,Alloc>::hive(const hive& x)
+  :begin_group(nullptr),end_group(nullptr),erasures_head(nullptr),size_(0),capacity_(0)
+{
+    insert(x.begin(),x.end());
+}
+
+template<class T,class Alloc>
+hive<T,Alloc>::hive(hive&& x)
+  :begin_group(x.begin_group),end_group(x.end_group),erasures_head(x.erasures_head),
+   size_(x.size_),capacity_(x.capacity_)
+{
+    x.begin_group = x.end_group = x.erasures_head = nullptr;
+    x.size_ = x.capacity_ = 0;
+}
+
+template<class T,class Alloc>
+hive<T,Alloc>& hive<T,Alloc>::operator=(const hive& x){
+    if(this != &x){
+        hive tmp(x);
+        swap(tmp);
+    }
+    return *this;
+}
+
+template<class T,class Alloc>
+hive<T,Alloc>& hive<T,Alloc>::operator=(hive&& x){
+    if(this != &x){
+        hive tmp(mjstl::move(x));
+        swap(tmp);
+    }
+    return *this;
+}
+
+template<class T,class Alloc>
+void hive<T,Alloc>::swap(hive& x){
+    mjstl::swap(begin_group,x.begin_group);
+    mjstl::swap(end_group,x.end_group);
+    mjstl::swap(erasures_head,x.erasures_head);
+    mjstl::swap(size_,x.size_);
+    mjstl::swap(capacity_,x.capacity_);
+}
+
+/*
+*   找一个可以构造元素的位置：先复用空位，再用最后一块的剩余空间，
+* 都没有才分配新块，新块容量为当前元素个数(限制在[__HIVE_MIN_GROUP,__HIVE_MAX_GROUP])，
+* 即按几何级数增长。
+*/
+template<class T,class Alloc>
+typename hive<T,Alloc>::skip_type
+hive<T,Alloc>::__acquire_slot(group_pointer& g){
+    if(erasures_head != nullptr){
+        g = erasures_head;
+        const skip_type index = g->free_head;
+        const skip_type len = g->skipfield[index];
+        if(len == 1){
+            __free_list_remove(g,index);
+        }else{
+            /*skipblock从头部缩短一格，free list节点随之后移。*/
+            g->skipfield[index + 1] = g->skipfield[index + len - 1] = len - 1;
+            __free_list_replace(g,index,index + 1);
+        }
+        g->skipfield[index] = 0;
+        return index;
+    }
+    if(end_group == nullptr || end_group->last_endpoint == end_group->capacity){
+        size_type n = size_;
+        if(n < __HIVE_MIN_GROUP) n = __HIVE_MIN_GROUP;
+        if(n > __HIVE_MAX_GROUP) n = __HIVE_MAX_GROUP;
+        group_pointer ng = __create_group(n);
+        ng->prev = end_group;
+        if(end_group != nullptr)
+            end_group->next = ng;
+        else
+            begin_group = ng;
+        end_group = ng;
+    }
+    g = end_group;
+    return g->last_endpoint++;
+}
+
+template<class T,class Alloc>
+template<class ...Args>
+typename hive<T,Alloc>::iterator
+hive<T,Alloc>::emplace(Args&& ...args){
+    group_pointer g = nullptr;
+    const skip_type index = __acquire_slot(g);
+    try{
+        mjstl::construct(g->value(index),mjstl::forward<Args>(args)...);
+    }catch(...){
+        /*构造失败，把刚拿到的位置按删除处理，重新标记为空位。*/
+        ++g->size;
+        ++size_;
+        __erase_slot(g,index);
+        throw;
+    }
+    ++g->size;
+    ++size_;
+    return iterator(g,index);
+}
+
+template<class T,class Alloc>
+void hive<T,Alloc>::insert(size_type n,const T& value){
+    for(; n > 0; --n)
+        emplace(value);
+}
+
+template<class T,class Alloc>
+template<class InputIterator,typename std::enable_if<
+  mjstl::is_input_iterator<InputIterator>::value,int>::type>
+void hive<T,Alloc>::insert(InputIterator first,InputIterator last){
+    for(; first != last; ++first)
+        emplace(*first);
+}
+
+/*
+*   删除position处元素，返回下一个元素的迭代器。
+*   根据左右邻居是否是空位，新建skipblock、向左或向右延长、或者合并两个skipblock，
+* 只需要改动skipblock首尾两个位置。块空了就整块释放。
+*/
+template<class T,class Alloc>
+typename hive<T,Alloc>::iterator
+hive<T,Alloc>::erase(const_iterator position){
+    mjstl::destory(position.group->value(position.index));
+    return __erase_slot(position.group,position.index);
+}
+
+/*
+*   把已析构的index处标记为空位，返回下一个元素的迭代器。
+*   根据左右邻居是否是空位，新建skipblock、向左或向右延长、或者合并两个skipblock，
+* 只需要改动skipblock首尾两个位置。块空了就整块释放。
+*/
+template<class T,class Alloc>
+typename hive<T,Alloc>::iterator
+hive<T,Alloc>::__erase_slot(group_pointer g,skip_type index){
+    --size_;
+    if(--g->size == 0){
+        group_pointer next = g->next;
+        __remove_group(g);
+        if(next == nullptr) return end();
+        return iterator(next,next->skipfield[0]);
+    }
+
+    skip_type* skip = g->skipfield;
+    const skip_type left = index == 0 ? skip_type(0) : skip[index - 1];
+    const skip_type right = skip[index + 1];
+    if(left == 0 && right == 0){
+        skip[index] = 1;
+        __free_list_push(g,index);
+    }else if(right == 0){
+        skip[index - left] = skip[index] = left + 1;
+    }else if(left == 0){
+        skip[index] = skip[index + right] = right + 1;
+        __free_list_replace(g,index + 1,index);
+    }else{
+        skip[index - left] = skip[index + right] = left + right + 1;
+        __free_list_remove(g,index + 1);
+    }
+
+    /*
+    *   不能从index再++，合并后index+1已经不是skipblock的起始位置了，
+    * 所以直接从右邻居之后开始。
+    */
+    iterator it(g,skip_type(index + right + 1));
+    if(it.index == g->last_endpoint && g->next != nullptr)
+        it = iterator(g->next,g->next->skipfield[0]);
+    return it;
+}
+
+/*last为end()时，最后一块可能被整块释放，end()会随之改变，所以每次重新取end()。*/
+template<class T,class Alloc>
+typename hive<T,Alloc>::iterator
+hive<T,Alloc>::erase(const_iterator first,const_iterator last){
+    if(last == end()){
+        while(first != end())
+            first = erase(first);
+        return end();
+    }
+    while(first != last)
+        first = erase(first);
+    return iterator(last.group,last.index);
+}
+
+template<class T,class Alloc>
+void hive<T,Alloc>::clear(){
+    __destory_all();
+}
+
+template<class T,class Alloc>
+typename hive<T,Alloc>::iterator
+hive<T,Alloc>::get_iterator(const_pointer p){
+    for(group_pointer g = begin_group; g != nullptr; g = g->next){
+        const slot_type* s = reinterpret_cast<const slot_type*>(p);
+        if(g->elements <= s && s < g->elements + g->last_endpoint)
+            return iterator(g,skip_type(s - g->elements));
+    }
+    return end();
+}
+
+template<class T,class Alloc>
+typename hive<T,Alloc>::group_pointer
+hive<T,Alloc>::__create_group(size_type capacity){
+    group_pointer g = group_allocator().allocate();
+    try{
+        g->elements = slot_allocator().allocate(capacity);
+        try{
+            g->skipfield = skip_allocator().allocate(capacity + 1);
+        }catch(...){
+            slot_allocator().deallocate(g->elements,capacity);
+            throw;
+        }
+    }catch(...){
+        group_allocator().deallocate(g);
+        throw;
+    }
+    mjstl::fill_n(g->skipfield,capacity + 1,skip_type(0));
+    g->prev = g->next = nullptr;
+    g->erasures_prev = g->erasures_next = nullptr;
+    g->capacity = skip_type(capacity);
+    g->last_endpoint = 0;
+    g->size = 0;
+    g->free_head = group::none;
+    capacity_ += capacity;
+    return g;
+}
+
+template<class T,class Alloc>
+void hive<T,Alloc>::__destory_group(group_pointer g){
+    for(skip_type i = g->skipfield[0]; i < g->last_endpoint; ){
+        mjstl::destory(g->value(i));
+        ++i;
+        i += g->skipfield[i];
+    }
+    capacity_ -= g->capacity;
+    skip_allocator().deallocate(g->skipfield,g->capacity + 1);
+    slot_allocator().deallocate(g->elements,g->capacity);
+    group_allocator().deallocate(g);
+}
+
+template<class T,class Alloc>
+void hive<T,Alloc>::__destory_all(){
+    while(begin_group != nullptr){
+        group_pointer next = begin_group->next;
+        __destory_group(begin_group);
+        begin_group = next;
+    }
+    end_group = erasures_head = nullptr;
+    size_ = 0;
+}
+
+/*把空了的块从块链表、空位链表摘下并释放。*/
+template<class T,class Alloc>
+void hive<T,Alloc>::__remove_group(group_pointer g){
+    if(g->free_head != group::none)
+        __remove_erasures(g);
+    if(g->prev != nullptr) g->prev->next = g->next;
+    else begin_group = g->next;
+    if(g->next != nullptr) g->next->prev = g->prev;
+    else end_group = g->prev;
+    /*元素已全部析构，只释放内存。*/
+    g->last_endpoint = 0;
+    __destory_group(g);
+}
+
+template<class T,class Alloc>
+void hive<T,Alloc>::__add_erasures(group_pointer g){
+    g->erasures_prev = nullptr;
+    g->erasures_next = erasures_head;
+    if(erasures_head != nullptr)
+        erasures_head->erasures_prev = g;
+    erasures_head = g;
+}
+
+template<class T,class Alloc>
+void hive<T,Alloc>::__remove_erasures(group_pointer g){
+    if(g->erasures_prev != nullptr) g->erasures_prev->erasures_next = g->erasures_next;
+    else erasures_head = g->erasures_next;
+    if(g->erasures_next != nullptr) g->erasures_next->erasures_prev = g->erasures_prev;
+}
+
+template<class T,class Alloc>
+void hive<T,Alloc>::__free_list_push(group_pointer g,skip_type index){
+    typename group::free_link* l = g->link(index);
+    l->prev = group::none;
+    l->next = g->free_head;
+    if(g->free_head != group::none)
+        g->link(g->free_head)->prev = index;
+    else
+        __add_erasures(g);
+    g->free_head = index;
+}
+
+template<class T,class Alloc>
+void hive<T,Alloc>::__free_list_remove(group_pointer g,skip_type index){
+    typename group::free_link* l = g->link(index);
+    if(l->prev != group::none) g->link(l->prev)->next = l->next;
+    else g->free_head = l->next;
+    if(l->next != group::none) g->link(l->next)->prev = l->prev;
+    if(g->free_head == group::none)
+        __remove_erasures(g);
+}
+
+/*skipblock的起始位置由old_index变为new_index，free list节点跟着挪过去。*/
+template<class T,class Alloc>
+void hive<T,Alloc>::__free_list_replace(group_pointer g,skip_type old_index,skip_type new_index){
+    typename group::free_link l = *g->link(old_index);
+    *g->link(new_index) = l;
+    if(l.prev != group::none) g->link(l.prev)->next = new_index;
+    else g->free_head = new_index;
+    if(l.next != group::none) g->link(l.next)->prev = new_index;
+}
+
+template<class T,class Alloc>
+inline void swap(hive<T,Alloc>& x,hive<T,Alloc>& y){
+    x.swap(y);
+}
+
+} // namespace mjstl
+#endif// !__HIVE_H__
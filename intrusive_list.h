@@ -0,0 +1,335 @@
+#ifndef __INTRUSIVE_LIST_H__
+#define __INTRUSIVE_LIST_H__
+
+#include "list.h"
+#include "util.h"
+
+namespace mjstl
+{
+    /*
+    *   intrusive_list：侵入式双向链表。
+    *   prev、next放在元素自己的list_hook成员里，链表只把已有的对象串起来，
+    * 不申请节点、不拷贝元素，也不拥有元素：对象的生命周期由使用者(比如对象池)管理。
+    *   链表算法(splice用的__list_transfer、merge、sort)和list共用list.h里的实现。
+    *
+    *   list_hook：对象在链表里时，可以直接x.hook.unlink()在O(1)内把自己摘下来，
+    * 不需要知道它在哪条链表上。所以链表不记录元素个数，size()是O(n)的，empty()是O(1)的。
+    *   auto_unlink_list_hook：析构时如果还在链表里就自动摘下，对象销毁前不必先erase。
+    *   拷贝对象不会拷贝链表关系，新对象的hook总是未链接的。
+    *
+    *   用法：
+    *     struct conn{ int fd; mjstl::list_hook hook;};
+    *     mjstl::intrusive_list<conn,&conn::hook> l;
+    */
+    struct __list_hook_node{
+        __list_hook_node* prev;
+        __list_hook_node* next;
+    };
+
+    template<bool AutoUnlink>
+    struct basic_list_hook : public __list_hook_node{
+        basic_list_hook(){ prev = next = nullptr;}
+        basic_list_hook(const basic_list_hook&){ prev = next = nullptr;}
+        basic_list_hook& operator=(const basic_list_hook&){ return *this;}
+        ~basic_list_hook(){ if(AutoUnlink) unlink();}
+
+        bool is_linked() const { return next != nullptr;}
+        void unlink(){
+            if(next == nullptr) return;
+            prev->next = next;
+            next->prev = prev;
+            prev = next = nullptr;
+        }
+    };
+
+    typedef basic_list_hook<false>  list_hook;
+    typedef basic_list_hook<true>   auto_unlink_list_hook;
+
+    template<class T,class Hook,Hook T::*Member,class Ref,class Ptr>
+    struct __intrusive_list_iterator : public iterator<bidirectional_iterator_tag,T>{
+        typedef __intrusive_list_iterator<T,Hook,Member,T&,T*>              iterator;
+        typedef __intrusive_list_iterator<T,Hook,Member,const T&,const T*>  const_iterator;
+        typedef __intrusive_list_iterator<T,Hook,Member,Ref,Ptr>            self;
+
+        typedef T value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        __list_hook_node* node;
+
+        __intrusive_list_iterator():node(nullptr){}
+        explicit __intrusive_list_iterator(__list_hook_node* x):node(x){}
+        __intrusive_list_iterator(const iterator& x):node(x.node){}
+
+        bool operator==(const self& x) const { return node == x.node;}
+        bool operator!=(const self& x) const { return node != x.node;}
+        reference operator*() const { return *__hook_owner(static_cast<Hook*>(node),Member);}
+        pointer operator->() const { return &(operator*());}
+        self& operator++(){
+            node = node->next;
+            return *this;
+        }
+        self operator++(int){
+            self tmp = *this;
+            node = node->next;
+            return tmp;
+        }
+        self& operator--(){
+            node = node->prev;
+            return *this;
+        }
+        self operator--(int){
+            self tmp = *this;
+            node = node->prev;
+            return tmp;
+        }
+    };
+
+    /*用元素的比较器comp比较两个hook节点。*/
+    template<class T,class Hook,Hook T::*Member,class Compare>
+    struct __intrusive_list_compare{
+        Compare* comp;
+
+        explicit __intrusive_list_compare(Compare& c):comp(&c){}
+        bool operator()(const __list_hook_node* a,const __list_hook_node* b) const {
+            return (*comp)(*__hook_owner(static_cast<Hook*>(const_cast<__list_hook_node*>(a)),Member),
+                *__hook_owner(static_cast<Hook*>(const_cast<__list_hook_node*>(b)),Member));
+        }
+    };
+
+    template<class T,class Hook,Hook T::*Member>
+    class basic_intrusive_list{
+    public:
+        typedef T                       value_type;
+        typedef Hook                    hook_type;
+        typedef value_type*             pointer;
+        typedef const value_type*       const_pointer;
+        typedef value_type&             reference;
+        typedef const value_type&       const_reference;
+        typedef size_t                  size_type;
+        typedef ptrdiff_t               difference_type;
+
+        typedef __intrusive_list_iterator<T,Hook,Member,T&,T*>              iterator;
+        typedef __intrusive_list_iterator<T,Hook,Member,const T&,const T*>  const_iterator;
+        typedef mjstl::reverse_iterator<iterator>                           reverse_iterator;
+        typedef mjstl::reverse_iterator<const_iterator>                     const_reverse_iterator;
+
+    protected:
+        typedef __list_hook_node*       link_type;
+
+        /*哨兵，首尾相接。*/
+        __list_hook_node node_;
+
+    public:
+        basic_intrusive_list(){ node_.prev = node_.next = &node_;}
+        template<class InputIterator>
+        basic_intrusive_list(InputIterator first,InputIterator last);
+        basic_intrusive_list(basic_intrusive_list&& x);
+        basic_intrusive_list& operator=(basic_intrusive_list&& x);
+
+        basic_intrusive_list(const basic_intrusive_list&) = delete;
+        basic_intrusive_list& operator=(const basic_intrusive_list&) = delete;
+
+        /*只把元素摘下来，不销毁。*/
+        ~basic_intrusive_list(){ clear();}
+
+    public:
+        iterator begin(){ return iterator(node_.next);}
+        const_iterator begin() const { return const_iterator(node_.next);}
+        iterator end(){ return iterator(&node_);}
+        const_iterator end() const { return const_iterator(const_cast<link_type>(&node_));}
+        reverse_iterator rbegin(){ return reverse_iterator(end());}
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end());}
+        reverse_iterator rend(){ return reverse_iterator(begin());}
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin());}
+
+        /*已经链接在某条链表上的元素x的迭代器。*/
+        static iterator iterator_to(reference x){ return iterator(&(x.*Member));}
+        static const_iterator iterator_to(const_reference x){
+            return const_iterator(const_cast<link_type>(static_cast<const __list_hook_node*>(&(x.*Member))));
+        }
+
+        reference front(){ return *begin();}
+        const_reference front() const { return *begin();}
+        reference back(){ return *(--end());}
+        const_reference back() const { return *(--end());}
+        bool empty() const { return node_.next == &node_;}
+        size_type size() const { return (size_type)mjstl::distance(begin(),end());}
+
+        /*x不能已经在某条链表上。*/
+        iterator insert(iterator position,reference x);
+        template<class InputIterator>
+        void insert(iterator position,InputIterator first,InputIterator last);
+        void push_front(reference x){ insert(begin(),x);}
+        void push_back(reference x){ insert(end(),x);}
+
+        iterator erase(iterator position);
+        iterator erase(iterator first,iterator last);
+        void erase(reference x){ (x.*Member).unlink();}
+        void pop_front(){ erase(begin());}
+        void pop_back(){ erase(--end());}
+        void clear(){ erase(begin(),end());}
+        void swap(basic_intrusive_list& x);
+
+        void splice(iterator position,basic_intrusive_list& x){
+            if(!x.empty())
+                __list_transfer(position.node,x.node_.next,&x.node_);
+        }
+        void splice(iterator position,basic_intrusive_list&,iterator it){
+            iterator next = it;
+            ++next;
+            if(position == it || position == next) return;
+            __list_transfer(position.node,it.node,next.node);
+        }
+        void splice(iterator position,basic_intrusive_list&,iterator first,iterator last){
+            if(first != last)
+                __list_transfer(position.node,first.node,last.node);
+        }
+        template<class Predicate>
+        void remove_if(Predicate pred);
+        void merge(basic_intrusive_list& x){ merge(x,__list_less<T>());}
+        template<class Compare>
+        void merge(basic_intrusive_list& x,Compare comp);
+        void sort(){ sort(__list_less<T>());}
+        template<class Compare>
+        void sort(Compare comp);
+        void reverse();
+
+    protected:
+        void __take(basic_intrusive_list& x);
+    };
+
+    template<class T,list_hook T::*Member>
+    using intrusive_list = basic_intrusive_list<T,list_hook,Member>;
+
+    template<class T,auto_unlink_list_hook T::*Member>
+    using auto_unlink_intrusive_list = basic_intrusive_list<T,auto_unlink_list_hook,Member>;
+
+template<class T,class Hook,Hook T::*Member>
+template<class InputIterator>
+basic_intrusive_list<T,Hook,Member>::basic_intrusive_list(InputIterator first,InputIterator last){
+    node_.prev = node_.next = &node_;
+    insert(end(),first,last);
+}
+
+template<class T,class Hook,Hook T::*Member>
+basic_intrusive_list<T,Hook,Member>::basic_intrusive_list(basic_intrusive_list&& x){
+    node_.prev = node_.next = &node_;
+    __take(x);
+}
+
+template<class T,class Hook,Hook T::*Member>
+basic_intrusive_list<T,Hook,Member>&
+basic_intrusive_list<T,Hook,Member>::operator=(basic_intrusive_list&& x){
+    if(this != &x){
+        clear();
+        __take(x);
+    }
+    return *this;
+}
+
+template<class T,class Hook,Hook T::*Member>
+typename basic_intrusive_list<T,Hook,Member>::iterator
+basic_intrusive_list<T,Hook,Member>::insert(iterator position,reference x){
+    link_type tmp = &(x.*Member);
+    link_type next = position.node;
+    link_type prev = next->prev;
+    tmp->next = next;
+    tmp->prev = prev;
+    prev->next = tmp;
+    next->prev = tmp;
+    return iterator(tmp);
+}
+
+/*[first,last)是元素的迭代器，依次链接这些对象本身。*/
+template<class T,class Hook,Hook T::*Member>
+template<class InputIterator>
+void basic_intrusive_list<T,Hook,Member>::insert(iterator position,InputIterator first,InputIterator last){
+    for(; first != last; ++first)
+        insert(position,*first);
+}
+
+template<class T,class Hook,Hook T::*Member>
+typename basic_intrusive_list<T,Hook,Member>::iterator
+basic_intrusive_list<T,Hook,Member>::erase(iterator position){
+    link_type next = position.node->next;
+    static_cast<Hook*>(position.node)->unlink();
+    return iterator(next);
+}
+
+template<class T,class Hook,Hook T::*Member>
+typename basic_intrusive_list<T,Hook,Member>::iterator
+basic_intrusive_list<T,Hook,Member>::erase(iterator first,iterator last){
+    while(first != last)
+        first = erase(first);
+    return last;
+}
+
+template<class T,class Hook,Hook T::*Member>
+void basic_intrusive_list<T,Hook,Member>::swap(basic_intrusive_list& x){
+    if(this == &x) return;
+    basic_intrusive_list tmp(mjstl::move(x));
+    x.__take(*this);
+    __take(tmp);
+}
+
+template<class T,class Hook,Hook T::*Member>
+template<class Predicate>
+void basic_intrusive_list<T,Hook,Member>::remove_if(Predicate pred){
+    iterator first = begin();
+    iterator last = end();
+    while(first != last){
+        if(pred(*first))
+            first = erase(first);
+        else
+            ++first;
+    }
+}
+
+template<class T,class Hook,Hook T::*Member>
+template<class Compare>
+void basic_intrusive_list<T,Hook,Member>::merge(basic_intrusive_list& x,Compare comp){
+    if(this == &x) return;
+    __intrusive_list_compare<T,Hook,Member,Compare> c(comp);
+    __list_merge(&node_,&x.node_,c);
+}
+
+/*链表不记录长度，先数一遍，用来决定是否走指针数组排序。*/
+template<class T,class Hook,Hook T::*Member>
+template<class Compare>
+void basic_intrusive_list<T,Hook,Member>::sort(Compare comp){
+    __intrusive_list_compare<T,Hook,Member,Compare> c(comp);
+    __list_sort(&node_,size(),c);
+}
+
+template<class T,class Hook,Hook T::*Member>
+void basic_intrusive_list<T,Hook,Member>::reverse(){
+    link_type p = &node_;
+    do{
+        link_type next = p->next;
+        p->next = p->prev;
+        p->prev = next;
+        p = next;
+    }while(p != &node_);
+}
+
+/*把x的整条链挂到本链表(必须为空)的哨兵上，x变为空。*/
+template<class T,class Hook,Hook T::*Member>
+void basic_intrusive_list<T,Hook,Member>::__take(basic_intrusive_list& x){
+    if(x.empty()) return;
+    node_.next = x.node_.next;
+    node_.prev = x.node_.prev;
+    node_.next->prev = &node_;
+    node_.prev->next = &node_;
+    x.node_.prev = x.node_.next = &x.node_;
+}
+
+template<class T,class Hook,Hook T::*Member>
+inline void swap(basic_intrusive_list<T,Hook,Member>& x,basic_intrusive_list<T,Hook,Member>& y){
+    x.swap(y);
+}
+
+} // namespace mjstl
+#endif // !__INTRUSIVE_LIST_H__
@@ -5,6 +5,10 @@
 #define USE_CSTDDEF
 #include <cstddef>
 #endif // !USE_CSTDDEF
+
+#include <type_traits>
+#include "type_traits.h"
+
 namespace mjstl
 {
     struct input_iterator_tag{};
@@ -207,5 +211,20 @@ namespace mjstl
     struct is_iterator : public m_bool_constant<is_input_iterator<Iter>::value ||
         is_output_iterator<Iter>::value>{};
 
+    /*
+    *   分段迭代器协议：由若干段连续内存组成的容器(如deque)可以为其迭代器特化此模板，
+    * 算法据此把[first,last)拆成逐段的连续区间，段内直接用指针处理(memmove、memset等)。
+    *   特化需提供：
+    *   is_segmented_iterator：__true_type。
+    *   segment_iterator：遍历各段的迭代器；local_iterator：段内迭代器。
+    *   segment(it)、local(it)：it所在的段及段内位置。
+    *   begin(seg)、end(seg)：段的连续区间[begin,end)。
+    *   compose(seg,local)：由段和段内位置合成原迭代器，local可以等于end(seg)。
+    */
+    template<class Iterator>
+    struct __segmented_iterator_traits{
+        typedef __false_type is_segmented_iterator;
+    };
+
 } // namespace mjstl
 #endif// !__ITERATOR_H__
\ No newline at end of file
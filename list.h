@@ -1,9 +1,13 @@
 #ifndef __LIST_H__
 #define __LIST_H__
 
+#include <cstdint>
+#include <type_traits>
+
 #include "iterator.h"
 #include "reverse_iterator.h"
 #include "memory.h"
+#include "algo.h"
 
 namespace mjstl
 {
@@ -20,6 +24,238 @@ namespace mjstl
             __list_node<T>* n = nullptr):data(value),prev(p),next(n){}
     };
 
+    /*
+    *   list::sort节点数达到这个值时，改用指针数组排序：把节点指针收集到临时数组里，
+    * 用随机访问的mjstl::sort排好，再一次性重新连接。
+    *   链表归并每一趟都要沿next逐个访问节点，下一个地址要等上一个节点载入才知道，
+    * 链表很长、节点散落在堆上时几乎每一步都是缓存缺失。指针数组是连续的，
+    * 比较时要访问的节点地址提前就知道，CPU可以同时发出多个访存。
+    *   几十万个节点以下两者差不多，而临时数组是一次大块malloc，glibc会先把fastbin里
+    * 攒下的小块全部合并，这笔开销可能比排序本身还大，所以门槛定得比较高。
+    */
+    enum { __LIST_SORT_ARRAY_MIN = 1 << 18 };
+
+    /*
+    *   sort()默认的比较。不用std::less：比较器的模板参数带上std，
+    * algo.h里不加限定的调用会经ADL找到libstdc++的同名内部函数，产生二义性。
+    */
+    template<class T>
+    struct __list_less{
+        bool operator()(const T& a,const T& b) const { return a < b;}
+    };
+
+    /*用元素的比较器comp比较两个list节点。*/
+    template<class T,class Compare>
+    struct __list_data_compare{
+        Compare* comp;
+
+        explicit __list_data_compare(Compare& c):comp(&c){}
+        bool operator()(const __list_node<T>* a,const __list_node<T>* b) const {
+            return (*comp)(a->data,b->data);
+        }
+    };
+
+    /*比较节点指针，相等时按prev里暂存的原始序号比较，保证排序稳定。*/
+    template<class Node,class NodeCompare>
+    struct __list_stable_compare{
+        NodeCompare* comp;
+
+        explicit __list_stable_compare(NodeCompare& c):comp(&c){}
+        bool operator()(const Node* a,const Node* b) const {
+            if((*comp)(a,b)) return true;
+            if((*comp)(b,a)) return false;
+            return (std::uintptr_t)a->prev < (std::uintptr_t)b->prev;
+        }
+    };
+
+    /*
+    *   下面的链表算法只读写节点的prev、next，list和intrusive_list共用。
+    *   Node是节点类型，sentinel是首尾相接的哨兵节点，NodeCompare比较两个节点指针。
+    */
+
+    /*将[first,last)接合于position之前，first、last可以属于另一条链表。*/
+    template<class Node>
+    void __list_transfer(Node* position,Node* first,Node* last){
+        if(position == last) return;
+        /*
+        *   草率用 endit = --last; 后面还需要last不妥。
+        * 然后想到last不能变用后缀--，endit = last--，这样
+        * endit就不是last的前一个结点了，没作用。写糊涂了。
+        * 只能用 endit = last->prev;
+        */
+        Node* endit = last->prev;
+        /*先把[first,last)取下来，再缝合first前面后last元素。*/
+        first->prev->next = last;
+        last->prev = first->prev;
+        /*将[first,last)插入position前面*/
+        endit->next = position;
+        first->prev = position->prev;
+        first->prev->next = first;
+        position->prev = endit;
+    }
+
+    /*把first开始、以nullptr结尾的单链重新接回sentinel，同时补上prev。*/
+    template<class Node>
+    void __list_relink(Node* sentinel,Node* first){
+        Node* prev = sentinel;
+        for(; first != nullptr; first = first->next){
+            prev->next = first;
+            first->prev = prev;
+            prev = first;
+        }
+        prev->next = sentinel;
+        sentinel->prev = prev;
+    }
+
+    /*
+    *   a、b是两条已排好序、以nullptr结尾的单链(只看next)，归并结果放回a。
+    *   相等时a的元素在前，所以a必须是原序列中靠前的那一段。
+    *   comp抛出异常时，已归并的部分、a和b剩下的部分首尾相接放回a，不丢节点。
+    */
+    template<class Node,class NodeCompare>
+    void __list_merge_links(Node*& a,Node* b,NodeCompare& comp){
+        Node* head = nullptr;
+        Node** tail = &head;
+        Node* x = a;
+        try{
+            while(x != nullptr && b != nullptr){
+                if(comp(b,x)){
+                    *tail = b;
+                    tail = &b->next;
+                    b = b->next;
+                }else{
+                    *tail = x;
+                    tail = &x->next;
+                    x = x->next;
+                }
+            }
+        }catch(...){
+            *tail = x;
+            while(*tail != nullptr) tail = &(*tail)->next;
+            *tail = b;
+            a = head;
+            throw;
+        }
+        *tail = x != nullptr ? x : b;
+        a = head;
+    }
+
+    /*
+    *   和原来的二进制进位归并一样：counter[i]存放2^i个元素的有序段，
+    * 只是直接用节点指针串成单链，不再为carry、counter构造带哨兵的临时list。
+    *   counter[i]里的元素总是比carry、counter[i-1]的早，归并时放在a的位置，保证稳定。
+    */
+    template<class Node,class NodeCompare>
+    void __list_sort_links(Node* sentinel,NodeCompare& comp){
+        Node* rest = sentinel->next;
+        sentinel->prev->next = nullptr;
+        Node* counter[64] = { nullptr };
+        int fill = 0;
+        try{
+            while(rest != nullptr){
+                Node* carry = rest;
+                rest = rest->next;
+                carry->next = nullptr;
+                int i = 0;
+                for(; i < fill && counter[i] != nullptr; ++i){
+                    __list_merge_links(counter[i],carry,comp);
+                    carry = counter[i];
+                    counter[i] = nullptr;
+                }
+                counter[i] = carry;
+                if(i == fill) ++fill;
+            }
+            for(int i = 1; i < fill; ++i){
+                Node* b = counter[i - 1];
+                counter[i - 1] = nullptr;
+                __list_merge_links(counter[i],b,comp);
+            }
+        }catch(...){
+            /*把各段和还没处理的节点重新串起来，保证链表完整。*/
+            Node* head = rest;
+            for(int i = 0; i < fill; ++i){
+                Node* p = counter[i];
+                if(p == nullptr) continue;
+                while(p->next != nullptr) p = p->next;
+                p->next = head;
+                head = counter[i];
+            }
+            __list_relink(sentinel,head);
+            throw;
+        }
+        __list_relink(sentinel,counter[fill - 1]);
+    }
+
+    /*
+    *   指针数组排序，n是节点个数。节点的prev暂时用来存原始序号，供__list_stable_compare打破相等；
+    * next在排序过程中不动，comp抛出异常时沿next把链表恢复原样。
+    *   临时数组不够大时返回false。
+    */
+    template<class Node,class NodeCompare>
+    bool __list_sort_array(Node* sentinel,size_t n,NodeCompare& comp){
+        pair<Node**,ptrdiff_t> buf = mjstl::get_temporary_buffer<Node*>((ptrdiff_t)n);
+        if(buf.second < (ptrdiff_t)n){
+            if(buf.first != nullptr) mjstl::return_temporary_buffer(buf.first);
+            return false;
+        }
+        Node** v = buf.first;
+        size_t i = 0;
+        for(Node* p = sentinel->next; p != sentinel; p = p->next, ++i){
+            v[i] = p;
+            p->prev = (Node*)(std::uintptr_t)i;
+        }
+        try{
+            mjstl::sort(v,v + n,__list_stable_compare<Node,NodeCompare>(comp));
+        }catch(...){
+            sentinel->prev->next = nullptr;
+            __list_relink(sentinel,sentinel->next);
+            mjstl::return_temporary_buffer(v);
+            throw;
+        }
+        Node* prev = sentinel;
+        for(i = 0; i < n; ++i){
+            prev->next = v[i];
+            v[i]->prev = prev;
+            prev = v[i];
+        }
+        prev->next = sentinel;
+        sentinel->prev = prev;
+        mjstl::return_temporary_buffer(v);
+        return true;
+    }
+
+    /*
+    *   稳定排序，不申请任何临时节点。
+    *   短链表直接在节点上做自底向上的归并；长链表先尝试指针数组排序，
+    * 临时数组申请不到时退回链表归并。
+    */
+    template<class Node,class NodeCompare>
+    void __list_sort(Node* sentinel,size_t n,NodeCompare& comp){
+        if(n < 2) return;
+        if(n >= __LIST_SORT_ARRAY_MIN && __list_sort_array(sentinel,n,comp)) return;
+        __list_sort_links(sentinel,comp);
+    }
+
+    /*
+    *   把other链表上的节点按序归并进sentinel链表，相等时sentinel的元素在前。
+    *   逐个节点搬移，comp抛出异常时两条链表都是完整的。
+    */
+    template<class Node,class NodeCompare>
+    void __list_merge(Node* sentinel,Node* other,NodeCompare& comp){
+        Node* first1 = sentinel->next;
+        Node* first2 = other->next;
+        while(first1 != sentinel && first2 != other){
+            if(comp(first2,first1)){
+                Node* next = first2->next;
+                __list_transfer(first1,first2,next);
+                first2 = next;
+            }else
+                first1 = first1->next;
+        }
+        if(first2 != other)
+            __list_transfer(sentinel,first2,other);
+    }
+
     /*iteartor*/
     template<class T,class Ref,class Ptr>
     struct __list_iterator : public iterator<bidirectional_iterator_tag,T>{
@@ -70,8 +306,142 @@ namespace mjstl
         }
     };
 
+    /*
+    *   list的第二个模板参数传list_slab<SlabNodes>时，节点从这个list自己的slab里分配：
+    * 每块slab连续存放SlabNodes个节点，新节点按地址递增依次切出，
+    * 删除的节点挂回本list的空闲链表，list析构时整块释放。
+    *   默认情况下节点来自全局的mjstl::allocator，和其他容器共用空闲链表，
+    * 长期运行后一条list的节点散落在堆上；用slab时节点集中在少数几块连续内存里。
+    *   哨兵节点不从slab分配，所以整条链表接合给别的list时，可以连同slab一起交出去。
+    *   slab的节点只属于一个list：splice(position,x)整个接合、merge时把x的slab整体并入本list；
+    * 从另一个list接合单个元素或一段元素时，只能逐个move构造到本list的节点上，
+    * 代价O(n)，被接合元素原来的迭代器失效。
+    */
+    template<size_t SlabNodes = 64>
+    struct list_slab{};
+
+    /*默认的节点来源：全局分配器。*/
+    template<class T,class Alloc>
+    class __list_node_pool{
+    protected:
+        typedef __list_node<T>*                     link_type;
+        typedef mjstl::allocator<__list_node<T>>    node_allocator;
+        enum { __shared_pool = 1 };
+
+        link_type __get_node(){ return node_allocator::allocate();}
+        void __put_node(link_type p){ node_allocator::deallocate(p);}
+        void __swap_pool(__list_node_pool&){}
+        void __adopt_pool(__list_node_pool&){}
+        void __sort_free(){}
+    };
+
+    template<class T,size_t SlabNodes>
+    class __list_node_pool<T,list_slab<SlabNodes>>{
+    protected:
+        typedef __list_node<T>*                     link_type;
+        typedef typename std::aligned_storage<sizeof(__list_node<T>),
+            alignof(__list_node<T>)>::type          node_storage;
+        struct slab{
+            slab* next;
+            node_storage nodes[SlabNodes];
+        };
+        typedef simple_alloc<slab,alloc>            slab_allocator;
+        enum { __shared_pool = 0 };
+
+        slab* slabs_;
+        link_type free_;    /*归还的节点，经next串成单链表。*/
+        size_t unused_;     /*slabs_第一块里还没切出去的节点数。*/
+
+        __list_node_pool():slabs_(nullptr),free_(nullptr),unused_(0){}
+        __list_node_pool(__list_node_pool&& x)
+          :slabs_(x.slabs_),free_(x.free_),unused_(x.unused_){
+            x.slabs_ = nullptr;
+            x.free_ = nullptr;
+            x.unused_ = 0;
+        }
+        __list_node_pool(const __list_node_pool&) = delete;
+        __list_node_pool& operator=(const __list_node_pool&) = delete;
+        ~__list_node_pool(){
+            while(slabs_ != nullptr){
+                slab* next = slabs_->next;
+                slab_allocator().deallocate(slabs_);
+                slabs_ = next;
+            }
+        }
+
+        link_type __get_node(){
+            if(free_ != nullptr){
+                link_type p = free_;
+                free_ = free_->next;
+                return p;
+            }
+            if(unused_ == 0){
+                slab* s = slab_allocator().allocate();
+                s->next = slabs_;
+                slabs_ = s;
+                unused_ = SlabNodes;
+            }
+            return reinterpret_cast<link_type>(&slabs_->nodes[SlabNodes - unused_--]);
+        }
+        void __put_node(link_type p){
+            p->next = free_;
+            free_ = p;
+        }
+        void __swap_pool(__list_node_pool& x){
+            mjstl::swap(slabs_,x.slabs_);
+            mjstl::swap(free_,x.free_);
+            mjstl::swap(unused_,x.unused_);
+        }
+        void __adopt_pool(__list_node_pool& x);
+        void __sort_free();
+    };
+
+/*接管x的全部slab，x里没切出去的节点先挂到x的空闲链表上，再并入本pool的空闲链表。*/
+template<class T,size_t SlabNodes>
+void __list_node_pool<T,list_slab<SlabNodes>>::__adopt_pool(__list_node_pool& x){
+    if(x.slabs_ == nullptr) return;
+    for(; x.unused_ > 0; --x.unused_)
+        x.__put_node(reinterpret_cast<link_type>(&x.slabs_->nodes[SlabNodes - x.unused_]));
+    slab* last = x.slabs_;
+    while(last->next != nullptr) last = last->next;
+    if(slabs_ == nullptr){
+        slabs_ = x.slabs_;
+    }else{
+        /*接在第一块之后，第一块还要继续切节点。*/
+        last->next = slabs_->next;
+        slabs_->next = x.slabs_;
+    }
+    if(x.free_ != nullptr){
+        link_type tail = x.free_;
+        while(tail->next != nullptr) tail = tail->next;
+        tail->next = free_;
+        free_ = x.free_;
+    }
+    x.slabs_ = nullptr;
+    x.free_ = nullptr;
+}
+
+/*空闲链表按地址递增重排，之后新插入的节点先用低地址。临时数组申请不到时不排。*/
+template<class T,size_t SlabNodes>
+void __list_node_pool<T,list_slab<SlabNodes>>::__sort_free(){
+    ptrdiff_t n = 0;
+    for(link_type p = free_; p != nullptr; p = p->next) ++n;
+    if(n < 2) return;
+    pair<link_type*,ptrdiff_t> buf = get_temporary_buffer<link_type>(n);
+    if(buf.second == n){
+        link_type* a = buf.first;
+        ptrdiff_t i = 0;
+        for(link_type p = free_; p != nullptr; p = p->next) a[i++] = p;
+        mjstl::sort(a,a + n);
+        for(i = 0; i + 1 < n; ++i) a[i]->next = a[i + 1];
+        a[n - 1]->next = nullptr;
+        free_ = a[0];
+    }
+    return_temporary_buffer(buf.first);
+}
+
     template<class T,class Alloc = simple_alloc<__list_node<T>>>
-    class list{
+    class list : protected __list_node_pool<T,Alloc>{
     public:
         typedef T                       value_type;
         typedef Alloc                   allocate_type;
@@ -93,6 +463,8 @@ namespace mjstl
         typedef __list_node<T>* link_type;
 
     protected:
+        typedef __list_node_pool<T,Alloc> pool_type;
+
         link_type node;
         size_type size_;
     public:
@@ -140,8 +512,9 @@ namespace mjstl
         template<class InputIterator,typename std::enable_if<
             mjstl::is_input_iterator<InputIterator>::value,int>::type = 0>
         void assign(InputIterator first,InputIterator last);
-        iterator insert(iterator position,const T& x);
-        iterator insert(iterator position){ return insert(position,T());}
+        iterator insert(iterator position,const T& x){ return emplace(position,x);}
+        iterator insert(iterator position,T&& x){ return emplace(position,mjstl::move(x));}
+        iterator insert(iterator position){ return emplace(position);}
         void insert(iterator position,size_type n,const T& value);
         template<class InputIterator,typename std::enable_if<
             mjstl::is_input_iterator<InputIterator>::value,int>::type = 0>
@@ -149,15 +522,27 @@ namespace mjstl
         iterator erase(iterator position);
         iterator erase(iterator first,iterator last);
         void clear();
-        void push_front(const T& x){ insert(begin(),x);}
-        void push_front(){ insert(begin());}
-        void push_back(const T& x){ insert(end(),x);}
-        void push_back(){ insert(end());}
+        template<class ...Args>
+        iterator emplace(iterator position,Args&& ...args);
+        template<class ...Args>
+        void emplace_front(Args&& ...args){ emplace(begin(),mjstl::forward<Args>(args)...);}
+        template<class ...Args>
+        void emplace_back(Args&& ...args){ emplace(end(),mjstl::forward<Args>(args)...);}
+        void push_front(const T& x){ emplace(begin(),x);}
+        void push_front(T&& x){ emplace(begin(),mjstl::move(x));}
+        void push_front(){ emplace(begin());}
+        void push_back(const T& x){ emplace(end(),x);}
+        void push_back(T&& x){ emplace(end(),mjstl::move(x));}
+        void push_back(){ emplace(end());}
         void pop_front(){ erase(begin());}
         void pop_back(){ auto tmp = end(); erase(--tmp);}
         void resize(size_type new_size,const T& x);
         void resize(size_type new_size){ return resize(new_size,T());}
-        void swap(list& x){ mjstl::swap(node,x.node); mjstl::swap(size_,x.size_); }
+        void swap(list& x){
+            mjstl::swap(node,x.node);
+            mjstl::swap(size_,x.size_);
+            pool_type::__swap_pool(x);
+        }
 
         /*container operation*/
         void splice(iterator position,list& x);
@@ -167,15 +552,23 @@ namespace mjstl
         template<class Predicate>
         void remove_if(Predicate pred);
         void unique();
-        void merge(list& x);
-        void sort();
+        void merge(list& x){ merge(x,__list_less<T>());}
+        template<class Compare>
+        void merge(list& x,Compare comp);
+        void sort(){ sort(__list_less<T>());}
+        template<class Compare>
+        void sort(Compare comp);
         void reverse();
+        void compact();
 
         /*about allocator*/
         allocate_type get_allcate(){ return allocate_type();}
 
     protected:
-        link_type __create_node(const T& x = T());
+        link_type __get_node(){ return pool_type::__get_node();}
+        void __put_node(link_type p){ pool_type::__put_node(p);}
+        template<class ...Args>
+        link_type __create_node(Args&& ...args);
         void __destory_node(link_type p);
         void __initialize();
         void __fill_assign(size_type n,const T& value);
@@ -189,7 +582,9 @@ namespace mjstl
         template<class InputIterator>
         void __insert_dispatch(iterator position,InputIterator first,
             InputIterator last,__false_type);
-        void __transfer(iterator position,iterator first,iterator last);
+        void __transfer(iterator position,iterator first,iterator last){
+            __list_transfer(position.node,first.node,last.node);
+        }
     };
 
 template<class T,class Alloc>
@@ -226,7 +621,7 @@ list<T,Alloc>::list(const list<T,Alloc>& x){
 
 template<class T,class Alloc>
 list<T,Alloc>::list(list<T,Alloc>&& x)
-  :node(x.node),size_(x.size_)
+  :pool_type(mjstl::move(x)),node(x.node),size_(x.size_)
 {
     x.node = nullptr;
     x.size_ = 0;
@@ -269,7 +664,7 @@ list<T,Alloc>::~list(){
         first = first->next;
         __destory_node(cur);
     }
-    __destory_node(node);
+    data_allocator::deallocate(node);
     node = nullptr;
 }
 
@@ -280,11 +675,12 @@ void list<T,Alloc>::assign(InputIterator first,InputIterator last){
     __assign_dispatch(first,last,__false_type());
 }
 
-/* position位置插入一个元素x。*/
+/* position位置插入一个用args就地构造的元素。*/
 template<class T,class Alloc>
+template<class ...Args>
 typename list<T,Alloc>::iterator 
-list<T,Alloc>::insert(iterator position,const T& x){
-    link_type tmp = __create_node(x);
+list<T,Alloc>::emplace(iterator position,Args&& ...args){
+    link_type tmp = __create_node(mjstl::forward<Args>(args)...);
     tmp->next = (link_type)(position.node);
     tmp->prev = (link_type)(position.node->prev);
     //position.node->prev = tmp;
@@ -361,18 +757,27 @@ void list<T,Alloc>::clear(){
     node->prev = node->next = node;
 }
 
-/*将 list x接合于position之前。*/
+/*将 list x接合于position之前。节点来自x的slab时，x的slab一并交给本list。*/
 template<class T,class Alloc>
 void list<T,Alloc>::splice(iterator position,list& x){
-    if(!x.empty())
+    if(!x.empty()){
         __transfer(position,x.begin(),x.end());
-    size_ += x.size_();
+        if(!pool_type::__shared_pool)
+            pool_type::__adopt_pool(x);
+    }
+    size_ += x.size_;
     x.size_ = 0;
 }
 
 /* 将it所指元素接和于position之前。*/
 template<class T,class Alloc>
 void list<T,Alloc>::splice(iterator position,list& x,iterator it){
+    if(!pool_type::__shared_pool && this != &x){
+        /*节点属于x的slab，不能直接接过来。*/
+        emplace(position,mjstl::move(*it));
+        x.erase(it);
+        return;
+    }
     iterator jit = it;
     ++jit;
     if(position == it || position == jit) return;
@@ -386,6 +791,13 @@ void list<T,Alloc>::splice(iterator position,list& x,iterator it){
 template<class T,class Alloc>
 void list<T,Alloc>::splice(iterator position,list& x,iterator first,iterator last){
     if(first == last) return;
+    if(!pool_type::__shared_pool && this != &x){
+        while(first != last){
+            emplace(position,mjstl::move(*first));
+            first = x.erase(first);
+        }
+        return;
+    }
     size_type len = mjstl::distance(first,last);
      __transfer(position,first,last);
      x.size_ -= len;
@@ -436,57 +848,36 @@ void list<T,Alloc>::unique(){
     }
 }
 
-/*与链表x合并*/
+/*与链表x合并，comp抛出异常时重新统计两边的元素个数。*/
 template<class T,class Alloc>
-void list<T,Alloc>::merge(list<T,Alloc>& x){
-    iterator first1 = begin();
-    iterator last1 = end();
-    iterator first2 = x.begin();
-    iterator last2 = x.end();
-    while(first1 != last1 && first2 != last2){
-        if(*first2 < *first1){
-            iterator next = first2;
-            __transfer(first1,first2,++next);
-            first2 = next;
-        }else
-            ++first1;
+template<class Compare>
+void list<T,Alloc>::merge(list<T,Alloc>& x,Compare comp){
+    if(this == &x) return;
+    __list_data_compare<T,Compare> c(comp);
+    try{
+        __list_merge(node,x.node,c);
+    }catch(...){
+        if(!pool_type::__shared_pool){
+            /*本list要接管x的slab，x剩下的节点也接到末尾。*/
+            if(x.node->next != x.node)
+                __list_transfer(node,x.node->next,x.node);
+            pool_type::__adopt_pool(x);
+        }
+        size_ = mjstl::distance(begin(),end());
+        x.size_ = mjstl::distance(x.begin(),x.end());
+        throw;
     }
-    if(first2 != last2)
-        __transfer(last1,first2,last2);
-    size_ += x.size();
+    size_ += x.size_;
     x.size_ = 0;
+    if(!pool_type::__shared_pool)
+        pool_type::__adopt_pool(x);
 }
 
 template<class T,class Alloc>
-void list<T,Alloc>::sort(){
-    list<T,Alloc> carry;
-    list<T,Alloc> counter[64];
-    int fill = 0;
-    while(!empty()){
-        carry.splice(carry.begin(),*this,begin());
-        int i = 0;
-
-        /*
-        *   相当于二进制进位，1个数放counter[0],2个数counter[1],4个数counter[2]...
-        * 一旦i == fill，那么意味着进位，元素个数是1，2，4，8，16，32，64...
-        */
-        while(i < fill && !counter[i].empty()){
-            counter[i].merge(carry);
-            carry.swap(counter[i++]);
-        }
-
-        /*如果counter[0]空，那么会直接来到这一步。直接插入counter[0]。*/
-        carry.swap(counter[i]);
-        /*相当于扩充二进制位数。*/
-        if(i == fill) ++fill;
-    }
-
-    /*在依次合并*/
-    for(int i = 1; i < fill; ++i){
-        counter[i].merge(counter[i-1]);
-    }
-    /*最后一个就是合并好的链表，交换回来。*/
-    swap(counter[fill-1]);
+template<class Compare>
+void list<T,Alloc>::sort(Compare comp){
+    __list_data_compare<T,Compare> c(comp);
+    __list_sort(node,size_,c);
 }
 
 template<class T,class Alloc>
@@ -502,14 +893,74 @@ void list<T,Alloc>::reverse(){
     }
 }
 
+/*
+*   把节点重新连接成地址递增的顺序，元素的先后顺序不变：
+* 按地址排好节点指针，第k个位置接地址第k小的节点，元素值沿置换环move到新的节点上。
+*   节点散落在堆上时遍历几乎每一步都是缓存缺失；整理后按地址顺序访问，硬件预取能跟上，
+* 用slab时还会把空闲节点也按地址排好。
+*   元素在节点之间搬动，所有迭代器、引用失效；T的移动和交换不应抛出异常。
+* 临时数组申请不到时什么也不做。
+*/
 template<class T,class Alloc>
+void list<T,Alloc>::compact(){
+    if(size_ >= 2){
+        pair<link_type*,ptrdiff_t> buf = get_temporary_buffer<link_type>(size_);
+        if((size_type)buf.second < size_){
+            return_temporary_buffer(buf.first);
+            return;
+        }
+        link_type* a = buf.first;
+        size_type k = 0;
+        /*prev暂存元素在链表中的序号。*/
+        for(link_type p = node->next; p != node; p = p->next,++k){
+            a[k] = p;
+            p->prev = reinterpret_cast<link_type>(static_cast<std::uintptr_t>(k));
+        }
+        mjstl::sort(a,a + size_);
+        /*序号为r的元素要搬到a[r]，prev改存目的节点。*/
+        for(k = 0; k < size_; ++k)
+            a[k]->prev = a[reinterpret_cast<std::uintptr_t>(a[k]->prev)];
+        for(k = 0; k < size_; ++k){
+            link_type x = a[k];
+            if(x->prev == x) continue;
+            T carry(mjstl::move(x->data));
+            link_type y = x->prev;
+            x->prev = x;
+            while(y != x){
+                mjstl::swap(carry,y->data);
+                link_type z = y->prev;
+                y->prev = y;
+                y = z;
+            }
+            x->data = mjstl::move(carry);
+        }
+        link_type prev = node;
+        for(k = 0; k < size_; ++k){
+            prev->next = a[k];
+            a[k]->prev = prev;
+            prev = a[k];
+        }
+        prev->next = node;
+        node->prev = prev;
+        return_temporary_buffer(a);
+    }
+    pool_type::__sort_free();
+}
+
+/*
+*   只在节点的data上用args就地构造元素，不再先构造一个临时节点再整个拷贝过去。
+* prev、next由调用者设置。构造失败时归还内存，异常继续抛给调用者。
+*/
+template<class T,class Alloc>
+template<class ...Args>
 typename list<T,Alloc>::link_type 
-list<T,Alloc>::__create_node(const T& x){
-    link_type p = data_allocator::allocate();
+list<T,Alloc>::__create_node(Args&& ...args){
+    link_type p = __get_node();
     try{
-        data_allocator::construct(p,__list_node<T>(x));
+        mjstl::construct(&p->data,mjstl::forward<Args>(args)...);
     }catch(...){
-        data_allocator::deallocate(p);
+        __put_node(p);
+        throw;
     }
     return p;
 }
@@ -517,12 +968,13 @@ list<T,Alloc>::__create_node(const T& x){
 template<class T,class Alloc>
 void list<T,Alloc>::__destory_node(link_type p){
     mjstl::destory(&p->data);
-    data_allocator::deallocate(p);
+    __put_node(p);
 }
 
+/*哨兵节点的data不构造，T不必有默认构造函数。哨兵总是从全局分配器申请，不占slab。*/
 template<class T,class Alloc>
 void list<T,Alloc>::__initialize(){
-    node = __create_node();
+    node = data_allocator::allocate();
     node->prev = node->next = node;
     size_ = 0;
 }
@@ -578,26 +1030,6 @@ void list<T,Alloc>::__insert_dispatch(iterator position,InputIterator first,
         insert(position,*first);
 }
 
-template<class T,class Alloc>
-void list<T,Alloc>::__transfer(iterator position,iterator first,iterator last){
-    if(position == last) return;
-    /*
-    *   草率用 endit = --last; 后面还需要last不妥。
-    * 然后想到last不能变用后缀--，endit = last--，这样
-    * endit就不是last的前一个结点了，没作用。写糊涂了。
-    * 只能用 endit = last.node->prev;
-    */
-    iterator endit = last.node->prev;
-    /*先把[first,last)取下来，再缝合first前面后last元素。*/
-    first.node->prev->next = (link_type)last.node;
-    last.node->prev = (link_type)first.node->prev;
-    /*将[first,last)插入position前面*/
-    endit.node->next = (link_type)position.node;
-    first.node->prev = (link_type)position.node->prev;
-    first.node->prev->next = (link_type)first.node;
-    position.node->prev = (link_type)endit.node;
-}
-
 template<class T,class Alloc>
 inline bool operator==(const list<T,Alloc>& x,const list<T,Alloc>& y){
     typedef typename list<T,Alloc>::const_iterator const_iterator;
@@ -633,5 +1065,21 @@ template<class T,class Alloc>
 inline void swap(list<T,Alloc>& x,list<T,Alloc>& y){
     x.swap(y);
 }
+
+/*删除所有使pred为true的元素，返回删除个数。链表删除不需要移动元素，逐个摘下节点即可。*/
+template<class T,class Alloc,class Predicate>
+typename list<T,Alloc>::size_type erase_if(list<T,Alloc>& l,Predicate pred){
+    typename list<T,Alloc>::size_type n = 0;
+    typename list<T,Alloc>::iterator first = l.begin();
+    typename list<T,Alloc>::iterator last = l.end();
+    while(first != last){
+        if(pred(*first)){
+            first = l.erase(first);
+            ++n;
+        }else
+            ++first;
+    }
+    return n;
+}
 } // namespace mjstl
 #endif// !__LIST_H__
\ No newline at end of file
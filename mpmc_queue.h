@@ -0,0 +1,239 @@
+#ifndef __MPMC_QUEUE_H__
+#define __MPMC_QUEUE_H__
+
+#include <atomic>
+#include <type_traits>
+
+#include "memory.h"
+#include "ring_buffer.h"
+#include "sync_util.h"
+
+namespace mjstl
+{
+    /*
+    *   mpmc_queue：多生产者、多消费者的有界无锁队列(Dmitry Vyukov的序号环形队列)。
+    *   每个槽位(cell)带一个序号seq，位置pos处的槽位：
+    *     seq == pos          空闲，生产者可以占用；
+    *     seq == pos + 1      已写入，消费者可以取走；
+    *     取走后seq = pos + capacity，留给下一圈的生产者。
+    *   生产者、消费者各用一个CAS推进tail_、head_来占位，占到之后读写槽位不需要再同步，
+    * 不同线程只在同一个槽位上才会相互等待。
+    *
+    *   try_push、try_pop不阻塞；push、pop先自旋，再在__wait_point上用futex睡眠。
+    *   try_push_n、try_pop_n一次CAS占用连续的多个槽位。
+    *   元素一旦占到槽位就必须构造成功，否则消费者会一直等下去，
+    * 所以要求T的move构造、move赋值不抛异常，单个元素先在槽位外构造好再move进去，
+    * 批量入队则把源区间的元素move进槽位。
+    */
+    template<class T,class Alloc = alloc>
+    class mpmc_queue{
+        static_assert(std::is_nothrow_move_constructible<T>::value &&
+            std::is_nothrow_move_assignable<T>::value,
+            "the value_type of mpmc_queue should be nothrow movable.");
+    public:
+        typedef T                       value_type;
+        typedef Alloc                   allocate_type;
+        typedef value_type*             pointer;
+        typedef value_type&             reference;
+        typedef const value_type&       const_reference;
+        typedef size_t                  size_type;
+
+    protected:
+        typedef typename std::aligned_storage<sizeof(T),alignof(T)>::type slot_type;
+        struct cell{
+            std::atomic<size_type> seq;
+            slot_type slot;
+
+            pointer value(){ return reinterpret_cast<pointer>(&slot);}
+        };
+        typedef simple_alloc<cell,Alloc>    cell_allocator;
+
+        alignas(__CACHE_LINE_SIZE) std::atomic<size_type> tail_;
+        alignas(__CACHE_LINE_SIZE) std::atomic<size_type> head_;
+        alignas(__CACHE_LINE_SIZE) cell* buf_;
+        size_type mask_;
+        alignas(__CACHE_LINE_SIZE) __wait_point not_full_;
+        alignas(__CACHE_LINE_SIZE) __wait_point not_empty_;
+
+    public:
+        explicit mpmc_queue(size_type capacity);
+
+        mpmc_queue(const mpmc_queue&) = delete;
+        mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+        ~mpmc_queue();
+
+    public:
+        size_type capacity() const { return mask_ + 1;}
+        /*并发修改时只是近似值。*/
+        size_type size() const {
+            size_type h = head_.load(std::memory_order_acquire);
+            size_type t = tail_.load(std::memory_order_acquire);
+            return t > h ? (t - h < capacity() ? t - h : capacity()) : 0;
+        }
+        bool empty() const { return size() == 0;}
+
+        template<class ...Args>
+        bool try_emplace(Args&& ...args){
+            value_type tmp(std::forward<Args>(args)...);
+            return __try_push_value(tmp);
+        }
+        bool try_push(const T& x){ return try_emplace(x);}
+        bool try_push(T&& x){ return __try_push_value(x);}
+        bool try_pop(T& out);
+
+        template<class ...Args>
+        void emplace(Args&& ...args){
+            value_type tmp(std::forward<Args>(args)...);
+            not_full_.wait([&]{ return __try_push_value(tmp);});
+        }
+        void push(const T& x){ emplace(x);}
+        void push(T&& x){
+            not_full_.wait([&]{ return __try_push_value(x);});
+        }
+        void pop(T& out){
+            not_empty_.wait([&]{ return try_pop(out);});
+        }
+
+        /*从first开始最多move入队n个元素(入队的元素在源区间里处于已move状态)，返回实际入队的个数。*/
+        template<class InputIterator>
+        size_type try_push_n(InputIterator first,size_type n);
+        /*最多取出n个元素move到out，返回实际出队的个数。*/
+        template<class OutputIterator>
+        size_type try_pop_n(OutputIterator out,size_type n);
+
+    protected:
+        bool __try_push_value(T& x);
+    };
+
+template<class T,class Alloc>
+mpmc_queue<T,Alloc>::mpmc_queue(size_type capacity)
+  :tail_(0),head_(0),buf_(nullptr),mask_(0){
+    size_type cap = __ring_round_up(capacity < 2 ? 2 : capacity);
+    buf_ = cell_allocator().allocate(cap);
+    for(size_type i = 0; i < cap; ++i)
+        ::new (&buf_[i].seq) std::atomic<size_type>(i);
+    mask_ = cap - 1;
+}
+
+template<class T,class Alloc>
+mpmc_queue<T,Alloc>::~mpmc_queue(){
+    size_type h = head_.load(std::memory_order_relaxed);
+    size_type t = tail_.load(std::memory_order_relaxed);
+    for(; h != t; ++h)
+        mjstl::destory(buf_[h & mask_].value());
+    cell_allocator().deallocate(buf_,capacity());
+}
+
+/*x在占到槽位后才被move，失败时保持原样，可以重试。*/
+template<class T,class Alloc>
+bool mpmc_queue<T,Alloc>::__try_push_value(T& x){
+    size_type pos = tail_.load(std::memory_order_relaxed);
+    cell* c;
+    for(;;){
+        c = &buf_[pos & mask_];
+        size_type seq = c->seq.load(std::memory_order_acquire);
+        ptrdiff_t dif = ptrdiff_t(seq - pos);
+        if(dif == 0){
+            if(tail_.compare_exchange_weak(pos,pos + 1,std::memory_order_relaxed))
+                break;
+        }else if(dif < 0){
+            return false;
+        }else{
+            pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+    mjstl::construct(c->value(),mjstl::move(x));
+    c->seq.store(pos + 1,std::memory_order_release);
+    not_empty_.notify();
+    return true;
+}
+
+template<class T,class Alloc>
+bool mpmc_queue<T,Alloc>::try_pop(T& out){
+    size_type pos = head_.load(std::memory_order_relaxed);
+    cell* c;
+    for(;;){
+        c = &buf_[pos & mask_];
+        size_type seq = c->seq.load(std::memory_order_acquire);
+        ptrdiff_t dif = ptrdiff_t(seq - (pos + 1));
+        if(dif == 0){
+            if(head_.compare_exchange_weak(pos,pos + 1,std::memory_order_relaxed))
+                break;
+        }else if(dif < 0){
+            return false;
+        }else{
+            pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+    out = mjstl::move(*c->value());
+    mjstl::destory(c->value());
+    c->seq.store(pos + mask_ + 1,std::memory_order_release);
+    not_full_.notify();
+    return true;
+}
+
+/*从pos开始数出连续k个可用的槽位，再一次CAS全部占下。*/
+template<class T,class Alloc>
+template<class InputIterator>
+typename mpmc_queue<T,Alloc>::size_type
+mpmc_queue<T,Alloc>::try_push_n(InputIterator first,size_type n){
+    if(n == 0) return 0;
+    if(n > capacity()) n = capacity();
+    size_type pos = tail_.load(std::memory_order_relaxed);
+    size_type k;
+    for(;;){
+        for(k = 0; k < n; ++k)
+            if(buf_[(pos + k) & mask_].seq.load(std::memory_order_acquire) != pos + k)
+                break;
+        if(k == 0){
+            size_type seq = buf_[pos & mask_].seq.load(std::memory_order_acquire);
+            if(ptrdiff_t(seq - pos) < 0) return 0;
+            pos = tail_.load(std::memory_order_relaxed);
+            continue;
+        }
+        if(tail_.compare_exchange_weak(pos,pos + k,std::memory_order_relaxed))
+            break;
+    }
+    for(size_type i = 0; i < k; ++i,++first){
+        cell* c = &buf_[(pos + i) & mask_];
+        mjstl::construct(c->value(),mjstl::move(*first));
+        c->seq.store(pos + i + 1,std::memory_order_release);
+    }
+    not_empty_.notify();
+    return k;
+}
+
+template<class T,class Alloc>
+template<class OutputIterator>
+typename mpmc_queue<T,Alloc>::size_type
+mpmc_queue<T,Alloc>::try_pop_n(OutputIterator out,size_type n){
+    if(n == 0) return 0;
+    if(n > capacity()) n = capacity();
+    size_type pos = head_.load(std::memory_order_relaxed);
+    size_type k;
+    for(;;){
+        for(k = 0; k < n; ++k)
+            if(buf_[(pos + k) & mask_].seq.load(std::memory_order_acquire) != pos + k + 1)
+                break;
+        if(k == 0){
+            size_type seq = buf_[pos & mask_].seq.load(std::memory_order_acquire);
+            if(ptrdiff_t(seq - (pos + 1)) < 0) return 0;
+            pos = head_.load(std::memory_order_relaxed);
+            continue;
+        }
+        if(head_.compare_exchange_weak(pos,pos + k,std::memory_order_relaxed))
+            break;
+    }
+    for(size_type i = 0; i < k; ++i,++out){
+        cell* c = &buf_[(pos + i) & mask_];
+        *out = mjstl::move(*c->value());
+        mjstl::destory(c->value());
+        c->seq.store(pos + i + mask_ + 1,std::memory_order_release);
+    }
+    not_full_.notify();
+    return k;
+}
+
+} // namespace mjstl
+#endif // !__MPMC_QUEUE_H__
@@ -0,0 +1,115 @@
+#ifndef __MPSC_QUEUE_H__
+#define __MPSC_QUEUE_H__
+
+#include <atomic>
+
+#include "util.h"
+#include "sync_util.h"
+
+namespace mjstl
+{
+    /*
+    *   intrusive_mpsc_queue：多生产者、单消费者的无界侵入式队列(Dmitry Vyukov的MPSC队列)。
+    *   节点mpsc_hook是用户对象里的一个成员，队列不分配内存，也不拥有对象。
+    *   生产者push只做一次exchange把自己挂到tail_上，再把前一个节点的next指向自己，
+    * 任何时候都不会失败或重试。
+    *   消费者从head_沿next往后取。exchange之后、写next之前，链表是暂时断开的，
+    * 这时try_pop返回nullptr，稍后再取即可。
+    *   队列里始终留一个哑节点stub_，取最后一个元素时把stub_重新push进去，
+    * 这样head_永远不会为空。
+    *
+    *   drain：消费者一次取出最多max个对象交给f处理，返回处理的个数，适合事件循环每轮批量执行任务。
+    *   对象在被pop之前不能销毁，同一个对象也不能同时在队列里出现两次。
+    */
+    struct mpsc_hook{
+        std::atomic<mpsc_hook*> next;
+
+        mpsc_hook():next(nullptr){}
+        mpsc_hook(const mpsc_hook&):next(nullptr){}
+        mpsc_hook& operator=(const mpsc_hook&){ return *this;}
+    };
+
+    template<class T,mpsc_hook T::*Hook>
+    class intrusive_mpsc_queue{
+    public:
+        typedef T                   value_type;
+        typedef T*                  pointer;
+        typedef size_t              size_type;
+
+    protected:
+        /*生产者争用的一行。*/
+        alignas(__CACHE_LINE_SIZE) std::atomic<mpsc_hook*> tail_;
+        /*消费者独占。*/
+        alignas(__CACHE_LINE_SIZE) mpsc_hook* head_;
+        mpsc_hook stub_;
+
+    public:
+        intrusive_mpsc_queue():tail_(&stub_),head_(&stub_){}
+
+        intrusive_mpsc_queue(const intrusive_mpsc_queue&) = delete;
+        intrusive_mpsc_queue& operator=(const intrusive_mpsc_queue&) = delete;
+
+    public:
+        /*producer，可以在任意线程调用。*/
+        void push(pointer x){ __push(&(x->*Hook));}
+
+        /*consumer，只能在一个线程调用。*/
+        pointer try_pop();
+        template<class Function>
+        size_type drain(Function f,size_type max = size_type(-1));
+
+        /*消费者线程调用时是准确的；生产者正在push时可能暂时返回true。*/
+        bool empty() const {
+            return head_ == &stub_ && stub_.next.load(std::memory_order_acquire) == nullptr;
+        }
+
+    protected:
+        void __push(mpsc_hook* h){
+            h->next.store(nullptr,std::memory_order_relaxed);
+            mpsc_hook* prev = tail_.exchange(h,std::memory_order_acq_rel);
+            prev->next.store(h,std::memory_order_release);
+        }
+        static pointer __owner(mpsc_hook* h){ return __hook_owner(h,Hook);}
+    };
+
+template<class T,mpsc_hook T::*Hook>
+typename intrusive_mpsc_queue<T,Hook>::pointer
+intrusive_mpsc_queue<T,Hook>::try_pop(){
+    mpsc_hook* head = head_;
+    mpsc_hook* next = head->next.load(std::memory_order_acquire);
+    if(head == &stub_){
+        if(next == nullptr) return nullptr;
+        head_ = head = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if(next != nullptr){
+        head_ = next;
+        return __owner(head);
+    }
+    /*head是最后一个节点，或者有生产者已经exchange但还没有链上来。*/
+    if(head != tail_.load(std::memory_order_acquire))
+        return nullptr;
+    __push(&stub_);
+    next = head->next.load(std::memory_order_acquire);
+    if(next != nullptr){
+        head_ = next;
+        return __owner(head);
+    }
+    return nullptr;
+}
+
+template<class T,mpsc_hook T::*Hook>
+template<class Function>
+typename intrusive_mpsc_queue<T,Hook>::size_type
+intrusive_mpsc_queue<T,Hook>::drain(Function f,size_type max){
+    size_type n = 0;
+    for(; n < max; ++n){
+        pointer x = try_pop();
+        if(x == nullptr) break;
+        f(x);
+    }
+    return n;
+}
+
+} // namespace mjstl
+#endif // !__MPSC_QUEUE_H__
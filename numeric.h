@@ -7,12 +7,32 @@ namespace mjstl{
 
 /*accumulate:累加*/
 template<class InputIterator, class T>
-T accumulate(InputIterator first, InputIterator last, T init){
+T __accumulate_segment(InputIterator first, InputIterator last, T init, __false_type){
     for(; first != last; ++first)
         init += *first;
     return init;
 }
 
+/*分段迭代器版本：逐段在连续区间内累加。*/
+template<class SegmentedIterator, class T>
+T __accumulate_segment(SegmentedIterator first, SegmentedIterator last, T init, __true_type){
+    typedef __segmented_iterator_traits<SegmentedIterator> traits;
+    typename traits::segment_iterator sfirst = traits::segment(first);
+    typename traits::segment_iterator slast = traits::segment(last);
+    if(sfirst == slast)
+        return __accumulate_segment(traits::local(first),traits::local(last),init,__false_type());
+    init = __accumulate_segment(traits::local(first),traits::end(sfirst),init,__false_type());
+    for(++sfirst; sfirst != slast; ++sfirst)
+        init = __accumulate_segment(traits::begin(sfirst),traits::end(sfirst),init,__false_type());
+    return __accumulate_segment(traits::begin(slast),traits::local(last),init,__false_type());
+}
+
+template<class InputIterator, class T>
+T accumulate(InputIterator first, InputIterator last, T init){
+    typedef typename __segmented_iterator_traits<InputIterator>::is_segmented_iterator seg;
+    return __accumulate_segment(first,last,init,seg());
+}
+
 template<class InputIterator, class T, class BinaryOperation>
 T accumulate(InputIterator first, InputIterator last, T init, BinaryOperation binary_op){
     for(; first != last; ++first)
@@ -0,0 +1,275 @@
+#ifndef __PAIRING_HEAP_H__
+#define __PAIRING_HEAP_H__
+
+#include <functional>
+
+#include "heap_algo.h"
+#include "memory.h"
+#include "util.h"
+
+namespace mjstl
+{
+    /*
+    *   pairing_heap：可寻址的配对堆。push返回一个句柄(handle)，之后可以通过句柄
+    * decrease_key(提高优先级)或erase，不用像priority_queue那样压入重复元素再跳过过期的。
+    *   Compare的含义和priority_queue相同：默认std::less，top()是最大的元素；
+    * 最短路这类要取最小值的用std::greater，decrease_key就是把键值改小。
+    *
+    *   每个节点有child(最左边的孩子)、sibling(右边的兄弟)、prev(最左孩子指向父节点，
+    * 其余指向左边的兄弟)，所以任何节点都能O(1)从树上剪下来。
+    *   push、meld、decrease_key只做一次链接(link)，O(1)；
+    * pop、erase把被删节点的孩子两两配对再从右往左合并(two-pass)，均摊O(log n)。
+    *
+    *   节点由simple_alloc逐个申请。句柄在元素被pop、erase或容器析构、clear之前一直有效，
+    * move和meld之后仍然有效(节点本身没有搬动)，meld后句柄属于合并后的堆。
+    *   句柄和节点一一对应，堆不能拷贝。
+    */
+    template<class T>
+    struct __pairing_node{
+        T value;
+        __pairing_node* child;
+        __pairing_node* sibling;
+        __pairing_node* prev;
+    };
+
+    template<class T>
+    struct __pairing_handle{
+        typedef __pairing_node<T>* link_type;
+
+        link_type node;
+
+        __pairing_handle():node(nullptr){}
+        explicit __pairing_handle(link_type p):node(p){}
+
+        const T& operator*() const { return node->value;}
+        const T* operator->() const { return &node->value;}
+        bool operator==(const __pairing_handle& x) const { return node == x.node;}
+        bool operator!=(const __pairing_handle& x) const { return node != x.node;}
+    };
+
+    template<class T,class Compare = std::less<T>,class Alloc = alloc>
+    class pairing_heap{
+    public:
+        typedef T                       value_type;
+        typedef Compare                 value_compare;
+        typedef Alloc                   allocate_type;
+        typedef value_type&             reference;
+        typedef const value_type&       const_reference;
+        typedef size_t                  size_type;
+        typedef __pairing_handle<T>     handle_type;
+
+    protected:
+        typedef __pairing_node<T>                   node_type;
+        typedef node_type*                          link_type;
+        typedef simple_alloc<node_type,Alloc>       node_allocator;
+
+        link_type root_;
+        size_type size_;
+        value_compare comp_;
+
+    public:
+        pairing_heap():root_(nullptr),size_(0),comp_(){}
+        explicit pairing_heap(const Compare& comp):root_(nullptr),size_(0),comp_(comp){}
+        pairing_heap(pairing_heap&& x):root_(x.root_),size_(x.size_),comp_(x.comp_){
+            x.root_ = nullptr;
+            x.size_ = 0;
+        }
+
+        pairing_heap(const pairing_heap&) = delete;
+        pairing_heap& operator=(const pairing_heap&) = delete;
+
+        pairing_heap& operator=(pairing_heap&& x){
+            if(this != &x){
+                clear();
+                swap(x);
+            }
+            return *this;
+        }
+
+        ~pairing_heap(){ clear();}
+
+    public:
+        const_reference top() const { return root_->value;}
+        bool empty() const { return size_ == 0;}
+        size_type size() const { return size_;}
+
+        template<class ...Args>
+        handle_type emplace(Args&& ...args);
+        handle_type push(const T& x){ return emplace(x);}
+        handle_type push(T&& x){ return emplace(mjstl::move(x));}
+        void pop(){ erase(handle_type(root_));}
+
+        /*把h的值改为x，x的优先级不能低于原值(!comp(x,*h))。*/
+        void decrease_key(handle_type h,const T& x);
+        void decrease_key(handle_type h,T&& x);
+        void erase(handle_type h);
+
+        /*把x的全部元素并入本堆，x变为空，x的句柄转为本堆的句柄。*/
+        void meld(pairing_heap& x);
+
+        void clear();
+        void swap(pairing_heap& x){
+            mjstl::swap(root_,x.root_);
+            mjstl::swap(size_,x.size_);
+            mjstl::swap(comp_,x.comp_);
+        }
+
+    protected:
+        link_type __link(link_type a,link_type b);
+        void __cut(link_type p);
+        link_type __merge_pairs(link_type first);
+        void __raise(link_type p);
+    };
+
+/*a、b都是树根，优先级低的一方成为另一方最左边的孩子，返回新的根。*/
+template<class T,class Compare,class Alloc>
+typename pairing_heap<T,Compare,Alloc>::link_type
+pairing_heap<T,Compare,Alloc>::__link(link_type a,link_type b){
+    if(comp_(a->value,b->value)) mjstl::swap(a,b);
+    b->prev = a;
+    b->sibling = a->child;
+    if(a->child != nullptr) a->child->prev = b;
+    a->child = b;
+    a->prev = nullptr;
+    a->sibling = nullptr;
+    return a;
+}
+
+/*把以p为根的子树从树上剪下来，p不是根。*/
+template<class T,class Compare,class Alloc>
+void pairing_heap<T,Compare,Alloc>::__cut(link_type p){
+    if(p->prev->child == p)
+        p->prev->child = p->sibling;
+    else
+        p->prev->sibling = p->sibling;
+    if(p->sibling != nullptr) p->sibling->prev = p->prev;
+    p->prev = nullptr;
+    p->sibling = nullptr;
+}
+
+/*
+*   two-pass合并一串兄弟：第一遍从左往右两两link，结果经sibling压成一个栈(最右边的一对在栈顶)；
+* 第二遍从栈顶起依次link，即从右往左合并。不递归，兄弟再多也不会栈溢出。
+*   兄弟节点散落在内存各处，link当前一对时先预取下一对的第一个节点。
+*/
+template<class T,class Compare,class Alloc>
+typename pairing_heap<T,Compare,Alloc>::link_type
+pairing_heap<T,Compare,Alloc>::__merge_pairs(link_type first){
+    if(first == nullptr) return nullptr;
+    link_type stack = nullptr;
+    while(first != nullptr){
+        link_type a = first;
+        link_type b = a->sibling;
+        if(b == nullptr){
+            a->sibling = stack;
+            stack = a;
+            break;
+        }
+        first = b->sibling;
+        if(first != nullptr) __heap_prefetch(first);
+        a = __link(a,b);
+        a->sibling = stack;
+        stack = a;
+    }
+    link_type result = stack;
+    stack = stack->sibling;
+    while(stack != nullptr){
+        link_type next = stack->sibling;
+        result = __link(stack,result);
+        stack = next;
+    }
+    result->prev = nullptr;
+    result->sibling = nullptr;
+    return result;
+}
+
+/*p的值变得更优先后，把它剪下来和根重新link。p是最左孩子且仍不比父节点优先时不用动。*/
+template<class T,class Compare,class Alloc>
+void pairing_heap<T,Compare,Alloc>::__raise(link_type p){
+    if(p == root_) return;
+    if(p->prev->child == p && !comp_(p->prev->value,p->value)) return;
+    __cut(p);
+    root_ = __link(root_,p);
+}
+
+template<class T,class Compare,class Alloc>
+template<class ...Args>
+typename pairing_heap<T,Compare,Alloc>::handle_type
+pairing_heap<T,Compare,Alloc>::emplace(Args&& ...args){
+    link_type p = node_allocator().allocate();
+    try{
+        mjstl::construct(&p->value,mjstl::forward<Args>(args)...);
+    }catch(...){
+        node_allocator().deallocate(p);
+        throw;
+    }
+    p->child = p->sibling = p->prev = nullptr;
+    root_ = root_ == nullptr ? p : __link(root_,p);
+    ++size_;
+    return handle_type(p);
+}
+
+template<class T,class Compare,class Alloc>
+void pairing_heap<T,Compare,Alloc>::decrease_key(handle_type h,const T& x){
+    h.node->value = x;
+    __raise(h.node);
+}
+
+template<class T,class Compare,class Alloc>
+void pairing_heap<T,Compare,Alloc>::decrease_key(handle_type h,T&& x){
+    h.node->value = mjstl::move(x);
+    __raise(h.node);
+}
+
+/*剪下h，h的孩子two-pass合并后再和根link。*/
+template<class T,class Compare,class Alloc>
+void pairing_heap<T,Compare,Alloc>::erase(handle_type h){
+    link_type p = h.node;
+    if(p == root_){
+        root_ = __merge_pairs(p->child);
+    }else{
+        __cut(p);
+        link_type sub = __merge_pairs(p->child);
+        if(sub != nullptr) root_ = __link(root_,sub);
+    }
+    mjstl::destory(&p->value);
+    node_allocator().deallocate(p);
+    --size_;
+}
+
+template<class T,class Compare,class Alloc>
+void pairing_heap<T,Compare,Alloc>::meld(pairing_heap& x){
+    if(this == &x || x.root_ == nullptr) return;
+    root_ = root_ == nullptr ? x.root_ : __link(root_,x.root_);
+    size_ += x.size_;
+    x.root_ = nullptr;
+    x.size_ = 0;
+}
+
+/*孩子链整串接到待释放栈的前面，每个节点只经过一次，O(n)且不递归。*/
+template<class T,class Compare,class Alloc>
+void pairing_heap<T,Compare,Alloc>::clear(){
+    link_type stack = root_;
+    while(stack != nullptr){
+        link_type p = stack;
+        stack = p->sibling;
+        if(p->child != nullptr){
+            link_type tail = p->child;
+            while(tail->sibling != nullptr) tail = tail->sibling;
+            tail->sibling = stack;
+            stack = p->child;
+        }
+        mjstl::destory(&p->value);
+        node_allocator().deallocate(p);
+    }
+    root_ = nullptr;
+    size_ = 0;
+}
+
+template<class T,class Compare,class Alloc>
+inline void swap(pairing_heap<T,Compare,Alloc>& x,pairing_heap<T,Compare,Alloc>& y){
+    x.swap(y);
+}
+
+} // namespace mjstl
+#endif // !__PAIRING_HEAP_H__
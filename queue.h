@@ -2,7 +2,7 @@
 #define __QUEUE_H__
 
 #include "heap_algo.h"
-#include "../deque.h"
+#include "deque.h"
 
 namespace mjstl
 {
@@ -94,6 +94,20 @@ public:
         c_.pop_front();
     }
 
+    /*批量入队：[first,last)按顺序追加到队尾，由底层容器一次预留空间。*/
+    template<class InputIterator>
+    void push_range(InputIterator first,InputIterator last)
+    {
+        c_.append(first,last);
+    }
+
+    /*批量出队：队首最多n个元素按出队顺序move到out，返回out的结尾。*/
+    template<class OutputIterator>
+    OutputIterator pop_n(size_type n,OutputIterator out)
+    {
+        return c_.pop_front_n(n,out);
+    }
+
     void clear()
     {
         while(!c_.empty())
@@ -148,8 +162,12 @@ void swap(queue<T,Container>& lhs,queue<T,Container>& rhs)
     lhs.swap(rhs);
 }
 
+/*
+*   Arity为堆的叉数，默认二叉堆。元素很多时用4或8，树更矮，
+* 一个节点的孩子挨在一起，下滤时访问的缓存行更少，见heap_algo.h的d叉堆。
+*/
 template<class T,class Container = mjstl::deque<T>,
-  class Compare = std::less<typename Container::value_type>>
+  class Compare = std::less<typename Container::value_type>,size_t Arity = 2>
 class priority_queue
 {
 public:
@@ -173,57 +191,57 @@ public:
     explicit priority_queue(size_type n)
       :c_(n)
     {
-        mjstl::make_heap(c_.begin(),c_.end(),comp_);
+        mjstl::make_heap<Arity>(c_.begin(),c_.end(),comp_);
     }
     
     priority_queue(size_type n,const value_type& value)
       :c_(n,value)
     {
-        mjstl::make_heap(c_.begin(),c_.end(),comp_);
+        mjstl::make_heap<Arity>(c_.begin(),c_.end(),comp_);
     }
 
     template<class IIter>
     priority_queue(IIter first,IIter last)
       :c_(first,last)
     {
-        mjstl::make_heap(c_.begin(),c_.end(),comp_);
+        mjstl::make_heap<Arity>(c_.begin(),c_.end(),comp_);
     }
 
     priority_queue(std::initializer_list<value_type> ilist)
       :c_(ilist.begin(),ilist.end())
     {
-        mjstl::make_heap(c_.begin(),c_.end(),comp_);
+        mjstl::make_heap<Arity>(c_.begin(),c_.end(),comp_);
     }
 
     priority_queue(const Container& c)
       :c_(c)
     {
-        mjstl::make_heap(c_.begin(),c_.end(),comp_);
+        mjstl::make_heap<Arity>(c_.begin(),c_.end(),comp_);
     }
 
     priority_queue(Container&& c)
       :c_(std::move(c))
     {
-        mjstl::make_heap(c_.begin(),c_.end(),comp_);
+        mjstl::make_heap<Arity>(c_.begin(),c_.end(),comp_);
     }
 
     priority_queue(const priority_queue& rhs)
       :c_(rhs.c_),comp_(rhs.comp_)
     {
-        mjstl::make_heap(c_.begin(),c_.end(),comp_);
+        mjstl::make_heap<Arity>(c_.begin(),c_.end(),comp_);
     }
 
     priority_queue(priority_queue&& rhs)
       :c_(std::move(rhs.c_)),comp_(rhs.comp_)
     {
-        mjstl::make_heap(c_.begin(),c_.end(),comp_);
+        mjstl::make_heap<Arity>(c_.begin(),c_.end(),comp_);
     }
 
     priority_queue& operator=(const priority_queue& rhs)
     {
         c_ = rhs.c_;
         comp_ = rhs.comp_;
-        mjstl::make_heap(c_.begin(),c_.end(),comp_);
+        mjstl::make_heap<Arity>(c_.begin(),c_.end(),comp_);
         return *this;
     }
 
@@ -231,7 +249,7 @@ public:
     {
         c_ = std::move(rhs.c_);
         comp_ = std::move(rhs.comp_);
-        mjstl::make_heap(c_.begin(),c_.end(),comp_);
+        mjstl::make_heap<Arity>(c_.begin(),c_.end(),comp_);
         return *this;
     }
 
@@ -239,7 +257,7 @@ public:
     {
         c_ = ilist;
         comp_ = value_compare();
-        mjstl::make_heap(c_.begin(),c_.end(),comp_);
+        mjstl::make_heap<Arity>(c_.begin(),c_.end(),comp_);
         return *this;
     }
 
@@ -255,31 +273,72 @@ public:
     void emplace(Args&& ...args)
     {
         c_.emplace_back(std::forward<Args>(args)...);
-        mjstl::push_heap(c_.begin(),c_.end(),comp_);
+        mjstl::push_heap<Arity>(c_.begin(),c_.end(),comp_);
     }
 
     void push(const value_type& value)
     {
         c_.push_back(value);
-        mjstl::push_heap(c_.begin(),c_.end(),comp_);
+        mjstl::push_heap<Arity>(c_.begin(),c_.end(),comp_);
     }
 
     void push(value_type&& value)
     {
         c_.push_back(std::move(value));
-        mjstl::push_heap(c_.begin(),c_.end(),comp_);
+        mjstl::push_heap<Arity>(c_.begin(),c_.end(),comp_);
     }
 
     void pop()
     {
-        mjstl::pop_head(c_.begin(),c_.end(),comp_);
+        mjstl::pop_heap<Arity>(c_.begin(),c_.end(),comp_);
         c_.pop_back();
     }
 
+    /*
+    *   批量入堆：先把[first,last)整段追加到容器末尾。
+    *   新元素k个、原有n个时，逐个上滤最坏要k*log2(n+k)步(堆在插入过程中变大)；
+    * 整体make_heap约2(n+k)次比较，还要把每个元素都搬一遍，按4(n+k)计。前者更多时整体重建，否则逐个上滤。
+    *   k >= n时总是重建：make_heap是O(n+k)，而空堆或小堆逐个上滤在升序等输入下是O(k*log k)。
+    * 随机数据时上滤平均只有常数步，所以批量比原堆小时只有超过阈值才重建。
+    */
+    template<class InputIterator>
+    void push_range(InputIterator first,InputIterator last)
+    {
+        size_type n = c_.size();
+        try{
+            c_.insert(c_.end(),first,last);
+        }catch(...){
+            mjstl::make_heap<Arity>(c_.begin(),c_.end(),comp_);
+            throw;
+        }
+        size_type k = c_.size() - n;
+        size_type lg = 0;
+        for(size_type i = n + k; i > 1; i >>= 1) ++lg;
+        if(k >= n || 4 * (n + k) < k * lg){
+            mjstl::make_heap<Arity>(c_.begin(),c_.end(),comp_);
+        }else{
+            for(size_type i = n + 1; i <= n + k; ++i)
+                mjstl::push_heap<Arity>(c_.begin(),c_.begin() + i,comp_);
+        }
+    }
+
+    /*批量出堆：最多n个元素按出堆顺序(优先级从高到低)move到out，返回out的结尾。*/
+    template<class OutputIterator>
+    OutputIterator pop_n(size_type n,OutputIterator out)
+    {
+        for(; n > 0 && !c_.empty(); --n){
+            mjstl::pop_heap<Arity>(c_.begin(),c_.end(),comp_);
+            *out = mjstl::move(c_.back());
+            ++out;
+            c_.pop_back();
+        }
+        return out;
+    }
+
+    /*清空不需要维持堆序，直接清空容器。*/
     void clear()
     {
-        while(!c_.empty())
-            pop();
+        c_.clear();
     }
 
     void swap(priority_queue& rhs) noexcept(noexcept(mjstl::swap(c_,rhs.c_))
@@ -302,23 +361,23 @@ public:
 };
 
 
-template<class T,class Container,class Compare>
-bool operator==(const priority_queue<T,Container,Compare>& lhs,
-                const priority_queue<T,Container,Compare>& rhs)
+template<class T,class Container,class Compare,size_t Arity>
+bool operator==(const priority_queue<T,Container,Compare,Arity>& lhs,
+                const priority_queue<T,Container,Compare,Arity>& rhs)
 {
     return lhs == rhs;
 }
 
-template<class T,class Container,class Compare>
-bool operator!=(const priority_queue<T,Container,Compare>& lhs,
-                const priority_queue<T,Container,Compare>& rhs)
+template<class T,class Container,class Compare,size_t Arity>
+bool operator!=(const priority_queue<T,Container,Compare,Arity>& lhs,
+                const priority_queue<T,Container,Compare,Arity>& rhs)
 {
     return lhs != rhs;
 }
 
-template<class T,class Container,class Compare>
-void swap(priority_queue<T,Container,Compare>& lhs,
-          priority_queue<T,Container,Compare>& rhs)
+template<class T,class Container,class Compare,size_t Arity>
+void swap(priority_queue<T,Container,Compare,Arity>& lhs,
+          priority_queue<T,Container,Compare,Arity>& rhs)
 {
     lhs.swap(rhs);
 }
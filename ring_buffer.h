@@ -0,0 +1,571 @@
+#ifndef __RING_BUFFER_H__
+#define __RING_BUFFER_H__
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "iterator.h"
+#include "reverse_iterator.h"
+#include "memory.h"
+#include "pair.h"
+#include "exceptdef.h"
+
+namespace mjstl
+{
+    /*
+    *   ring_buffer：容量为2的幂的环形缓冲区，可以作为queue、stack的底层容器。
+    *   head_、tail_是不回绕的计数器，元素个数为tail_ - head_，
+    * 第i个元素在buf_[(head_ + i) & mask_]，定位只需一次与运算，不需要map间接寻址。
+    *   ring_buffer<T,Alloc>容量在运行时给出(reserve)，满了按2倍扩容；
+    * static_ring_buffer<T,N>的元素就存在对象内部，满了再插入抛出length_error。
+    *   array_one、array_two给出环形回绕后的两段连续内存，便于批量拷贝。
+    */
+    inline size_t __ring_round_up(size_t n){
+        size_t cap = 1;
+        while(cap < n) cap <<= 1;
+        return cap;
+    }
+
+    template<class T,class Ref,class Ptr>
+    struct __ring_iterator : public iterator<random_access_iterator_tag,T>{
+        typedef __ring_iterator<T,T&,T*>                iterator;
+        typedef __ring_iterator<T,const T&,const T*>    const_iterator;
+        typedef __ring_iterator<T,Ref,Ptr>              self;
+
+        typedef random_access_iterator_tag  iterator_category;
+        typedef T                           value_type;
+        typedef Ptr                         pointer;
+        typedef Ref                         reference;
+        typedef size_t                      size_type;
+        typedef ptrdiff_t                   difference_type;
+
+        T* buf;
+        size_type mask;
+        size_type pos;      /*不回绕的位置，与head_、tail_同一计数。*/
+
+        __ring_iterator():buf(nullptr),mask(0),pos(0){}
+        __ring_iterator(T* b,size_type m,size_type p):buf(b),mask(m),pos(p){}
+        __ring_iterator(const iterator& x):buf(x.buf),mask(x.mask),pos(x.pos){}
+
+        reference operator*() const { return buf[pos & mask];}
+        pointer operator->() const { return &(operator*());}
+        reference operator[](difference_type n) const { return buf[(pos + n) & mask];}
+
+        self& operator++(){ ++pos; return *this;}
+        self operator++(int){ self tmp = *this; ++pos; return tmp;}
+        self& operator--(){ --pos; return *this;}
+        self operator--(int){ self tmp = *this; --pos; return tmp;}
+        self& operator+=(difference_type n){ pos += n; return *this;}
+        self& operator-=(difference_type n){ pos -= n; return *this;}
+        self operator+(difference_type n) const { return self(buf,mask,pos + n);}
+        self operator-(difference_type n) const { return self(buf,mask,pos - n);}
+        difference_type operator-(const self& x) const { return difference_type(pos - x.pos);}
+
+        bool operator==(const self& x) const { return pos == x.pos;}
+        bool operator!=(const self& x) const { return pos != x.pos;}
+        bool operator<(const self& x) const { return difference_type(pos - x.pos) < 0;}
+        bool operator>(const self& x) const { return x < *this;}
+        bool operator<=(const self& x) const { return !(x < *this);}
+        bool operator>=(const self& x) const { return !(*this < x);}
+    };
+
+    template<class T,class Ref,class Ptr>
+    inline __ring_iterator<T,Ref,Ptr> operator+(ptrdiff_t n,const __ring_iterator<T,Ref,Ptr>& x){
+        return x + n;
+    }
+
+    /*两种环形缓冲区共用的部分：访问、弹出、两段视图，不涉及存储的分配。*/
+    template<class T>
+    class __ring_buffer_base{
+    public:
+        typedef T                       value_type;
+        typedef value_type*             pointer;
+        typedef const value_type*       const_pointer;
+        typedef value_type&             reference;
+        typedef const value_type&       const_reference;
+        typedef size_t                  size_type;
+        typedef ptrdiff_t               difference_type;
+
+        typedef __ring_iterator<T,T&,T*>                iterator;
+        typedef __ring_iterator<T,const T&,const T*>    const_iterator;
+        typedef mjstl::reverse_iterator<iterator>       reverse_iterator;
+        typedef mjstl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        typedef mjstl::pair<pointer,size_type>          array_range;
+        typedef mjstl::pair<const_pointer,size_type>    const_array_range;
+
+    protected:
+        pointer buf_;
+        size_type mask_;    /*容量 - 1，容量为0时为size_type(-1)。*/
+        size_type head_;
+        size_type tail_;
+
+        __ring_buffer_base(pointer buf,size_type cap)
+          :buf_(buf),mask_(cap - 1),head_(0),tail_(0){}
+
+    public:
+        /*about iterator*/
+        iterator begin(){ return iterator(buf_,mask_,head_);}
+        const_iterator begin() const { return const_iterator(iterator(buf_,mask_,head_));}
+        iterator end(){ return iterator(buf_,mask_,tail_);}
+        const_iterator end() const { return const_iterator(iterator(buf_,mask_,tail_));}
+        reverse_iterator rbegin(){ return reverse_iterator(end());}
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end());}
+        reverse_iterator rend(){ return reverse_iterator(begin());}
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin());}
+
+        /*about container*/
+        bool empty() const { return head_ == tail_;}
+        bool full() const { return tail_ - head_ == capacity();}
+        size_type size() const { return tail_ - head_;}
+        size_type capacity() const { return mask_ + 1;}
+
+        reference operator[](size_type n){ return buf_[(head_ + n) & mask_];}
+        const_reference operator[](size_type n) const { return buf_[(head_ + n) & mask_];}
+        reference at(size_type n){
+            THROW_OUT_OF_RANGE_IF(n >= size(),"ring_buffer<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+        const_reference at(size_type n) const {
+            THROW_OUT_OF_RANGE_IF(n >= size(),"ring_buffer<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+        reference front(){ return buf_[head_ & mask_];}
+        const_reference front() const { return buf_[head_ & mask_];}
+        reference back(){ return buf_[(tail_ - 1) & mask_];}
+        const_reference back() const { return buf_[(tail_ - 1) & mask_];}
+
+        /*
+        *   array_one：从front开始到缓冲区末尾(或到back)的一段连续内存。
+        *   array_two：回绕到缓冲区开头的那一段，没有回绕时长度为0。
+        */
+        array_range array_one(){
+            size_type n = __first_span();
+            return array_range(buf_ + (head_ & mask_),n);
+        }
+        const_array_range array_one() const {
+            size_type n = __first_span();
+            return const_array_range(buf_ + (head_ & mask_),n);
+        }
+        array_range array_two(){ return array_range(buf_,size() - __first_span());}
+        const_array_range array_two() const { return const_array_range(buf_,size() - __first_span());}
+
+        /*modify container*/
+        void pop_front(){
+            mjstl::destory(&front());
+            ++head_;
+        }
+        void pop_back(){
+            --tail_;
+            mjstl::destory(buf_ + (tail_ & mask_));
+        }
+
+        /*把头部、尾部最多n个元素按原顺序move到out，返回out的结尾。*/
+        template<class OutputIterator>
+        OutputIterator pop_front_n(size_type n,OutputIterator out);
+        template<class OutputIterator>
+        OutputIterator pop_back_n(size_type n,OutputIterator out);
+
+        void clear(){
+            __destory_all();
+            head_ = tail_ = 0;
+        }
+
+    protected:
+        size_type __first_span() const {
+            size_type to_end = capacity() - (head_ & mask_);
+            return size() < to_end ? size() : to_end;
+        }
+
+        /*按[head,head + n)的顺序把元素move到out并析构，两段各一次。*/
+        template<class OutputIterator>
+        OutputIterator __move_out(size_type head,size_type n,OutputIterator out);
+
+        void __destory_all(){
+            array_range one = array_one();
+            array_range two = array_two();
+            mjstl::destory(one.first,one.first + one.second);
+            mjstl::destory(two.first,two.first + two.second);
+        }
+
+        template<class ...Args>
+        void __construct_back(Args&& ...args){
+            mjstl::construct(buf_ + (tail_ & mask_),std::forward<Args>(args)...);
+            ++tail_;
+        }
+
+        template<class ...Args>
+        void __construct_front(Args&& ...args){
+            mjstl::construct(buf_ + ((head_ - 1) & mask_),std::forward<Args>(args)...);
+            --head_;
+        }
+    };
+
+template<class T>
+template<class OutputIterator>
+OutputIterator __ring_buffer_base<T>::__move_out(size_type head,size_type n,OutputIterator out){
+    pointer first = buf_ + (head & mask_);
+    size_type to_end = capacity() - (head & mask_);
+    size_type n1 = n < to_end ? n : to_end;
+    out = mjstl::unchecked_move(first,first + n1,out);
+    mjstl::destory(first,first + n1);
+    if(n1 < n){
+        out = mjstl::unchecked_move(buf_,buf_ + (n - n1),out);
+        mjstl::destory(buf_,buf_ + (n - n1));
+    }
+    return out;
+}
+
+template<class T>
+template<class OutputIterator>
+OutputIterator __ring_buffer_base<T>::pop_front_n(size_type n,OutputIterator out){
+    if(n > size()) n = size();
+    out = __move_out(head_,n,out);
+    head_ += n;
+    return out;
+}
+
+template<class T>
+template<class OutputIterator>
+OutputIterator __ring_buffer_base<T>::pop_back_n(size_type n,OutputIterator out){
+    if(n > size()) n = size();
+    out = __move_out(tail_ - n,n,out);
+    tail_ -= n;
+    return out;
+}
+
+template<class T>
+bool operator==(const __ring_buffer_base<T>& lhs,const __ring_buffer_base<T>& rhs){
+    return lhs.size() == rhs.size() && mjstl::equal(lhs.begin(),lhs.end(),rhs.begin(),rhs.end());
+}
+
+template<class T>
+bool operator!=(const __ring_buffer_base<T>& lhs,const __ring_buffer_base<T>& rhs){
+    return !(lhs == rhs);
+}
+
+template<class T>
+bool operator<(const __ring_buffer_base<T>& lhs,const __ring_buffer_base<T>& rhs){
+    return mjstl::lexicographical_compare(lhs.begin(),lhs.end(),rhs.begin(),rhs.end());
+}
+
+template<class T>
+bool operator>(const __ring_buffer_base<T>& lhs,const __ring_buffer_base<T>& rhs){
+    return rhs < lhs;
+}
+
+template<class T>
+bool operator<=(const __ring_buffer_base<T>& lhs,const __ring_buffer_base<T>& rhs){
+    return !(rhs < lhs);
+}
+
+template<class T>
+bool operator>=(const __ring_buffer_base<T>& lhs,const __ring_buffer_base<T>& rhs){
+    return !(lhs < rhs);
+}
+
+/*******************************************ring_buffer*******************************************/
+template<class T,class Alloc = alloc>
+class ring_buffer : public __ring_buffer_base<T>{
+    typedef __ring_buffer_base<T>   base;
+public:
+    typedef Alloc                               allocate_type;
+    typedef typename base::value_type           value_type;
+    typedef typename base::pointer              pointer;
+    typedef typename base::const_pointer        const_pointer;
+    typedef typename base::reference            reference;
+    typedef typename base::const_reference      const_reference;
+    typedef typename base::size_type            size_type;
+    typedef typename base::difference_type      difference_type;
+    typedef typename base::iterator             iterator;
+    typedef typename base::const_iterator       const_iterator;
+
+protected:
+    typedef simple_alloc<value_type,Alloc>      data_allocator;
+    using base::buf_;
+    using base::mask_;
+    using base::head_;
+    using base::tail_;
+
+public:
+    ring_buffer():base(nullptr,0){}
+    explicit ring_buffer(size_type n):base(nullptr,0){ __fill_initialize(n,T());}
+    ring_buffer(size_type n,const T& value):base(nullptr,0){ __fill_initialize(n,value);}
+    ring_buffer(std::initializer_list<value_type> ilist):base(nullptr,0){
+        append(ilist.begin(),ilist.end());
+    }
+    template<class InputIterator,typename std::enable_if<
+        mjstl::is_input_iterator<InputIterator>::value,int>::type = 0>
+    ring_buffer(InputIterator first,InputIterator last):base(nullptr,0){
+        append(first,last);
+    }
+
+    ring_buffer(const ring_buffer& x):base(nullptr,0){
+        reserve(x.size());
+        append(x.begin(),x.end());
+    }
+    ring_buffer(ring_buffer&& x) noexcept:base(x.buf_,x.capacity()){
+        head_ = x.head_;
+        tail_ = x.tail_;
+        x.buf_ = nullptr;
+        x.mask_ = size_type(-1);
+        x.head_ = x.tail_ = 0;
+    }
+
+    ring_buffer& operator=(const ring_buffer& x){
+        if(this != &x){
+            ring_buffer tmp(x);
+            swap(tmp);
+        }
+        return *this;
+    }
+    ring_buffer& operator=(ring_buffer&& x) noexcept{
+        if(this != &x){
+            ring_buffer tmp(mjstl::move(x));
+            swap(tmp);
+        }
+        return *this;
+    }
+    ring_buffer& operator=(std::initializer_list<value_type> ilist){
+        ring_buffer tmp(ilist);
+        swap(tmp);
+        return *this;
+    }
+
+    ~ring_buffer(){
+        this->__destory_all();
+        __deallocate();
+    }
+
+public:
+    /*容量取不小于n的2的幂，元素搬到新缓冲区的开头。*/
+    void reserve(size_type n);
+    void shrink_to_fit();
+
+    template<class ...Args>
+    void emplace_back(Args&& ...args){
+        if(this->full()) reserve(this->capacity() == 0 ? 1 : 2 * this->capacity());
+        this->__construct_back(std::forward<Args>(args)...);
+    }
+    template<class ...Args>
+    void emplace_front(Args&& ...args){
+        if(this->full()) reserve(this->capacity() == 0 ? 1 : 2 * this->capacity());
+        this->__construct_front(std::forward<Args>(args)...);
+    }
+    void push_back(const T& x){ emplace_back(x);}
+    void push_back(T&& x){ emplace_back(mjstl::move(x));}
+    void push_front(const T& x){ emplace_front(x);}
+    void push_front(T&& x){ emplace_front(mjstl::move(x));}
+
+    /*把[first,last)按原顺序接到尾部，前向迭代器一次预留空间后按两段拷贝。*/
+    template<class InputIterator>
+    void append(InputIterator first,InputIterator last){
+        __append_aux(first,last,iterator_category(first));
+    }
+
+    void swap(ring_buffer& x) noexcept{
+        mjstl::swap(buf_,x.buf_);
+        mjstl::swap(mask_,x.mask_);
+        mjstl::swap(head_,x.head_);
+        mjstl::swap(tail_,x.tail_);
+    }
+
+    allocate_type get_allocate(){ return allocate_type();}
+
+protected:
+    void __fill_initialize(size_type n,const T& value);
+    void __reallocate(size_type new_cap);
+    void __deallocate(){
+        if(buf_ != nullptr)
+            data_allocator().deallocate(buf_,this->capacity());
+    }
+    template<class InputIterator>
+    void __append_aux(InputIterator first,InputIterator last,input_iterator_tag);
+    template<class ForwardIterator>
+    void __append_aux(ForwardIterator first,ForwardIterator last,forward_iterator_tag);
+};
+
+template<class T,class Alloc>
+void ring_buffer<T,Alloc>::__fill_initialize(size_type n,const T& value){
+    reserve(n);
+    mjstl::uninitialized_fill_n(buf_,n,value);
+    tail_ = n;
+}
+
+template<class T,class Alloc>
+void ring_buffer<T,Alloc>::reserve(size_type n){
+    if(n > this->capacity())
+        __reallocate(__ring_round_up(n));
+}
+
+template<class T,class Alloc>
+void ring_buffer<T,Alloc>::shrink_to_fit(){
+    size_type new_cap = this->empty() ? 0 : __ring_round_up(this->size());
+    if(new_cap < this->capacity())
+        __reallocate(new_cap);
+}
+
+/*new_cap为0或2的幂，且不小于size()。*/
+template<class T,class Alloc>
+void ring_buffer<T,Alloc>::__reallocate(size_type new_cap){
+    pointer new_buf = new_cap == 0 ? nullptr : data_allocator().allocate(new_cap);
+    size_type n = this->size();
+    size_type i = 0;
+    try{
+        for(; i < n; ++i)
+            mjstl::construct(new_buf + i,mjstl::move((*this)[i]));
+    }catch(...){
+        mjstl::destory(new_buf,new_buf + i);
+        data_allocator().deallocate(new_buf,new_cap);
+        throw;
+    }
+    this->__destory_all();
+    __deallocate();
+    buf_ = new_buf;
+    mask_ = new_cap - 1;
+    head_ = 0;
+    tail_ = n;
+}
+
+template<class T,class Alloc>
+template<class InputIterator>
+void ring_buffer<T,Alloc>::__append_aux(InputIterator first,InputIterator last,input_iterator_tag){
+    for(; first != last; ++first)
+        emplace_back(*first);
+}
+
+template<class T,class Alloc>
+template<class ForwardIterator>
+void ring_buffer<T,Alloc>::__append_aux(ForwardIterator first,ForwardIterator last,forward_iterator_tag){
+    size_type n = static_cast<size_type>(mjstl::distance(first,last));
+    if(n == 0) return;
+    reserve(this->size() + n);
+    pointer p = buf_ + (tail_ & mask_);
+    size_type to_end = this->capacity() - (tail_ & mask_);
+    if(n <= to_end){
+        mjstl::uninitialized_copy(first,last,p);
+    }else{
+        ForwardIterator mid = first;
+        mjstl::advance(mid,to_end);
+        mjstl::uninitialized_copy(first,mid,p);
+        try{
+            mjstl::uninitialized_copy(mid,last,buf_);
+        }catch(...){
+            mjstl::destory(p,p + to_end);
+            throw;
+        }
+    }
+    tail_ += n;
+}
+
+template<class T,class Alloc>
+void swap(ring_buffer<T,Alloc>& lhs,ring_buffer<T,Alloc>& rhs){
+    lhs.swap(rhs);
+}
+
+/****************************************static_ring_buffer****************************************/
+template<class T,size_t N>
+class static_ring_buffer : public __ring_buffer_base<T>{
+    static_assert(N > 0 && (N & (N - 1)) == 0,"the capacity of static_ring_buffer should be a power of 2.");
+    typedef __ring_buffer_base<T>   base;
+public:
+    typedef typename base::value_type           value_type;
+    typedef typename base::pointer              pointer;
+    typedef typename base::const_pointer        const_pointer;
+    typedef typename base::reference            reference;
+    typedef typename base::const_reference      const_reference;
+    typedef typename base::size_type            size_type;
+    typedef typename base::difference_type      difference_type;
+    typedef typename base::iterator             iterator;
+    typedef typename base::const_iterator       const_iterator;
+
+protected:
+    typedef typename std::aligned_storage<sizeof(T),alignof(T)>::type slot_type;
+    slot_type storage_[N];
+
+public:
+    static_ring_buffer():base(reinterpret_cast<pointer>(storage_),N){}
+    explicit static_ring_buffer(size_type n):base(reinterpret_cast<pointer>(storage_),N){
+        for(; n > 0; --n) emplace_back();
+    }
+    static_ring_buffer(size_type n,const T& value):base(reinterpret_cast<pointer>(storage_),N){
+        for(; n > 0; --n) emplace_back(value);
+    }
+    static_ring_buffer(std::initializer_list<value_type> ilist):base(reinterpret_cast<pointer>(storage_),N){
+        append(ilist.begin(),ilist.end());
+    }
+    template<class InputIterator,typename std::enable_if<
+        mjstl::is_input_iterator<InputIterator>::value,int>::type = 0>
+    static_ring_buffer(InputIterator first,InputIterator last):base(reinterpret_cast<pointer>(storage_),N){
+        append(first,last);
+    }
+    static_ring_buffer(const static_ring_buffer& x):base(reinterpret_cast<pointer>(storage_),N){
+        append(x.begin(),x.end());
+    }
+    /*元素存在对象内部，移动也只能逐个move。*/
+    static_ring_buffer(static_ring_buffer&& x):base(reinterpret_cast<pointer>(storage_),N){
+        for(iterator it = x.begin(); it != x.end(); ++it)
+            this->__construct_back(mjstl::move(*it));
+        x.clear();
+    }
+
+    static_ring_buffer& operator=(const static_ring_buffer& x){
+        if(this != &x){
+            this->clear();
+            append(x.begin(),x.end());
+        }
+        return *this;
+    }
+    static_ring_buffer& operator=(static_ring_buffer&& x){
+        if(this != &x){
+            this->clear();
+            for(iterator it = x.begin(); it != x.end(); ++it)
+                this->__construct_back(mjstl::move(*it));
+            x.clear();
+        }
+        return *this;
+    }
+    static_ring_buffer& operator=(std::initializer_list<value_type> ilist){
+        this->clear();
+        append(ilist.begin(),ilist.end());
+        return *this;
+    }
+
+    ~static_ring_buffer(){ this->__destory_all();}
+
+public:
+    template<class ...Args>
+    void emplace_back(Args&& ...args){
+        THROW_LENGTH_ERROR_IF(this->full(),"static_ring_buffer<T,N> is full");
+        this->__construct_back(std::forward<Args>(args)...);
+    }
+    template<class ...Args>
+    void emplace_front(Args&& ...args){
+        THROW_LENGTH_ERROR_IF(this->full(),"static_ring_buffer<T,N> is full");
+        this->__construct_front(std::forward<Args>(args)...);
+    }
+    void push_back(const T& x){ emplace_back(x);}
+    void push_back(T&& x){ emplace_back(mjstl::move(x));}
+    void push_front(const T& x){ emplace_front(x);}
+    void push_front(T&& x){ emplace_front(mjstl::move(x));}
+
+    template<class InputIterator>
+    void append(InputIterator first,InputIterator last){
+        for(; first != last; ++first)
+            emplace_back(*first);
+    }
+
+    void swap(static_ring_buffer& x){
+        static_ring_buffer tmp(mjstl::move(x));
+        x = mjstl::move(*this);
+        *this = mjstl::move(tmp);
+    }
+};
+
+template<class T,size_t N>
+void swap(static_ring_buffer<T,N>& lhs,static_ring_buffer<T,N>& rhs){
+    lhs.swap(rhs);
+}
+
+} // namespace mjstl
+#endif // !__RING_BUFFER_H__
@@ -5,6 +5,7 @@
 #define USE_NEW
 #include <new>
 #endif // !USE_NEW
+#include <utility>
 
 #include "iterator.h"
 #include "type_traits.h"
@@ -0,0 +1,484 @@
+#ifndef __SOA_VECTOR_H__
+#define __SOA_VECTOR_H__
+
+#include <tuple>
+#include <type_traits>
+#include <cstring>
+
+#include "iterator.h"
+#include "memory.h"
+#include "vector.h"
+
+namespace mjstl
+{
+    /*
+    *   soa_vector<Fields...>：按列存放的vector(structure of arrays)。
+    *   每个字段单独存成一段连续数组，只扫描一两个字段的循环不会把其他字段也读进缓存。
+    *   所有列放在同一块内存里，每列起始地址按__SOA_ALIGN对齐，方便SIMD。
+    *   容量增长策略与vector相同(__vector_grow)：空时为1，之后每次翻倍。
+    *
+    *   operator[]返回由各列引用组成的std::tuple代理，column<I>()/span<I>()直接给出第I列。
+    *   扩容时按列搬移元素，要求各字段的move构造不抛异常。
+    */
+    enum { __SOA_ALIGN = 64 };
+
+    template<size_t... I>
+    struct __soa_index{};
+
+    template<size_t N,size_t... I>
+    struct __soa_make_index : public __soa_make_index<N - 1,N - 1,I...>{};
+
+    template<size_t... I>
+    struct __soa_make_index<0,I...>{
+        typedef __soa_index<I...> type;
+    };
+
+    /*一列的视图：指针加长度。*/
+    template<class T>
+    struct __soa_span{
+        typedef T           value_type;
+        typedef T*          iterator;
+        typedef T&          reference;
+        typedef size_t      size_type;
+
+        T* data_;
+        size_type size_;
+
+        __soa_span(T* p,size_type n):data_(p),size_(n){}
+
+        T* data() const { return data_;}
+        size_type size() const { return size_;}
+        bool empty() const { return size_ == 0;}
+        iterator begin() const { return data_;}
+        iterator end() const { return data_ + size_;}
+        reference operator[](size_type n) const { return data_[n];}
+    };
+
+    /*行迭代器：记录容器和行号，解引用得到一行的引用代理。*/
+    template<class SoaVector,class Ref>
+    struct __soa_iterator{
+        typedef random_access_iterator_tag          iterator_category;
+        typedef typename SoaVector::value_type      value_type;
+        typedef Ref                                 reference;
+        typedef void                                pointer;
+        typedef ptrdiff_t                           difference_type;
+        typedef size_t                              size_type;
+        typedef __soa_iterator<SoaVector,Ref>       self;
+
+        SoaVector* v;
+        size_type index;
+
+        __soa_iterator():v(nullptr),index(0){}
+        __soa_iterator(SoaVector* x,size_type i):v(x),index(i){}
+        template<class R>
+        __soa_iterator(const __soa_iterator<typename std::remove_const<SoaVector>::type,R>& x)
+          :v(x.v),index(x.index){}
+
+        reference operator*() const { return (*v)[index];}
+        reference operator[](difference_type n) const { return (*v)[index + n];}
+        self& operator++(){ ++index; return *this;}
+        self operator++(int){ self tmp = *this; ++index; return tmp;}
+        self& operator--(){ --index; return *this;}
+        self operator--(int){ self tmp = *this; --index; return tmp;}
+        self& operator+=(difference_type n){ index += n; return *this;}
+        self& operator-=(difference_type n){ index -= n; return *this;}
+        self operator+(difference_type n) const { return self(v,index + n);}
+        self operator-(difference_type n) const { return self(v,index - n);}
+        difference_type operator-(const self& x) const { return difference_type(index) - difference_type(x.index);}
+
+        bool operator==(const self& x) const { return index == x.index;}
+        bool operator!=(const self& x) const { return index != x.index;}
+        bool operator<(const self& x) const { return index < x.index;}
+        bool operator>(const self& x) const { return x.index < index;}
+        bool operator<=(const self& x) const { return !(x.index < index);}
+        bool operator>=(const self& x) const { return !(index < x.index);}
+    };
+
+    template<class... Fields>
+    class soa_vector{
+    public:
+        typedef std::tuple<Fields...>                   value_type;
+        typedef std::tuple<Fields&...>                  reference;
+        typedef std::tuple<const Fields&...>            const_reference;
+        typedef size_t                                  size_type;
+        typedef ptrdiff_t                               difference_type;
+
+        typedef __soa_iterator<soa_vector,reference>                iterator;
+        typedef __soa_iterator<const soa_vector,const_reference>    const_iterator;
+
+        enum { column_count = sizeof...(Fields) };
+
+        template<size_t I>
+        struct field{
+            typedef typename std::tuple_element<I,value_type>::type type;
+        };
+
+    protected:
+        typedef mjstl::allocator<char>  data_allocator;
+        typedef typename __soa_make_index<sizeof...(Fields)>::type indices;
+
+    protected:
+        char* raw;                  /*整块内存，各列从中按对齐切出。*/
+        size_type raw_bytes;
+        void* columns[sizeof...(Fields)];
+        size_type size_;
+        size_type capacity_;
+
+    public:
+        soa_vector():raw(nullptr),raw_bytes(0),size_(0),capacity_(0){ __clear_columns();}
+        soa_vector(const soa_vector& x);
+        soa_vector(soa_vector&& x);
+        soa_vector& operator=(const soa_vector& x);
+        soa_vector& operator=(soa_vector&& x);
+        ~soa_vector(){ clear(); __deallocate();}
+
+    public:
+        /*about iterator*/
+        iterator begin(){ return iterator(this,0);}
+        const_iterator begin() const { return const_iterator(this,0);}
+        iterator end(){ return iterator(this,size_);}
+        const_iterator end() const { return const_iterator(this,size_);}
+
+        /*about container*/
+        size_type size() const { return size_;}
+        size_type capacity() const { return capacity_;}
+        bool empty() const { return size_ == 0;}
+
+        /*access container*/
+        reference operator[](size_type n){ return __row(n,indices());}
+        const_reference operator[](size_type n) const { return __const_row(n,indices());}
+        reference front(){ return (*this)[0];}
+        reference back(){ return (*this)[size_ - 1];}
+
+        template<size_t I>
+        typename field<I>::type* column(){
+            return static_cast<typename field<I>::type*>(columns[I]);
+        }
+        template<size_t I>
+        const typename field<I>::type* column() const {
+            return static_cast<const typename field<I>::type*>(columns[I]);
+        }
+        template<size_t I>
+        __soa_span<typename field<I>::type> span(){
+            return __soa_span<typename field<I>::type>(column<I>(),size_);
+        }
+        template<size_t I>
+        __soa_span<const typename field<I>::type> span() const {
+            return __soa_span<const typename field<I>::type>(column<I>(),size_);
+        }
+        template<size_t I>
+        typename field<I>::type& get(size_type n){ return column<I>()[n];}
+        template<size_t I>
+        const typename field<I>::type& get(size_type n) const { return column<I>()[n];}
+
+        /*modify container*/
+        template<class... Args>
+        void emplace_back(Args&&... args);
+        void push_back(const value_type& x){ __push_tuple(x,indices());}
+        void push_back(value_type&& x){ __push_tuple(mjstl::move(x),indices());}
+        void pop_back();
+        iterator erase(const_iterator position){ return erase(position,position + 1);}
+        iterator erase(const_iterator first,const_iterator last);
+        void clear();
+        void reserve(size_type n);
+        void swap(soa_vector& x);
+
+    protected:
+        void __clear_columns();
+        void __deallocate();
+        size_type __allocate_columns(size_type new_capacity,char*& new_raw,void** new_columns);
+        void __adopt_columns(char* new_raw,size_type bytes,size_type new_capacity,void** new_columns);
+        void __reallocate(size_type new_capacity);
+        template<class... Args>
+        void __emplace_back_aux(Args&&... args);
+
+        template<size_t... I>
+        reference __row(size_type n,__soa_index<I...>){
+            return reference(static_cast<Fields*>(columns[I])[n]...);
+        }
+        template<size_t... I>
+        const_reference __const_row(size_type n,__soa_index<I...>) const {
+            return const_reference(static_cast<const Fields*>(columns[I])[n]...);
+        }
+
+        template<class Tuple,size_t... I>
+        void __push_tuple(Tuple&& x,__soa_index<I...>){
+            emplace_back(std::get<I>(mjstl::forward<Tuple>(x))...);
+        }
+
+        /*在cols给出的各列里逐列构造第n行，某列抛异常时把已构造的前几列析构掉。*/
+        template<size_t I>
+        static void __construct_row(void**,size_type){}
+        template<size_t I,class Arg,class... Rest>
+        static void __construct_row(void** cols,size_type n,Arg&& arg,Rest&&... rest);
+
+        template<size_t... I>
+        void __destory_rows(size_type first,size_type last,__soa_index<I...>);
+        template<size_t... I>
+        void __erase_rows(size_type first,size_type last,__soa_index<I...>);
+        template<size_t... I>
+        void __copy_rows(const soa_vector& x,__soa_index<I...>);
+        template<size_t... I>
+        void __move_columns(void** new_columns,__soa_index<I...>);
+    };
+
+    /*********************************按列操作的辅助函数*********************************/
+    template<class T>
+    inline void __soa_destory_column(T* col,size_t first,size_t last){
+        mjstl::destory(col + first,col + last);
+    }
+
+    /*[first,last)之后的元素前移，再析构尾部多出来的部分。*/
+    template<class T>
+    inline void __soa_erase_column(T* col,size_t first,size_t last,size_t size){
+        T* dest = col + first;
+        for(T* src = col + last; src != col + size; ++src,++dest)
+            *dest = mjstl::move(*src);
+        mjstl::destory(dest,col + size);
+    }
+
+    template<class T>
+    inline void __soa_relocate_column(T* dest,T* src,size_t n,__true_type){
+        if(n != 0)
+            std::memcpy(dest,src,n * sizeof(T));
+    }
+
+    template<class T>
+    inline void __soa_relocate_column(T* dest,T* src,size_t n,__false_type){
+        for(size_t i = 0; i < n; ++i){
+            mjstl::construct(dest + i,mjstl::move(src[i]));
+            mjstl::destory(src + i);
+        }
+    }
+
+    template<class T>
+    inline void __soa_relocate_column(T* dest,T* src,size_t n){
+        typedef typename __type_traits<T>::is_POD_type is_POD;
+        __soa_relocate_column(dest,src,n,is_POD());
+    }
+
+template<class... Fields>
+soa_vector<Fields...>::soa_vector(const soa_vector& x)
+  :raw(nullptr),raw_bytes(0),size_(0),capacity_(0)
+{
+    __clear_columns();
+    reserve(x.size_);
+    __copy_rows(x,indices());
+}
+
+template<class... Fields>
+soa_vector<Fields...>::soa_vector(soa_vector&& x)
+  :raw(x.raw),raw_bytes(x.raw_bytes),size_(x.size_),capacity_(x.capacity_)
+{
+    for(size_t i = 0; i < sizeof...(Fields); ++i)
+        columns[i] = x.columns[i];
+    x.raw = nullptr;
+    x.raw_bytes = x.size_ = x.capacity_ = 0;
+    x.__clear_columns();
+}
+
+template<class... Fields>
+soa_vector<Fields...>& soa_vector<Fields...>::operator=(const soa_vector& x){
+    if(this != &x){
+        soa_vector tmp(x);
+        swap(tmp);
+    }
+    return *this;
+}
+
+template<class... Fields>
+soa_vector<Fields...>& soa_vector<Fields...>::operator=(soa_vector&& x){
+    if(this != &x){
+        soa_vector tmp(mjstl::move(x));
+        swap(tmp);
+    }
+    return *this;
+}
+
+template<class... Fields>
+template<class... Args>
+void soa_vector<Fields...>::emplace_back(Args&&... args){
+    static_assert(sizeof...(Args) == sizeof...(Fields),"soa_vector::emplace_back needs one argument per field");
+    if(size_ == capacity_){
+        __emplace_back_aux(mjstl::forward<Args>(args)...);
+    }else{
+        __construct_row<0>(columns,size_,mjstl::forward<Args>(args)...);
+        ++size_;
+    }
+}
+
+/*
+*   容量已满时的emplace_back：参数可能引用容器里的元素，
+* 所以先在新内存里构造新的一行，再把原来的元素搬过去。
+*/
+template<class... Fields>
+template<class... Args>
+void soa_vector<Fields...>::__emplace_back_aux(Args&&... args){
+    char* new_raw;
+    void* new_columns[sizeof...(Fields)];
+    const size_type new_capacity = __vector_grow(size_,1);
+    const size_type bytes = __allocate_columns(new_capacity,new_raw,new_columns);
+    try{
+        __construct_row<0>(new_columns,size_,mjstl::forward<Args>(args)...);
+    }catch(...){
+        data_allocator::deallocate(new_raw,bytes);
+        throw;
+    }
+    __move_columns(new_columns,indices());
+    __adopt_columns(new_raw,bytes,new_capacity,new_columns);
+    ++size_;
+}
+
+template<class... Fields>
+template<size_t I,class Arg,class... Rest>
+void soa_vector<Fields...>::__construct_row(void** cols,size_type n,Arg&& arg,Rest&&... rest){
+    typename field<I>::type* p = static_cast<typename field<I>::type*>(cols[I]) + n;
+    mjstl::construct(p,mjstl::forward<Arg>(arg));
+    try{
+        __construct_row<I + 1>(cols,n,mjstl::forward<Rest>(rest)...);
+    }catch(...){
+        mjstl::destory(p);
+        throw;
+    }
+}
+
+template<class... Fields>
+void soa_vector<Fields...>::pop_back(){
+    if(size_ != 0){
+        __destory_rows(size_ - 1,size_,indices());
+        --size_;
+    }
+}
+
+template<class... Fields>
+typename soa_vector<Fields...>::iterator
+soa_vector<Fields...>::erase(const_iterator first,const_iterator last){
+    const size_type f = first.index;
+    const size_type l = last.index;
+    if(f != l){
+        __erase_rows(f,l,indices());
+        size_ -= l - f;
+    }
+    return iterator(this,f);
+}
+
+template<class... Fields>
+void soa_vector<Fields...>::clear(){
+    __destory_rows(0,size_,indices());
+    size_ = 0;
+}
+
+template<class... Fields>
+void soa_vector<Fields...>::reserve(size_type n){
+    if(n > capacity_)
+        __reallocate(n);
+}
+
+template<class... Fields>
+void soa_vector<Fields...>::swap(soa_vector& x){
+    mjstl::swap(raw,x.raw);
+    mjstl::swap(raw_bytes,x.raw_bytes);
+    mjstl::swap(size_,x.size_);
+    mjstl::swap(capacity_,x.capacity_);
+    for(size_t i = 0; i < sizeof...(Fields); ++i)
+        mjstl::swap(columns[i],x.columns[i]);
+}
+
+template<class... Fields>
+void soa_vector<Fields...>::__clear_columns(){
+    for(size_t i = 0; i < sizeof...(Fields); ++i)
+        columns[i] = nullptr;
+}
+
+template<class... Fields>
+void soa_vector<Fields...>::__deallocate(){
+    data_allocator::deallocate(raw,raw_bytes);
+    raw = nullptr;
+    raw_bytes = 0;
+}
+
+/*
+*   一次分配容纳new_capacity行的整块内存：每列占new_capacity * sizeof(字段)字节，
+* 列与列之间按__SOA_ALIGN补齐，多分配__SOA_ALIGN - 1字节用来对齐首地址。
+*   各列起始地址放进new_columns，返回整块的字节数。
+*/
+template<class... Fields>
+typename soa_vector<Fields...>::size_type
+soa_vector<Fields...>::__allocate_columns(size_type new_capacity,char*& new_raw,void** new_columns){
+    static const size_t sizes[] = { sizeof(Fields)... };
+    size_t offsets[sizeof...(Fields)];
+    size_t bytes = 0;
+    for(size_t i = 0; i < sizeof...(Fields); ++i){
+        offsets[i] = bytes;
+        bytes += (new_capacity * sizes[i] + __SOA_ALIGN - 1) & ~size_t(__SOA_ALIGN - 1);
+    }
+    bytes += __SOA_ALIGN - 1;
+
+    new_raw = data_allocator::allocate(bytes);
+    char* base = reinterpret_cast<char*>(
+        (reinterpret_cast<size_t>(new_raw) + __SOA_ALIGN - 1) & ~size_t(__SOA_ALIGN - 1));
+    for(size_t i = 0; i < sizeof...(Fields); ++i)
+        new_columns[i] = base + offsets[i];
+    return bytes;
+}
+
+/*元素已经搬到new_columns里，释放旧内存，改用新的。*/
+template<class... Fields>
+void soa_vector<Fields...>::__adopt_columns(char* new_raw,size_type bytes,
+    size_type new_capacity,void** new_columns){
+    __deallocate();
+    raw = new_raw;
+    raw_bytes = bytes;
+    capacity_ = new_capacity;
+    for(size_t i = 0; i < sizeof...(Fields); ++i)
+        columns[i] = new_columns[i];
+}
+
+template<class... Fields>
+void soa_vector<Fields...>::__reallocate(size_type new_capacity){
+    char* new_raw;
+    void* new_columns[sizeof...(Fields)];
+    const size_type bytes = __allocate_columns(new_capacity,new_raw,new_columns);
+    __move_columns(new_columns,indices());
+    __adopt_columns(new_raw,bytes,new_capacity,new_columns);
+}
+
+/*以下用数组初始化展开参数包，保证按列的顺序依次执行。*/
+template<class... Fields>
+template<size_t... I>
+void soa_vector<Fields...>::__destory_rows(size_type first,size_type last,__soa_index<I...>){
+    int expand[] = { 0,(__soa_destory_column(column<I>(),first,last),0)... };
+    (void)expand;
+}
+
+template<class... Fields>
+template<size_t... I>
+void soa_vector<Fields...>::__erase_rows(size_type first,size_type last,__soa_index<I...>){
+    int expand[] = { 0,(__soa_erase_column(column<I>(),first,last,size_),0)... };
+    (void)expand;
+}
+
+template<class... Fields>
+template<size_t... I>
+void soa_vector<Fields...>::__copy_rows(const soa_vector& x,__soa_index<I...>){
+    for(size_type n = 0; n < x.size_; ++n){
+        __construct_row<0>(columns,n,x.template column<I>()[n]...);
+        ++size_;
+    }
+}
+
+template<class... Fields>
+template<size_t... I>
+void soa_vector<Fields...>::__move_columns(void** new_columns,__soa_index<I...>){
+    int expand[] = { 0,(__soa_relocate_column(static_cast<Fields*>(new_columns[I]),
+        column<I>(),size_),0)... };
+    (void)expand;
+}
+
+template<class... Fields>
+inline void swap(soa_vector<Fields...>& x,soa_vector<Fields...>& y){
+    x.swap(y);
+}
+
+} // namespace mjstl
+#endif // !__SOA_VECTOR_H__
@@ -0,0 +1,361 @@
+#ifndef __SPSC_QUEUE_H__
+#define __SPSC_QUEUE_H__
+
+#include <atomic>
+#include <type_traits>
+
+#include "memory.h"
+#include "ring_buffer.h"
+#include "sync_util.h"
+
+namespace mjstl
+{
+    /*
+    *   spsc_queue：单生产者、单消费者的无锁队列，一个线程只push，另一个线程只pop。
+    *   生产者只写tail_，消费者只写head_，两者放在不同的缓存行。
+    *   生产者另存一份cached_head_，只有看起来满了才去读head_；消费者同理缓存tail_。
+    * 这样大多数操作只碰自己那一行，不会和对方来回抢缓存行。
+    *   tail_.store(release)与tail_.load(acquire)配对，保证消费者看到的元素已经构造完成；
+    * head_同理，保证生产者复用的槽位已经析构。
+    *
+    *   spsc_queue<T,Alloc>：容量固定(取2的幂)的环形缓冲区，满了try_push返回false。
+    *   unbounded_spsc_queue<T,Alloc,SegSize>：由若干段(segment)链成，满了接一段新的，
+    * 消费者用完的段由生产者回收复用，只有回收不到时才向simple_alloc申请。
+    *
+    *   push、pop是try_push、try_pop的自旋版本；try_push_n、try_pop_n一次搬运多个元素，
+    * 只发布一次下标。size()、empty()只是某一时刻的近似值。
+    */
+    template<class T,class Alloc = alloc>
+    class spsc_queue{
+    public:
+        typedef T                       value_type;
+        typedef Alloc                   allocate_type;
+        typedef value_type*             pointer;
+        typedef value_type&             reference;
+        typedef const value_type&       const_reference;
+        typedef size_t                  size_type;
+
+    protected:
+        typedef simple_alloc<value_type,Alloc>  data_allocator;
+
+        /*生产者一行。*/
+        alignas(__CACHE_LINE_SIZE) std::atomic<size_type> tail_;
+        size_type cached_head_;
+        /*消费者一行。*/
+        alignas(__CACHE_LINE_SIZE) std::atomic<size_type> head_;
+        size_type cached_tail_;
+        /*构造后只读。*/
+        alignas(__CACHE_LINE_SIZE) pointer buf_;
+        size_type mask_;
+
+    public:
+        explicit spsc_queue(size_type capacity)
+          :tail_(0),cached_head_(0),head_(0),cached_tail_(0),buf_(nullptr),mask_(0){
+            size_type cap = __ring_round_up(capacity == 0 ? 1 : capacity);
+            buf_ = data_allocator().allocate(cap);
+            mask_ = cap - 1;
+        }
+
+        spsc_queue(const spsc_queue&) = delete;
+        spsc_queue& operator=(const spsc_queue&) = delete;
+
+        ~spsc_queue(){
+            size_type h = head_.load(std::memory_order_relaxed);
+            size_type t = tail_.load(std::memory_order_relaxed);
+            for(; h != t; ++h)
+                mjstl::destory(buf_ + (h & mask_));
+            data_allocator().deallocate(buf_,capacity());
+        }
+
+    public:
+        size_type capacity() const { return mask_ + 1;}
+        size_type size() const {
+            return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+        }
+        bool empty() const { return size() == 0;}
+
+        /*producer*/
+        template<class ...Args>
+        bool try_emplace(Args&& ...args);
+        bool try_push(const T& x){ return try_emplace(x);}
+        bool try_push(T&& x){ return try_emplace(mjstl::move(x));}
+        void push(const T& x){
+            unsigned spins = 0;
+            while(!try_emplace(x)) __spin_wait(spins);
+        }
+        void push(T&& x){
+            unsigned spins = 0;
+            while(!try_emplace(mjstl::move(x))) __spin_wait(spins);
+        }
+        /*从first开始最多拷贝n个元素，返回实际入队的个数。*/
+        template<class InputIterator>
+        size_type try_push_n(InputIterator first,size_type n);
+
+        /*consumer*/
+        bool try_pop(T& out);
+        void pop(T& out){
+            unsigned spins = 0;
+            while(!try_pop(out)) __spin_wait(spins);
+        }
+        /*最多取出n个元素move到out，返回实际出队的个数。*/
+        template<class OutputIterator>
+        size_type try_pop_n(OutputIterator out,size_type n);
+    };
+
+template<class T,class Alloc>
+template<class ...Args>
+bool spsc_queue<T,Alloc>::try_emplace(Args&& ...args){
+    const size_type t = tail_.load(std::memory_order_relaxed);
+    if(t - cached_head_ == capacity()){
+        cached_head_ = head_.load(std::memory_order_acquire);
+        if(t - cached_head_ == capacity())
+            return false;
+    }
+    mjstl::construct(buf_ + (t & mask_),std::forward<Args>(args)...);
+    tail_.store(t + 1,std::memory_order_release);
+    return true;
+}
+
+template<class T,class Alloc>
+template<class InputIterator>
+typename spsc_queue<T,Alloc>::size_type
+spsc_queue<T,Alloc>::try_push_n(InputIterator first,size_type n){
+    const size_type t = tail_.load(std::memory_order_relaxed);
+    size_type room = capacity() - (t - cached_head_);
+    if(room < n){
+        cached_head_ = head_.load(std::memory_order_acquire);
+        room = capacity() - (t - cached_head_);
+    }
+    if(n > room) n = room;
+    size_type i = 0;
+    try{
+        for(; i < n; ++i,++first)
+            mjstl::construct(buf_ + ((t + i) & mask_),*first);
+    }catch(...){
+        /*已经构造好的那部分照常发布。*/
+        tail_.store(t + i,std::memory_order_release);
+        throw;
+    }
+    tail_.store(t + n,std::memory_order_release);
+    return n;
+}
+
+template<class T,class Alloc>
+bool spsc_queue<T,Alloc>::try_pop(T& out){
+    const size_type h = head_.load(std::memory_order_relaxed);
+    if(h == cached_tail_){
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        if(h == cached_tail_)
+            return false;
+    }
+    pointer p = buf_ + (h & mask_);
+    out = mjstl::move(*p);
+    mjstl::destory(p);
+    head_.store(h + 1,std::memory_order_release);
+    return true;
+}
+
+template<class T,class Alloc>
+template<class OutputIterator>
+typename spsc_queue<T,Alloc>::size_type
+spsc_queue<T,Alloc>::try_pop_n(OutputIterator out,size_type n){
+    const size_type h = head_.load(std::memory_order_relaxed);
+    if(cached_tail_ - h < n)
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+    if(n > cached_tail_ - h) n = cached_tail_ - h;
+    for(size_type i = 0; i < n; ++i,++out){
+        pointer p = buf_ + ((h + i) & mask_);
+        *out = mjstl::move(*p);
+        mjstl::destory(p);
+    }
+    head_.store(h + n,std::memory_order_release);
+    return n;
+}
+
+/*************************************unbounded_spsc_queue*************************************/
+/*
+*   段链表：first_ -> ... -> 消费者所在段 -> ... -> 生产者所在段。
+*   消费者取完一段后把head_seg_后移，first_到head_seg_之间的段都已取空，
+* 生产者需要新段时先从first_取，取不到才分配，所以稳定后不再分配内存。
+*   默认段长256，段大小超过default_alloc_template的128字节，实际由malloc分配，
+* 生产者线程分配时不会与其他线程争用内存池。
+*/
+template<class T,class Alloc = alloc,size_t SegSize = 256>
+class unbounded_spsc_queue{
+public:
+    typedef T                       value_type;
+    typedef Alloc                   allocate_type;
+    typedef value_type*             pointer;
+    typedef value_type&             reference;
+    typedef const value_type&       const_reference;
+    typedef size_t                  size_type;
+
+protected:
+    typedef typename std::aligned_storage<sizeof(T),alignof(T)>::type slot_type;
+    struct segment{
+        std::atomic<segment*> next;
+        slot_type slots[SegSize];
+
+        pointer value(size_type i){ return reinterpret_cast<pointer>(slots + i);}
+    };
+    typedef simple_alloc<segment,Alloc>     segment_allocator;
+
+    /*生产者一行。*/
+    alignas(__CACHE_LINE_SIZE) std::atomic<size_type> tail_;
+    segment* tail_seg_;
+    size_type tail_pos_;
+    segment* first_;            /*可回收段的开头。*/
+    segment* head_seg_copy_;    /*生产者看到的head_seg_，first_追上它时才重新读。*/
+    /*消费者一行。*/
+    alignas(__CACHE_LINE_SIZE) std::atomic<size_type> head_;
+    size_type cached_tail_;
+    std::atomic<segment*> head_seg_;
+    size_type head_pos_;
+
+public:
+    unbounded_spsc_queue()
+      :tail_(0),tail_pos_(0),head_(0),cached_tail_(0),head_pos_(0){
+        segment* s = __allocate_segment();
+        tail_seg_ = first_ = head_seg_copy_ = s;
+        head_seg_.store(s,std::memory_order_relaxed);
+    }
+
+    unbounded_spsc_queue(const unbounded_spsc_queue&) = delete;
+    unbounded_spsc_queue& operator=(const unbounded_spsc_queue&) = delete;
+
+    ~unbounded_spsc_queue();
+
+public:
+    size_type size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0;}
+
+    /*producer，不会失败。*/
+    template<class ...Args>
+    void emplace(Args&& ...args){
+        if(tail_pos_ == SegSize) __next_tail_segment();
+        mjstl::construct(tail_seg_->value(tail_pos_),std::forward<Args>(args)...);
+        ++tail_pos_;
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1,std::memory_order_release);
+    }
+    void push(const T& x){ emplace(x);}
+    void push(T&& x){ emplace(mjstl::move(x));}
+    template<class InputIterator>
+    void push_n(InputIterator first,size_type n);
+
+    /*consumer*/
+    bool try_pop(T& out);
+    void pop(T& out){
+        unsigned spins = 0;
+        while(!try_pop(out)) __spin_wait(spins);
+    }
+    template<class OutputIterator>
+    size_type try_pop_n(OutputIterator out,size_type n);
+
+protected:
+    segment* __allocate_segment(){
+        segment* s = segment_allocator().allocate();
+        ::new (&s->next) std::atomic<segment*>(nullptr);
+        return s;
+    }
+    void __next_tail_segment();
+    void __next_head_segment(){
+        segment* s = head_seg_.load(std::memory_order_relaxed)->next.load(std::memory_order_acquire);
+        head_seg_.store(s,std::memory_order_release);
+        head_pos_ = 0;
+    }
+};
+
+template<class T,class Alloc,size_t SegSize>
+void unbounded_spsc_queue<T,Alloc,SegSize>::__next_tail_segment(){
+    segment* s;
+    if(first_ == head_seg_copy_)
+        head_seg_copy_ = head_seg_.load(std::memory_order_acquire);
+    if(first_ != head_seg_copy_){
+        s = first_;
+        first_ = first_->next.load(std::memory_order_relaxed);
+        s->next.store(nullptr,std::memory_order_relaxed);
+    }else{
+        s = __allocate_segment();
+    }
+    tail_seg_->next.store(s,std::memory_order_release);
+    tail_seg_ = s;
+    tail_pos_ = 0;
+}
+
+template<class T,class Alloc,size_t SegSize>
+template<class InputIterator>
+void unbounded_spsc_queue<T,Alloc,SegSize>::push_n(InputIterator first,size_type n){
+    const size_type t = tail_.load(std::memory_order_relaxed);
+    size_type i = 0;
+    try{
+        for(; i < n; ++i,++first){
+            if(tail_pos_ == SegSize) __next_tail_segment();
+            mjstl::construct(tail_seg_->value(tail_pos_),*first);
+            ++tail_pos_;
+        }
+    }catch(...){
+        tail_.store(t + i,std::memory_order_release);
+        throw;
+    }
+    tail_.store(t + n,std::memory_order_release);
+}
+
+template<class T,class Alloc,size_t SegSize>
+bool unbounded_spsc_queue<T,Alloc,SegSize>::try_pop(T& out){
+    const size_type h = head_.load(std::memory_order_relaxed);
+    if(h == cached_tail_){
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        if(h == cached_tail_)
+            return false;
+    }
+    if(head_pos_ == SegSize) __next_head_segment();
+    pointer p = head_seg_.load(std::memory_order_relaxed)->value(head_pos_);
+    out = mjstl::move(*p);
+    mjstl::destory(p);
+    ++head_pos_;
+    head_.store(h + 1,std::memory_order_release);
+    return true;
+}
+
+template<class T,class Alloc,size_t SegSize>
+template<class OutputIterator>
+typename unbounded_spsc_queue<T,Alloc,SegSize>::size_type
+unbounded_spsc_queue<T,Alloc,SegSize>::try_pop_n(OutputIterator out,size_type n){
+    const size_type h = head_.load(std::memory_order_relaxed);
+    if(cached_tail_ - h < n)
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+    if(n > cached_tail_ - h) n = cached_tail_ - h;
+    for(size_type i = 0; i < n; ++i,++out){
+        if(head_pos_ == SegSize) __next_head_segment();
+        pointer p = head_seg_.load(std::memory_order_relaxed)->value(head_pos_);
+        *out = mjstl::move(*p);
+        mjstl::destory(p);
+        ++head_pos_;
+    }
+    head_.store(h + n,std::memory_order_release);
+    return n;
+}
+
+template<class T,class Alloc,size_t SegSize>
+unbounded_spsc_queue<T,Alloc,SegSize>::~unbounded_spsc_queue(){
+    size_type n = size();
+    segment* s = head_seg_.load(std::memory_order_relaxed);
+    size_type pos = head_pos_;
+    for(; n > 0; --n,++pos){
+        if(pos == SegSize){
+            s = s->next.load(std::memory_order_relaxed);
+            pos = 0;
+        }
+        mjstl::destory(s->value(pos));
+    }
+    for(s = first_; s != nullptr;){
+        segment* next = s->next.load(std::memory_order_relaxed);
+        segment_allocator().deallocate(s);
+        s = next;
+    }
+}
+
+} // namespace mjstl
+#endif // !__SPSC_QUEUE_H__
@@ -0,0 +1,108 @@
+#ifndef __SYNC_UTIL_H__
+#define __SYNC_UTIL_H__
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mjstl
+{
+    /*
+    *   并发容器共用的小工具。
+    *   __CACHE_LINE_SIZE：不同线程写的变量按缓存行隔开，避免伪共享(false sharing)。
+    *   __cpu_relax：自旋等待时提示CPU降低功耗、让出流水线给超线程的另一半。
+    */
+    enum { __CACHE_LINE_SIZE = 64 };
+
+    inline void __cpu_relax(){
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+        _mm_pause();
+#elif defined(__i386__) || defined(__x86_64__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    /*自旋次数不多时只pause，超过spin_limit后让出时间片。*/
+    inline void __spin_wait(unsigned& spins,unsigned spin_limit = 64){
+        if(spins < spin_limit){
+            ++spins;
+            __cpu_relax();
+        }else{
+            std::this_thread::yield();
+        }
+    }
+
+    /*
+    *   __futex_wait：*addr仍等于expected时睡眠，直到被__futex_wake_all唤醒(可能虚假唤醒)。
+    *   调用方用一个"纪元"计数器配合：先读纪元，再检查条件，条件不满足才按读到的纪元睡眠，
+    * 唤醒方先改变条件，再递增纪元并唤醒，这样不会丢失唤醒。
+    *   非Linux平台没有futex，退化为短暂睡眠后重新检查。
+    */
+    inline void __futex_wait(std::atomic<int>* addr,int expected){
+#if defined(__linux__)
+        syscall(SYS_futex,reinterpret_cast<int*>(addr),FUTEX_WAIT_PRIVATE,expected,nullptr,nullptr,0);
+#else
+        if(addr->load(std::memory_order_acquire) == expected)
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+    }
+
+    inline void __futex_wake_all(std::atomic<int>* addr){
+#if defined(__linux__)
+        syscall(SYS_futex,reinterpret_cast<int*>(addr),FUTEX_WAKE_PRIVATE,INT_MAX,nullptr,nullptr,0);
+#else
+        (void)addr;
+#endif
+    }
+
+    /*
+    *   __wait_point：阻塞等待某个条件的地方(如"队列不满")。
+    *   wait：先自旋spin_limit次，再登记为等待者，按纪元在futex上睡眠，try_op成功后返回。
+    *   notify：改变条件的一方调用，没有等待者时只有一次fence和一次读，不进内核。
+    *   两边的seq_cst fence保证：要么notify看到了等待者，要么等待者登记后的try_op看到了新条件。
+    */
+    struct __wait_point{
+        std::atomic<int> epoch;
+        std::atomic<int> waiters;
+
+        __wait_point():epoch(0),waiters(0){}
+
+        template<class TryOp>
+        void wait(TryOp try_op,unsigned spin_limit = 128){
+            unsigned spins = 0;
+            while(spins < spin_limit){
+                if(try_op()) return;
+                __spin_wait(spins);
+            }
+            waiters.fetch_add(1,std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            for(;;){
+                int e = epoch.load(std::memory_order_acquire);
+                if(try_op()) break;
+                __futex_wait(&epoch,e);
+            }
+            waiters.fetch_sub(1,std::memory_order_relaxed);
+        }
+
+        void notify(){
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(waiters.load(std::memory_order_relaxed) != 0){
+                epoch.fetch_add(1,std::memory_order_release);
+                __futex_wake_all(&epoch);
+            }
+        }
+    };
+} // namespace mjstl
+#endif // !__SYNC_UTIL_H__
@@ -10,16 +10,6 @@
 #include "uninitialized.h"
 namespace mjstl
 {
-    template<class T>
-    pair<T*,ptrdiff_t> get_temporary_buffer(ptrdiff_t len){
-        return __get_temporary_buffer(len,(T*)0);
-    }
-
-    template<class T>
-    pair<T*,ptrdiff_t> get_temporary_buffer(ptrdiff_t len,T*){
-        return __get_temporary_buffer(len,(T*)0);
-    }
-
     template<class T>
     pair<T*,ptrdiff_t> __get_temporary_buffer(ptrdiff_t len,T*){
         if(len > ptrdiff_t(INT_MAX / sizeof(T)))
@@ -34,6 +24,16 @@ namespace mjstl
         return pair<T*,ptrdiff_t>((T*)0,0);
     }   
 
+    template<class T>
+    pair<T*,ptrdiff_t> get_temporary_buffer(ptrdiff_t len){
+        return __get_temporary_buffer(len,(T*)0);
+    }
+
+    template<class T>
+    pair<T*,ptrdiff_t> get_temporary_buffer(ptrdiff_t len,T*){
+        return __get_temporary_buffer(len,(T*)0);
+    }
+
     template<class T>
     void return_temporary_buffer(T* ptr){
         free(ptr);
@@ -0,0 +1,148 @@
+#ifndef __CONCURRENT_STACK_TEST_H__
+#define __CONCURRENT_STACK_TEST_H__
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../concurrent_stack.h"
+#include "../stack.h"
+#include "test.h"
+
+namespace mjstl
+{
+namespace test
+{
+namespace concurrent_stack_test
+{
+
+/*互斥锁保护的mjstl::stack，作为比较的基准。*/
+class locked_stack{
+public:
+    void push(int x){
+        std::lock_guard<std::mutex> lock(m_);
+        s_.push(x);
+    }
+    bool try_pop(int& out){
+        std::lock_guard<std::mutex> lock(m_);
+        if(s_.empty()) return false;
+        out = s_.top();
+        s_.pop();
+        return true;
+    }
+private:
+    std::mutex m_;
+    mjstl::stack<int> s_;
+};
+
+/*
+*   threads个线程共做count次操作，每个线程交替push两个、pop两个，
+* 模拟空闲链表上的申请与归还。
+*/
+template<class Stack>
+size_t stack_contention(size_t threads,size_t count){
+    Stack s;
+    std::atomic<size_t> sum(0);
+    size_t per = count / threads / 4;
+    std::vector<std::thread> pool;
+    for(size_t t = 0; t < threads; ++t){
+        pool.push_back(std::thread([&s,&sum,per]{
+            size_t local = 0;
+            int x;
+            for(size_t i = 0; i < per; ++i){
+                s.push(int(i));
+                s.push(int(i));
+                if(s.try_pop(x)) local += x;
+                if(s.try_pop(x)) local += x;
+            }
+            sum += local;
+        }));
+    }
+    for(size_t i = 0; i < pool.size(); ++i)
+        pool[i].join();
+    return sum;
+}
+
+#define CSTACK_DO_TEST(mode, threads, len)                   \
+  WALL_TIME_DO_TEST(stack_contention<mode>(threads, len))
+
+#define CSTACK_TEST(threads, len1, len2, len3)               \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|    mutex + stack    |";                    \
+  CSTACK_DO_TEST(locked_stack, threads, len1);               \
+  CSTACK_DO_TEST(locked_stack, threads, len2);               \
+  CSTACK_DO_TEST(locked_stack, threads, len3);               \
+  std::cout << "\n|  concurrent_stack   |";                  \
+  CSTACK_DO_TEST(mjstl::concurrent_stack<int>, threads, len1); \
+  CSTACK_DO_TEST(mjstl::concurrent_stack<int>, threads, len2); \
+  CSTACK_DO_TEST(mjstl::concurrent_stack<int>, threads, len3);
+
+void concurrent_stack_test()
+{
+    std::cout<<"[===============================================================]"<<std::endl;
+    std::cout<<"[----------- Run container test : concurrent_stack -------------]"<<std::endl;
+    std::cout<<"[---------------------------API test----------------------------]"<<std::endl;
+
+    int b[8] = {0};
+    int x = 0;
+
+    std::cout<<std::boolalpha;
+    mjstl::concurrent_stack<int> s1;
+    FUN_VALUE(s1.is_lock_free());
+    FUN_VALUE(s1.empty());
+    FUN_VALUE(s1.try_pop(x));
+    s1.push(1);
+    s1.push(2);
+    s1.emplace(3);
+    FUN_VALUE(s1.try_pop(x));
+    FUN_VALUE(x);
+    s1.push(4);
+    s1.push(5);
+    FUN_VALUE(s1.pop_all(b) - b);
+    FUN_VALUE(b[0]);
+    FUN_VALUE(b[3]);
+    FUN_VALUE(s1.empty());
+    for(int i = 0; i < 100; ++i) s1.push(i);
+    FUN_VALUE(s1.try_pop(x));
+    FUN_VALUE(x);
+
+    mjstl::concurrent_stack<std::string> s2;
+    std::string out;
+    s2.push("a");
+    s2.push(std::string("b"));
+    FUN_VALUE(s2.try_pop(out));
+    FUN_VALUE(out);
+    std::cout<<std::noboolalpha;
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout<<"[--------------------- Performance Testing ---------------------]"<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|      1 thread       |";
+    CSTACK_TEST(1,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|      2 threads      |";
+    CSTACK_TEST(2,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|      4 threads      |";
+    CSTACK_TEST(4,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|      8 threads      |";
+    CSTACK_TEST(8,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|     16 threads      |";
+    CSTACK_TEST(16,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    PASSED;
+#endif
+    std::cout<<"[----------- End container test : concurrent_stack -------------]"<<std::endl;
+}
+
+} // namespace concurrent_stack_test
+} // namespace test
+} // namespace mjstl
+#endif // !__CONCURRENT_STACK_TEST_H__
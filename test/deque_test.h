@@ -2,7 +2,21 @@
 #define __MJSTL_DEQUE_TEST_H__
 
 #include <deque>
+#include <algorithm>
+#include <vector>
+#if defined(__linux__)
+#include <cstdio>
+#include <malloc.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib,"psapi.lib")
+#endif
 #include "../deque.h"
+#include "../vector.h"
+#include "../algo.h"
+#include "../numeric.h"
 
 #include "test.h"
 
@@ -10,6 +24,191 @@ namespace mjstl{
 namespace test{
 namespace deque_test{
 
+/*
+*   随机访问与排序的性能测试，con为容器类型：
+*   access：按预先生成的随机下标读取count个元素，重复10次；sort：对count个随机数排序。
+*   deque_buf100的缓冲区不是2的幂，用来和默认的2的幂缓冲区对比。
+*/
+typedef mjstl::deque<int,mjstl::alloc,100> deque_buf100;
+
+template<class Con>
+void deque_sort(Con& c){
+    mjstl::sort(c.begin(),c.end());
+}
+
+inline void deque_sort(std::deque<int>& c){
+    std::sort(c.begin(),c.end());
+}
+
+#define DEQUE_RA_DO_TEST(con, fun, count) do {               \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  con c;                                                     \
+  char buf[10];                                              \
+  size_t sum = 0;                                            \
+  std::string f = #fun;                                      \
+  for (size_t i = 0; i < count; ++i) c.push_back(rand());    \
+  if (f == "access") {                                       \
+    std::vector<size_t> idx(count);                          \
+    for (size_t i = 0; i < count; ++i) idx[i] = rand() % count; \
+    start = clock();                                         \
+    for (int k = 0; k < 10; ++k)                             \
+      for (size_t i = 0; i < count; ++i) sum += c[idx[i]];   \
+    end = clock();                                           \
+  } else {                                                   \
+    start = clock();                                         \
+    deque_sort(c);                                           \
+    end = clock();                                           \
+    sum += c[0];                                             \
+  }                                                          \
+  if (sum == 1) std::cout << " ";                            \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define DEQUE_RA_TEST(fun, len1, len2, len3)                 \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         std         |";                    \
+  DEQUE_RA_DO_TEST(std::deque<int>, fun, len1);              \
+  DEQUE_RA_DO_TEST(std::deque<int>, fun, len2);              \
+  DEQUE_RA_DO_TEST(std::deque<int>, fun, len3);              \
+  std::cout << "\n|  mjstl(BufSize 100) |";                  \
+  DEQUE_RA_DO_TEST(deque_buf100, fun, len1);                 \
+  DEQUE_RA_DO_TEST(deque_buf100, fun, len2);                 \
+  DEQUE_RA_DO_TEST(deque_buf100, fun, len3);                 \
+  std::cout << "\n|  mjstl(pow2 buffer) |";                  \
+  DEQUE_RA_DO_TEST(mjstl::deque<int>, fun, len1);            \
+  DEQUE_RA_DO_TEST(mjstl::deque<int>, fun, len2);            \
+  DEQUE_RA_DO_TEST(mjstl::deque<int>, fun, len3);
+
+/*
+*   整段拷贝：把count个元素拷贝到同类型容器中，重复10次。
+*   mjstl::deque走分段迭代器版本的copy，逐块memmove，应与vector相当。
+*/
+template<class Con>
+void deque_copy(const Con& src,Con& dst){
+    mjstl::copy(src.begin(),src.end(),dst.begin());
+}
+
+inline void deque_copy(const std::deque<int>& src,std::deque<int>& dst){
+    std::copy(src.begin(),src.end(),dst.begin());
+}
+
+#define DEQUE_COPY_DO_TEST(con, count) do {                  \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  con src, dst;                                              \
+  char buf[10];                                              \
+  for (size_t i = 0; i < count; ++i) {                       \
+    src.push_back(rand());                                   \
+    dst.push_back(0);                                        \
+  }                                                          \
+  start = clock();                                           \
+  for (int k = 0; k < 10; ++k) deque_copy(src, dst);         \
+  end = clock();                                             \
+  if (dst[count / 2] == 1) std::cout << " ";                 \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define DEQUE_COPY_TEST(len1, len2, len3)                    \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|      std deque      |";                    \
+  DEQUE_COPY_DO_TEST(std::deque<int>, len1);                 \
+  DEQUE_COPY_DO_TEST(std::deque<int>, len2);                 \
+  DEQUE_COPY_DO_TEST(std::deque<int>, len3);                 \
+  std::cout << "\n|    mjstl vector     |";                  \
+  DEQUE_COPY_DO_TEST(mjstl::vector<int>, len1);              \
+  DEQUE_COPY_DO_TEST(mjstl::vector<int>, len2);              \
+  DEQUE_COPY_DO_TEST(mjstl::vector<int>, len3);              \
+  std::cout << "\n|     mjstl deque     |";                  \
+  DEQUE_COPY_DO_TEST(mjstl::deque<int>, len1);               \
+  DEQUE_COPY_DO_TEST(mjstl::deque<int>, len2);               \
+  DEQUE_COPY_DO_TEST(mjstl::deque<int>, len3);
+
+/*
+*   当前进程的常驻内存(RSS)，单位KB，不支持的平台返回0。
+*   先把malloc缓存的空闲内存还给系统，这样测到的是容器仍然持有的内存。
+*/
+inline long deque_rss_kb(){
+#if defined(__linux__)
+    malloc_trim(0);
+    long pages = 0, resident = 0;
+    FILE* f = std::fopen("/proc/self/statm","r");
+    if(!f) return 0;
+    if(std::fscanf(f,"%ld %ld",&pages,&resident) != 2) resident = 0;
+    std::fclose(f);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(),&pmc,sizeof(pmc))) return 0;
+    return long(pmc.WorkingSetSize / 1024);
+#else
+    return 0;
+#endif
+}
+
+/*
+*   突发流量后的内存占用：push_back count个元素再全部pop_front，
+* 输出此时相对开始前的RSS增量。mode：
+*   peak：全部push_back之后；drain：只排空；shrink：排空后shrink_to_fit；
+*   auto：开启自动收缩后排空。
+*/
+#define DEQUE_RSS_DO_TEST(con, mode, count) do {             \
+  char buf[16];                                              \
+  std::string m = #mode;                                     \
+  long before = deque_rss_kb(), after = 0;                   \
+  {                                                          \
+    con c;                                                   \
+    deque_set_auto_shrink(c, m == "auto");                   \
+    for (size_t i = 0; i < count; ++i) c.push_back(int(i));  \
+    if (m == "peak") after = deque_rss_kb();                 \
+    while (!c.empty()) c.pop_front();                        \
+    if (m == "shrink") c.shrink_to_fit();                    \
+    if (m != "peak") after = deque_rss_kb();                 \
+  }                                                          \
+  std::snprintf(buf, sizeof(buf), "%ld", after - before);    \
+  std::string t = buf;                                       \
+  t += "KB   |";                                             \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+template<class Con>
+void deque_set_auto_shrink(Con& c,bool on){ c.set_auto_shrink(on);}
+
+inline void deque_set_auto_shrink(std::deque<int>&,bool){}
+
+#define DEQUE_RSS_TEST(len1, len2, len3)                     \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|     mjstl peak      |";                    \
+  DEQUE_RSS_DO_TEST(mjstl::deque<int>, peak, len1);          \
+  DEQUE_RSS_DO_TEST(mjstl::deque<int>, peak, len2);          \
+  DEQUE_RSS_DO_TEST(mjstl::deque<int>, peak, len3);          \
+  std::cout << "\n|     std drained     |";                  \
+  DEQUE_RSS_DO_TEST(std::deque<int>, shrink, len1);          \
+  DEQUE_RSS_DO_TEST(std::deque<int>, shrink, len2);          \
+  DEQUE_RSS_DO_TEST(std::deque<int>, shrink, len3);          \
+  std::cout << "\n|    mjstl drained    |";                  \
+  DEQUE_RSS_DO_TEST(mjstl::deque<int>, drain, len1);         \
+  DEQUE_RSS_DO_TEST(mjstl::deque<int>, drain, len2);         \
+  DEQUE_RSS_DO_TEST(mjstl::deque<int>, drain, len3);         \
+  std::cout << "\n| mjstl shrink_to_fit |";                  \
+  DEQUE_RSS_DO_TEST(mjstl::deque<int>, shrink, len1);        \
+  DEQUE_RSS_DO_TEST(mjstl::deque<int>, shrink, len2);        \
+  DEQUE_RSS_DO_TEST(mjstl::deque<int>, shrink, len3);        \
+  std::cout << "\n|  mjstl auto shrink  |";                  \
+  DEQUE_RSS_DO_TEST(mjstl::deque<int>, auto, len1);          \
+  DEQUE_RSS_DO_TEST(mjstl::deque<int>, auto, len2);          \
+  DEQUE_RSS_DO_TEST(mjstl::deque<int>, auto, len3);
+
 void deque_test(){
     std::cout<<"[===============================================================]"<<std::endl;
     std::cout<<"[----------------- Run container test : deque ------------------]"<<std::endl;
@@ -46,7 +245,14 @@ void deque_test(){
     FUN_AFTER(d1,d1.pop_front());
     FUN_AFTER(d1,d1.resize(5));
     FUN_AFTER(d1,d1.resize(16,8));
+    FUN_AFTER(d1,d1.push_back(3));
+    FUN_AFTER(d1,mjstl::erase_if(d1,[](int x){ return x == 8;}));
+    FUN_AFTER(d1,d1.append(a,a + 5));
+    FUN_AFTER(d1,d1.prepend(a,a + 3));
+    FUN_AFTER(d1,d1.pop_front_n(2,a));
+    FUN_AFTER(d1,d1.pop_back_n(2,a + 3));
     FUN_AFTER(d1,d1.clear());
+    FUN_AFTER(d1,d1.shrink_to_fit());
     FUN_AFTER(d1,d1.swap(d4));
     FUN_AFTER(d4,d4.size());
     FUN_VALUE(*(d1.begin()));
@@ -57,6 +263,22 @@ void deque_test(){
     FUN_VALUE(d1.back());
     FUN_VALUE(d1.at(1));
     FUN_VALUE(d1[2]);
+    FUN_VALUE(*mjstl::find(d10.begin(),d10.end(),12));
+    FUN_VALUE(mjstl::accumulate(d10.begin(),d10.end(),0));
+    FUN_AFTER(d10,mjstl::copy(d9.begin(),d9.end(),d10.begin() + 3));
+    FUN_AFTER(d10,mjstl::fill(d10.begin(),d10.begin() + 3,0));
+
+    /*非平凡类型，删除的区间跨越多个缓冲区。*/
+    mjstl::deque<std::string> ds(1000);
+    for(size_t i = 0; i < ds.size(); ++i)
+        ds[i] = std::to_string(i);
+    FUN_VALUE(mjstl::erase_if(ds,[](const std::string& s){ return s.back() != '0';}));
+    FUN_VALUE(ds.size());
+    FUN_VALUE(ds.back());
+    ds.erase(ds.begin() + 1,ds.begin() + 60);
+    FUN_VALUE(ds.size());
+    FUN_VALUE(ds.front());
+    FUN_VALUE(ds[1]);
 
     std::cout<< std::boolalpha;
     FUN_VALUE(d1.empty());
@@ -82,6 +304,30 @@ void deque_test(){
 #else
     CON_TEST_P1(deque<int>,push_back,rand(),SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
 #endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"| random access x 10  |";
+#if LARGER_TEST_DATA_ON
+    DEQUE_RA_TEST(access,SCALE_LL(LEN1),SCALE_LL(LEN2),SCALE_LL(LEN3));
+#else
+    DEQUE_RA_TEST(access,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+#endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|        sort         |";
+    DEQUE_RA_TEST(sort,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|      copy x 10      |";
+#if LARGER_TEST_DATA_ON
+    DEQUE_COPY_TEST(SCALE_LL(LEN1),SCALE_LL(LEN2),SCALE_LL(LEN3));
+#else
+    DEQUE_COPY_TEST(SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+#endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|  RSS after a burst  |";
+    DEQUE_RSS_TEST(SCALE_LL(LEN1),SCALE_LL(LEN2),SCALE_LL(LEN3));
     std::cout<<std::endl;
     std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
     PASSED;
@@ -0,0 +1,167 @@
+#ifndef __FLAT_COMBINING_TEST_H__
+#define __FLAT_COMBINING_TEST_H__
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../flat_combining.h"
+#include "test.h"
+
+namespace mjstl
+{
+namespace test
+{
+namespace flat_combining_test
+{
+
+/*一把互斥锁包住同一个适配器，作为比较的基准。*/
+template<class Adapter>
+class locked{
+public:
+    typedef typename Adapter::value_type value_type;
+    void push(const value_type& x){
+        std::lock_guard<std::mutex> lock(m_);
+        c_.push(x);
+    }
+    bool try_pop(value_type& out){
+        std::lock_guard<std::mutex> lock(m_);
+        return mjstl::__fc_take(c_,out);
+    }
+private:
+    std::mutex m_;
+    Adapter c_;
+};
+
+typedef mjstl::stack<int>           int_stack;
+typedef mjstl::queue<int>           int_queue;
+typedef mjstl::priority_queue<int>  int_heap;
+
+/*threads个线程共做count次操作，每个线程交替push两个、pop两个。*/
+template<class Concurrent>
+size_t fc_contention(size_t threads,size_t count){
+    Concurrent c;
+    std::atomic<size_t> sum(0);
+    size_t per = count / threads / 4;
+    std::vector<std::thread> pool;
+    for(size_t t = 0; t < threads; ++t){
+        pool.push_back(std::thread([&c,&sum,per]{
+            size_t local = 0;
+            int x;
+            for(size_t i = 0; i < per; ++i){
+                c.push(int(i));
+                c.push(int(per - i));
+                if(c.try_pop(x)) local += x;
+                if(c.try_pop(x)) local += x;
+            }
+            sum += local;
+        }));
+    }
+    for(size_t i = 0; i < pool.size(); ++i)
+        pool[i].join();
+    return sum;
+}
+
+#define FC_DO_TEST(mode, threads, len)                       \
+  WALL_TIME_DO_TEST(fc_contention<mode>(threads, len))
+
+#define FC_ROW(label, mode, threads, len1, len2, len3)       \
+  std::cout << label;                                        \
+  FC_DO_TEST(mode, threads, len1);                           \
+  FC_DO_TEST(mode, threads, len2);                           \
+  FC_DO_TEST(mode, threads, len3);
+
+#define FC_TEST(threads, len1, len2, len3)                   \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  FC_ROW("|    mutex + stack    |", locked<int_stack>,                     \
+    threads, len1, len2, len3);                              \
+  FC_ROW("\n|  fc<stack>          |", mjstl::flat_combining<int_stack>,    \
+    threads, len1, len2, len3);                              \
+  FC_ROW("\n|    mutex + queue    |", locked<int_queue>,                   \
+    threads, len1, len2, len3);                              \
+  FC_ROW("\n|  fc<queue>          |", mjstl::flat_combining<int_queue>,    \
+    threads, len1, len2, len3);                              \
+  FC_ROW("\n|  mutex + prio_queue |", locked<int_heap>,                    \
+    threads, len1, len2, len3);                              \
+  FC_ROW("\n|  fc<priority_queue> |", mjstl::flat_combining<int_heap>,     \
+    threads, len1, len2, len3);
+
+void flat_combining_test()
+{
+    std::cout<<"[===============================================================]"<<std::endl;
+    std::cout<<"[------------ Run container test : flat_combining --------------]"<<std::endl;
+    std::cout<<"[---------------------------API test----------------------------]"<<std::endl;
+
+    int x = 0;
+
+    std::cout<<std::boolalpha;
+    mjstl::flat_combining<int_stack> s1;
+    FUN_VALUE(s1.empty());
+    FUN_VALUE(s1.try_pop(x));
+    s1.push(1);
+    s1.push(2);
+    s1.push(3);
+    FUN_VALUE(s1.size());
+    FUN_VALUE(s1.try_pop(x));
+    FUN_VALUE(x);
+
+    mjstl::flat_combining<int_queue> q1;
+    q1.push(1);
+    q1.push(2);
+    q1.push(3);
+    FUN_VALUE(q1.try_pop(x));
+    FUN_VALUE(x);
+    q1.apply([](int_queue& q){ q.push(q.front() * 10); q.pop();});
+    FUN_VALUE(q1.size());
+    q1.try_pop(x);
+    q1.try_pop(x);
+    FUN_VALUE(x);
+
+    mjstl::flat_combining<int_heap> p1;
+    p1.push(5);
+    p1.push(9);
+    p1.push(1);
+    FUN_VALUE(p1.try_pop(x));
+    FUN_VALUE(x);
+
+    mjstl::flat_combining<mjstl::queue<std::string>> q2;
+    std::string out;
+    q2.push("a");
+    q2.push(std::string("b"));
+    q2.try_pop(out);
+    FUN_VALUE(out);
+    FUN_VALUE(q2.size());
+    std::cout<<std::noboolalpha;
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout<<"[--------------------- Performance Testing ---------------------]"<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|      1 thread       |";
+    FC_TEST(1,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|      2 threads      |";
+    FC_TEST(2,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|      4 threads      |";
+    FC_TEST(4,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|      8 threads      |";
+    FC_TEST(8,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|     16 threads      |";
+    FC_TEST(16,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    PASSED;
+#endif
+    std::cout<<"[------------ End container test : flat_combining --------------]"<<std::endl;
+}
+
+} // namespace flat_combining_test
+} // namespace test
+} // namespace mjstl
+#endif // !__FLAT_COMBINING_TEST_H__
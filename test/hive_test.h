@@ -0,0 +1,156 @@
+#ifndef __HIVE_TEST_H__
+#define __HIVE_TEST_H__
+
+#include "../hive.h"
+#include "../list.h"
+#include "../vector.h"
+#include "test.h"
+
+namespace mjstl
+{
+namespace test
+{
+namespace hive_test
+{
+
+/*
+*   性能测试辅助函数，三种容器各自用最自然的写法：
+*   hive_insert：插入count个元素。
+*   hive_erase：删除一半元素，list、hive按迭代器逐个删除，vector用erase_if一次删除。
+*   hive_iterate：遍历求和10次。
+*/
+template<class Con>
+void hive_insert(Con& c,size_t count){
+    for(size_t i = 0; i < count; ++i)
+        c.push_back(rand());
+}
+
+inline void hive_insert(mjstl::hive<int>& c,size_t count){
+    for(size_t i = 0; i < count; ++i)
+        c.insert(rand());
+}
+
+template<class Con>
+void hive_erase(Con& c){
+    for(auto it = c.begin(); it != c.end();){
+        if(*it & 1) it = c.erase(it);
+        else ++it;
+    }
+}
+
+inline void hive_erase(mjstl::vector<int>& c){
+    mjstl::erase_if(c,[](int x){ return x & 1;});
+}
+
+template<class Con>
+size_t hive_iterate(Con& c){
+    size_t sum = 0;
+    for(int i = 0; i < 10; ++i)
+        for(auto it = c.begin(); it != c.end(); ++it)
+            sum += *it;
+    return sum;
+}
+
+/*mode为容器类型，fun为insert、erase、iterate之一，除insert外计时前先插入count个元素。*/
+#define HIVE_DO_TEST(mode, fun, count) do {                  \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  mode c;                                                    \
+  char buf[10];                                              \
+  size_t sum = 0;                                            \
+  std::string f = #fun;                                      \
+  if (f != "insert") {                                       \
+    hive_insert(c, count);                                   \
+    if (f == "iterate") hive_erase(c);                       \
+  }                                                          \
+  start = clock();                                           \
+  if (f == "insert") hive_insert(c, count);                  \
+  else if (f == "erase") hive_erase(c);                      \
+  else sum += hive_iterate(c);                               \
+  end = clock();                                             \
+  if (sum == 1) std::cout << " ";                            \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define HIVE_TEST(fun, len1, len2, len3)                     \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|        list         |";                    \
+  HIVE_DO_TEST(mjstl::list<int>, fun, len1);                 \
+  HIVE_DO_TEST(mjstl::list<int>, fun, len2);                 \
+  HIVE_DO_TEST(mjstl::list<int>, fun, len3);                 \
+  std::cout << "\n|       vector        |";                  \
+  HIVE_DO_TEST(mjstl::vector<int>, fun, len1);               \
+  HIVE_DO_TEST(mjstl::vector<int>, fun, len2);               \
+  HIVE_DO_TEST(mjstl::vector<int>, fun, len3);               \
+  std::cout << "\n|        hive         |";                  \
+  HIVE_DO_TEST(mjstl::hive<int>, fun, len1);                 \
+  HIVE_DO_TEST(mjstl::hive<int>, fun, len2);                 \
+  HIVE_DO_TEST(mjstl::hive<int>, fun, len3);
+
+void hive_test()
+{
+    std::cout<<"[===============================================================]"<<std::endl;
+    std::cout<<"[----------------- Run container test : hive -------------------]"<<std::endl;
+    std::cout<<"[---------------------------API test----------------------------]"<<std::endl;
+
+    int a[] = {1,2,3,4,5,6,7,8,9,10};
+
+    mjstl::hive<int> h1;
+    mjstl::hive<int> h2(5,8);
+    mjstl::hive<int> h3(a,a + sizeof(a)/sizeof(int));
+    mjstl::hive<int> h4{1,2,3};
+    mjstl::hive<int> h5(h3);
+    mjstl::hive<int> h6(std::move(h5));
+
+    std::cout<<std::boolalpha;
+    FUN_AFTER(h1,h1.insert(1));
+    FUN_AFTER(h1,h1.insert(2));
+    FUN_AFTER(h1,h1.emplace(3));
+    FUN_AFTER(h1,h1.insert(3,4));
+    FUN_AFTER(h1,h1.insert(a,a + 3));
+    int* p = &*(--h3.end());
+    FUN_AFTER(h3,h3.erase(h3.begin()));
+    FUN_AFTER(h3,h3.erase(++h3.begin(),++++++h3.begin()));
+    FUN_AFTER(h3,h3.insert(100));
+    FUN_VALUE((p == &*h3.get_iterator(p)));
+    FUN_VALUE(*h3.get_iterator(p));
+    FUN_VALUE(*h3.rbegin());
+    FUN_VALUE(h3.size());
+    FUN_VALUE(h3.capacity());
+    FUN_AFTER(h3,h3.swap(h4));
+    FUN_VALUE(h6.size());
+    FUN_AFTER(h6,h6.erase(h6.begin(),h6.end()));
+    FUN_VALUE(h6.empty());
+    FUN_AFTER(h2,h2.clear());
+    FUN_VALUE(h2.size());
+    std::cout<<std::noboolalpha;
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout<<"[--------------------- Performance Testing ---------------------]"<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|       insert        |";
+    HIVE_TEST(insert,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|     erase half      |";
+    HIVE_TEST(erase,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|    iterate x 10     |";
+    HIVE_TEST(iterate,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    PASSED;
+#endif
+    std::cout<<"[----------------- End container test : hive -------------------]"<<std::endl;
+}
+
+} // namespace hive_test
+} // namespace test
+} // namespace mjstl
+#endif // !__HIVE_TEST_H__
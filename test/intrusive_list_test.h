@@ -0,0 +1,177 @@
+#ifndef __INTRUSIVE_LIST_TEST_H__
+#define __INTRUSIVE_LIST_TEST_H__
+
+#include "../intrusive_list.h"
+#include "../list.h"
+#include "../vector.h"
+#include "test.h"
+
+namespace mjstl
+{
+namespace test
+{
+namespace intrusive_list_test
+{
+
+struct conn{
+    int fd;
+    mjstl::list_hook hook;
+
+    conn(int x = 0):fd(x){}
+    bool operator<(const conn& rhs) const { return fd < rhs.fd;}
+};
+
+struct timer{
+    int id;
+    mjstl::auto_unlink_list_hook hook;
+};
+
+typedef mjstl::intrusive_list<conn,&conn::hook>                 conn_list;
+typedef mjstl::auto_unlink_intrusive_list<timer,&timer::hook>   timer_list;
+
+/*
+*   LRU缓存：容量cap，key取值[0,keys)，共访问count次。
+*   命中时把元素移到表头；不命中时淘汰表尾，新元素放到表头。
+*/
+enum { LRU_KEYS = 1 << 14, LRU_CAP = 1 << 12 };
+
+/*mjstl::list版本：每个key记录迭代器，淘汰、插入都要释放、申请节点。*/
+size_t lru_list(size_t count){
+    mjstl::list<int> l;
+    mjstl::vector<mjstl::list<int>::iterator> where(LRU_KEYS);
+    mjstl::vector<char> cached(LRU_KEYS,0);
+    size_t hits = 0;
+    for(size_t i = 0; i < count; ++i){
+        int key = rand() % LRU_KEYS;
+        if(cached[key]){
+            ++hits;
+            l.splice(l.begin(),l,where[key]);
+            continue;
+        }
+        if(l.size() == LRU_CAP){
+            cached[l.back()] = 0;
+            l.pop_back();
+        }
+        l.push_front(key);
+        where[key] = l.begin();
+        cached[key] = 1;
+    }
+    return hits;
+}
+
+/*intrusive_list版本：对象预先分配在池里，只改链接。*/
+size_t lru_intrusive(size_t count){
+    mjstl::vector<conn> pool(LRU_KEYS);
+    for(int i = 0; i < LRU_KEYS; ++i) pool[i].fd = i;
+    conn_list l;
+    size_t n = 0;
+    size_t hits = 0;
+    for(size_t i = 0; i < count; ++i){
+        conn& c = pool[rand() % LRU_KEYS];
+        if(c.hook.is_linked()){
+            ++hits;
+            l.splice(l.begin(),l,conn_list::iterator_to(c));
+            continue;
+        }
+        if(n == LRU_CAP)
+            l.pop_back();
+        else
+            ++n;
+        l.push_front(c);
+    }
+    return hits;
+}
+
+#define LRU_DO_TEST(fun, len) do {                           \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  size_t hits = 0;                                           \
+  start = clock();                                           \
+  hits += fun(len);                                          \
+  end = clock();                                             \
+  if (hits == 1) std::cout << " ";                           \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define LRU_TEST(len1, len2, len3)                           \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|     mjstl::list     |";                    \
+  LRU_DO_TEST(lru_list, len1);                               \
+  LRU_DO_TEST(lru_list, len2);                               \
+  LRU_DO_TEST(lru_list, len3);                               \
+  std::cout << "\n|   intrusive_list    |";                  \
+  LRU_DO_TEST(lru_intrusive, len1);                          \
+  LRU_DO_TEST(lru_intrusive, len2);                          \
+  LRU_DO_TEST(lru_intrusive, len3);
+
+void intrusive_list_test()
+{
+    std::cout<<"[===============================================================]"<<std::endl;
+    std::cout<<"[------------ Run container test : intrusive_list --------------]"<<std::endl;
+    std::cout<<"[---------------------------API test----------------------------]"<<std::endl;
+
+    conn c[6] = {5,3,1,4,2,6};
+
+    std::cout<<std::boolalpha;
+    conn_list l1;
+    FUN_VALUE(l1.empty());
+    l1.push_back(c[0]);
+    l1.push_back(c[1]);
+    l1.push_front(c[2]);
+    FUN_VALUE(l1.size());
+    FUN_VALUE(l1.front().fd);
+    FUN_VALUE(l1.back().fd);
+    FUN_VALUE(c[0].hook.is_linked());
+    c[0].hook.unlink();
+    FUN_VALUE(c[0].hook.is_linked());
+    FUN_VALUE(l1.size());
+    conn_list l2(c + 3,c + 6);
+    l1.splice(l1.end(),l2);
+    FUN_VALUE(l1.size());
+    FUN_VALUE(l2.empty());
+    l1.sort();
+    FUN_VALUE(l1.front().fd);
+    FUN_VALUE(l1.back().fd);
+    l1.splice(l1.begin(),l1,conn_list::iterator_to(c[5]));
+    FUN_VALUE(l1.front().fd);
+    l1.reverse();
+    FUN_VALUE(l1.front().fd);
+    l1.remove_if([](const conn& x){ return x.fd % 2 == 0;});
+    FUN_VALUE(l1.size());
+    l1.clear();
+    FUN_VALUE(c[2].hook.is_linked());
+
+    timer_list l3;
+    {
+        timer t1, t2;
+        t1.id = 1;
+        t2.id = 2;
+        l3.push_back(t1);
+        l3.push_back(t2);
+        FUN_VALUE(l3.size());
+    }
+    FUN_VALUE(l3.empty());
+    std::cout<<std::noboolalpha;
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout<<"[--------------------- Performance Testing ---------------------]"<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|      LRU cache      |";
+    LRU_TEST(SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    PASSED;
+#endif
+    std::cout<<"[------------ End container test : intrusive_list --------------]"<<std::endl;
+}
+
+} // namespace intrusive_list_test
+} // namespace test
+} // namespace mjstl
+#endif // !__INTRUSIVE_LIST_TEST_H__
@@ -11,7 +11,73 @@ namespace test
 {
 namespace list_test
 {
-    
+
+/*较大的POD元素，用来比较插入时拷贝的开销。*/
+struct big_pod{
+    char buf[256];
+};
+
+/*
+*   先和另一条list交替插入count个元素，再按步长7走一遍，每步删掉一个元素、在末尾补一个，
+* 模拟长期运行后节点在堆上散开。
+*/
+template<class List>
+void list_churn(List& l,mjstl::list<int>& other,size_t count){
+    for(size_t i = 0; i < count; ++i){
+        l.push_back(rand());
+        other.push_back(rand());
+    }
+    auto it = l.begin();
+    for(size_t i = 0; i < count; ++i){
+        for(int k = 0; k < 7; ++k)
+            if(++it == l.end()) it = l.begin();
+        it = l.erase(it);
+        if(it == l.end()) it = l.begin();
+        l.push_back(rand());
+    }
+}
+
+/*计时遍历求和10次，pack为true时把compact()也算进去。*/
+#define LIST_CHURN_DO_TEST(mode, pack, count) do {           \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  mode l;                                                    \
+  mjstl::list<int> other;                                    \
+  char buf[10];                                              \
+  size_t sum = 0;                                            \
+  list_churn(l, other, count);                               \
+  start = clock();                                           \
+  if (pack) l.compact();                                     \
+  for (int i = 0; i < 10; ++i)                               \
+    for (auto it = l.begin(); it != l.end(); ++it)           \
+      sum += *it;                                            \
+  end = clock();                                             \
+  if (sum == 1) std::cout << " ";                            \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define LIST_CHURN_TEST(len1, len2, len3)                    \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|        list         |";                    \
+  LIST_CHURN_DO_TEST(mjstl::list<int>, false, len1);         \
+  LIST_CHURN_DO_TEST(mjstl::list<int>, false, len2);         \
+  LIST_CHURN_DO_TEST(mjstl::list<int>, false, len3);         \
+  std::cout << "\n|      list_slab      |";                  \
+  LIST_CHURN_DO_TEST(slab_list, false, len1);                \
+  LIST_CHURN_DO_TEST(slab_list, false, len2);                \
+  LIST_CHURN_DO_TEST(slab_list, false, len3);                \
+  std::cout << "\n|  compact + iterate  |";                  \
+  LIST_CHURN_DO_TEST(slab_list, true, len1);                 \
+  LIST_CHURN_DO_TEST(slab_list, true, len2);                 \
+  LIST_CHURN_DO_TEST(slab_list, true, len3);
+
+typedef mjstl::list<int,mjstl::list_slab<>> slab_list;
+
 void list_test()
 {
     std::cout<<"[===============================================================]"<<std::endl;
@@ -72,6 +138,12 @@ void list_test()
     FUN_VALUE(l1.size());
     FUN_AFTER(l1,l1.pop_back());
     FUN_VALUE(l1.size());
+    FUN_AFTER(l1,l1.emplace_back(11));
+    FUN_AFTER(l1,l1.emplace_front(0));
+    FUN_AFTER(l1,l1.emplace(++l1.begin(),5));
+    FUN_VALUE(l1.size());
+    FUN_AFTER(l1,l1.pop_back());
+    FUN_AFTER(l1,l1.pop_front());
     FUN_AFTER(l1,l1.resize(10,108));
     FUN_VALUE(l1.size());
 
@@ -89,7 +161,29 @@ void list_test()
     FUN_AFTER(l1,l1.unique());
     FUN_AFTER(l1,l1.remove(108));
     FUN_AFTER(l1,l1.remove_if([](int x){ return x == 0;}));
+    FUN_AFTER(l1,mjstl::erase_if(l1,[](int x){ return x % 2 == 0;}));
     FUN_AFTER(l1,l1.reverse());
+    FUN_AFTER(l1,l1.assign(a,a + sizeof(a)/sizeof(int)));
+    FUN_AFTER(l1,l1.sort([](int x,int y){ return x > y;}));
+
+    mjstl::list<std::string> ls;
+    std::string str = "b";
+    ls.emplace_back(3,'a');
+    ls.push_back(str);
+    ls.push_back(mjstl::move(str));
+    ls.insert(ls.begin(),std::string("c"));
+    FUN_VALUE(ls.front());
+    FUN_VALUE(ls.back());
+    FUN_VALUE(ls.size());
+
+    slab_list lp{5,3,1};
+    slab_list lq{4,2};
+    FUN_AFTER(lp,lp.splice(lp.begin(),lq,lq.begin()));
+    FUN_AFTER(lp,lp.sort());
+    FUN_AFTER(lp,lp.merge(lq));
+    FUN_VALUE(lq.empty());
+    FUN_AFTER(lp,lp.reverse());
+    FUN_AFTER(lp,lp.compact());
     PASSED;
 
 #if PERFORMANCE_TEST_ON
@@ -101,6 +195,32 @@ void list_test()
 #else
     CON_TEST_P1(list<int>,push_back,rand(),SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
 #endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::string s(32,'x');
+    big_pod pod = {};
+    std::cout<<"|  push_back(string)  |";
+    CON_TEST_P1(list<std::string>,push_back,s,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"| emplace_back(string)|";
+    CON_TEST_P1(list<std::string>,emplace_back,"emplace a long string in place",LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|  push_back(big_pod) |";
+    CON_TEST_P1(list<big_pod>,push_back,pod,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|        sort         |";
+#if LARGER_TEST_DATA_ON
+    LIST_SORT_TEST(SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+#else
+    LIST_SORT_TEST(LEN1,LEN2,LEN3);
+#endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"| iterate after churn |";
+    LIST_CHURN_TEST(LEN1,LEN2,LEN3);
     std::cout<<std::endl;
     std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
     PASSED;
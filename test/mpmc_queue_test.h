@@ -0,0 +1,160 @@
+#ifndef __MPMC_QUEUE_TEST_H__
+#define __MPMC_QUEUE_TEST_H__
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../mpmc_queue.h"
+#include "../queue.h"
+#include "test.h"
+
+namespace mjstl
+{
+namespace test
+{
+namespace mpmc_queue_test
+{
+
+/*互斥锁加两个条件变量保护的有界mjstl::queue，作为比较的基准。*/
+class locked_bounded_queue{
+public:
+    explicit locked_bounded_queue(size_t capacity):cap_(capacity){}
+    void push(int x){
+        std::unique_lock<std::mutex> lock(m_);
+        not_full_.wait(lock,[&]{ return q_.size() < cap_;});
+        q_.push(x);
+        lock.unlock();
+        not_empty_.notify_one();
+    }
+    void pop(int& out){
+        std::unique_lock<std::mutex> lock(m_);
+        not_empty_.wait(lock,[&]{ return !q_.empty();});
+        out = q_.front();
+        q_.pop();
+        lock.unlock();
+        not_full_.notify_one();
+    }
+private:
+    size_t cap_;
+    std::mutex m_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    mjstl::queue<int> q_;
+};
+
+/*
+*   threads个生产者、threads个消费者，共传递count个int，队列容量1024。
+*   每个生产者push count / threads个，每个消费者pop count / threads个。
+*/
+template<class Queue>
+size_t mpmc_contention(size_t threads,size_t count){
+    Queue q(1024);
+    std::atomic<size_t> sum(0);
+    size_t per = count / threads;
+    std::vector<std::thread> pool;
+    for(size_t t = 0; t < threads; ++t){
+        pool.push_back(std::thread([&q,per,t]{
+            for(size_t i = 0; i < per; ++i)
+                q.push(int(t * per + i));
+        }));
+        pool.push_back(std::thread([&q,&sum,per]{
+            size_t local = 0;
+            int x;
+            for(size_t i = 0; i < per; ++i){
+                q.pop(x);
+                local += x;
+            }
+            sum += local;
+        }));
+    }
+    for(size_t i = 0; i < pool.size(); ++i)
+        pool[i].join();
+    return sum;
+}
+
+#define MPMC_DO_TEST(mode, threads, len)                     \
+  WALL_TIME_DO_TEST(mpmc_contention<mode>(threads, len))
+
+#define MPMC_TEST(threads, len1, len2, len3)                 \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|    mutex + queue    |";                    \
+  MPMC_DO_TEST(locked_bounded_queue, threads, len1);         \
+  MPMC_DO_TEST(locked_bounded_queue, threads, len2);         \
+  MPMC_DO_TEST(locked_bounded_queue, threads, len3);         \
+  std::cout << "\n|     mpmc_queue      |";                  \
+  MPMC_DO_TEST(mjstl::mpmc_queue<int>, threads, len1);       \
+  MPMC_DO_TEST(mjstl::mpmc_queue<int>, threads, len2);       \
+  MPMC_DO_TEST(mjstl::mpmc_queue<int>, threads, len3);
+
+void mpmc_queue_test()
+{
+    std::cout<<"[===============================================================]"<<std::endl;
+    std::cout<<"[-------------- Run container test : mpmc_queue ----------------]"<<std::endl;
+    std::cout<<"[---------------------------API test----------------------------]"<<std::endl;
+
+    int a[] = {1,2,3,4,5,6,7,8};
+    int b[8] = {0};
+    int x = 0;
+
+    std::cout<<std::boolalpha;
+    mjstl::mpmc_queue<int> q1(6);
+    FUN_VALUE(q1.capacity());
+    FUN_VALUE(q1.try_push(1));
+    FUN_VALUE(q1.try_emplace(2));
+    FUN_VALUE(q1.try_push_n(a,8));
+    FUN_VALUE(q1.try_push(9));
+    FUN_VALUE(q1.size());
+    FUN_VALUE(q1.try_pop(x));
+    FUN_VALUE(x);
+    FUN_VALUE(q1.try_pop_n(b,3));
+    FUN_VALUE(b[2]);
+    q1.push(10);
+    q1.pop(x);
+    FUN_VALUE(x);
+    FUN_VALUE(q1.try_pop_n(b,8));
+    FUN_VALUE(b[3]);
+    FUN_VALUE(q1.empty());
+
+    mjstl::mpmc_queue<std::string> q2(4);
+    q2.push("a");
+    q2.push(std::string("b"));
+    std::string out;
+    q2.pop(out);
+    FUN_VALUE(out);
+    FUN_VALUE(q2.size());
+    std::cout<<std::noboolalpha;
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout<<"[--------------------- Performance Testing ---------------------]"<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|   1 producer  + 1   |";
+    MPMC_TEST(1,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|   2 producers + 2   |";
+    MPMC_TEST(2,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|   4 producers + 4   |";
+    MPMC_TEST(4,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|   8 producers + 8   |";
+    MPMC_TEST(8,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|  16 producers + 16  |";
+    MPMC_TEST(16,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    PASSED;
+#endif
+    std::cout<<"[-------------- End container test : mpmc_queue ----------------]"<<std::endl;
+}
+
+} // namespace mpmc_queue_test
+} // namespace test
+} // namespace mjstl
+#endif // !__MPMC_QUEUE_TEST_H__
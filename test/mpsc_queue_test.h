@@ -0,0 +1,148 @@
+#ifndef __MPSC_QUEUE_TEST_H__
+#define __MPSC_QUEUE_TEST_H__
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../mpsc_queue.h"
+#include "../queue.h"
+#include "test.h"
+
+namespace mjstl
+{
+namespace test
+{
+namespace mpsc_queue_test
+{
+
+/*事件循环里的任务，节点直接嵌在任务对象中。*/
+struct task{
+    int id;
+    mjstl::mpsc_hook hook;
+};
+
+typedef mjstl::intrusive_mpsc_queue<task,&task::hook>   task_queue;
+
+/*互斥锁保护的mjstl::queue<task*>，消费者加一次锁取走当前所有任务。*/
+class locked_task_queue{
+public:
+    void push(task* t){
+        std::lock_guard<std::mutex> lock(m_);
+        q_.push(t);
+    }
+    template<class Function>
+    size_t drain(Function f){
+        std::lock_guard<std::mutex> lock(m_);
+        size_t n = 0;
+        for(; !q_.empty(); ++n){
+            f(q_.front());
+            q_.pop();
+        }
+        return n;
+    }
+private:
+    std::mutex m_;
+    mjstl::queue<task*> q_;
+};
+
+/*producers个线程各提交count / producers个任务，一个消费者线程批量取出执行。*/
+template<class Queue>
+size_t mpsc_submit(size_t producers,size_t count){
+    Queue q;
+    size_t per = count / producers;
+    std::vector<task> tasks(per * producers);
+    for(size_t i = 0; i < tasks.size(); ++i)
+        tasks[i].id = int(i);
+    size_t sum = 0;
+    std::thread loop([&]{
+        size_t done = 0;
+        unsigned spins = 0;
+        while(done < tasks.size()){
+            size_t n = q.drain([&](task* t){ sum += t->id;});
+            if(n == 0) mjstl::__spin_wait(spins);
+            else spins = 0;
+            done += n;
+        }
+    });
+    std::vector<std::thread> pool;
+    for(size_t p = 0; p < producers; ++p){
+        pool.push_back(std::thread([&q,&tasks,per,p]{
+            for(size_t i = 0; i < per; ++i)
+                q.push(&tasks[p * per + i]);
+        }));
+    }
+    for(size_t i = 0; i < pool.size(); ++i)
+        pool[i].join();
+    loop.join();
+    return sum;
+}
+
+#define MPSC_DO_TEST(mode, producers, len)                   \
+  WALL_TIME_DO_TEST(mpsc_submit<mode>(producers, len))
+
+#define MPSC_TEST(producers, len1, len2, len3)               \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|    mutex + queue    |";                    \
+  MPSC_DO_TEST(locked_task_queue, producers, len1);          \
+  MPSC_DO_TEST(locked_task_queue, producers, len2);          \
+  MPSC_DO_TEST(locked_task_queue, producers, len3);          \
+  std::cout << "\n|     mpsc_queue      |";                  \
+  MPSC_DO_TEST(task_queue, producers, len1);                 \
+  MPSC_DO_TEST(task_queue, producers, len2);                 \
+  MPSC_DO_TEST(task_queue, producers, len3);
+
+void mpsc_queue_test()
+{
+    std::cout<<"[===============================================================]"<<std::endl;
+    std::cout<<"[-------------- Run container test : mpsc_queue ----------------]"<<std::endl;
+    std::cout<<"[---------------------------API test----------------------------]"<<std::endl;
+
+    task t[5];
+    for(int i = 0; i < 5; ++i) t[i].id = i + 1;
+
+    std::cout<<std::boolalpha;
+    task_queue q1;
+    FUN_VALUE(q1.empty());
+    FUN_VALUE((q1.try_pop() == nullptr));
+    q1.push(&t[0]);
+    q1.push(&t[1]);
+    q1.push(&t[2]);
+    FUN_VALUE(q1.empty());
+    FUN_VALUE(q1.try_pop()->id);
+    q1.push(&t[3]);
+    q1.push(&t[4]);
+    int ran = 0;
+    FUN_VALUE(q1.drain([&](task* x){ ran = ran * 10 + x->id;},3));
+    FUN_VALUE(ran);
+    FUN_VALUE(q1.try_pop()->id);
+    FUN_VALUE(q1.empty());
+    q1.push(&t[0]);
+    FUN_VALUE(q1.try_pop()->id);
+    FUN_VALUE((q1.try_pop() == nullptr));
+    std::cout<<std::noboolalpha;
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout<<"[--------------------- Performance Testing ---------------------]"<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|    1 producer       |";
+    MPSC_TEST(1,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|    4 producers      |";
+    MPSC_TEST(4,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|   16 producers      |";
+    MPSC_TEST(16,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    PASSED;
+#endif
+    std::cout<<"[-------------- End container test : mpsc_queue ----------------]"<<std::endl;
+}
+
+} // namespace mpsc_queue_test
+} // namespace test
+} // namespace mjstl
+#endif // !__MPSC_QUEUE_TEST_H__
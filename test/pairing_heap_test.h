@@ -0,0 +1,178 @@
+#ifndef __PAIRING_HEAP_TEST_H__
+#define __PAIRING_HEAP_TEST_H__
+
+#include "../pairing_heap.h"
+#include "../queue.h"
+#include "../vector.h"
+#include "test.h"
+
+namespace mjstl
+{
+namespace test
+{
+namespace pairing_heap_test
+{
+
+/*
+*   性能测试用Dijkstra：随机生成count个顶点、每个顶点8条出边的有向图(邻接数组)，
+* 权值1~1000，从0号顶点求单源最短路。
+*   堆里的键为(距离 << 32 | 顶点)，按距离取最小。
+*   dij_lazy：priority_queue没法改键，距离变小时压入新键，弹出时跳过过期的。
+*   dij_pairing：每个顶点最多一个节点，距离变小时decrease_key。
+*/
+typedef unsigned long long dij_key;
+
+struct dij_graph{
+    mjstl::vector<unsigned> offset;
+    mjstl::vector<unsigned> to;
+    mjstl::vector<unsigned> weight;
+};
+
+inline void dij_make_graph(dij_graph& g,size_t count){
+    const size_t degree = 8;
+    for(size_t u = 0; u < count; ++u){
+        g.offset.push_back(static_cast<unsigned>(u * degree));
+        for(size_t i = 0; i < degree; ++i){
+            g.to.push_back(static_cast<unsigned>(rand() % count));
+            g.weight.push_back(static_cast<unsigned>(rand() % 1000 + 1));
+        }
+    }
+    g.offset.push_back(static_cast<unsigned>(count * degree));
+}
+
+inline size_t dij_lazy(const dij_graph& g,mjstl::vector<unsigned>& dist){
+    mjstl::priority_queue<dij_key,mjstl::vector<dij_key>,std::greater<dij_key>> q;
+    dist[0] = 0;
+    q.push(0);
+    while(!q.empty()){
+        dij_key k = q.top();
+        q.pop();
+        unsigned u = static_cast<unsigned>(k & 0xffffffff);
+        unsigned d = static_cast<unsigned>(k >> 32);
+        if(d != dist[u]) continue;
+        for(unsigned e = g.offset[u]; e < g.offset[u + 1]; ++e){
+            unsigned v = g.to[e];
+            unsigned nd = d + g.weight[e];
+            if(nd < dist[v]){
+                dist[v] = nd;
+                q.push(static_cast<dij_key>(nd) << 32 | v);
+            }
+        }
+    }
+    return dist[dist.size() - 1];
+}
+
+inline size_t dij_pairing(const dij_graph& g,mjstl::vector<unsigned>& dist){
+    typedef mjstl::pairing_heap<dij_key,std::greater<dij_key>> heap_type;
+    heap_type h;
+    mjstl::vector<heap_type::handle_type> handle(dist.size());
+    dist[0] = 0;
+    handle[0] = h.push(0);
+    while(!h.empty()){
+        dij_key k = h.top();
+        h.pop();
+        unsigned u = static_cast<unsigned>(k & 0xffffffff);
+        unsigned d = static_cast<unsigned>(k >> 32);
+        handle[u] = heap_type::handle_type();
+        for(unsigned e = g.offset[u]; e < g.offset[u + 1]; ++e){
+            unsigned v = g.to[e];
+            unsigned nd = d + g.weight[e];
+            if(nd < dist[v]){
+                dist[v] = nd;
+                dij_key nk = static_cast<dij_key>(nd) << 32 | v;
+                if(handle[v] != heap_type::handle_type())
+                    h.decrease_key(handle[v],nk);
+                else
+                    handle[v] = h.push(nk);
+            }
+        }
+    }
+    return dist[dist.size() - 1];
+}
+
+/*fun为dij_lazy或dij_pairing，建图不计时；同一count用同一个种子，两行跑的是同一张图。*/
+#define DIJKSTRA_DO_TEST(fun, count) do {                    \
+  srand(static_cast<unsigned>(count));                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  dij_graph g;                                               \
+  dij_make_graph(g, count);                                  \
+  mjstl::vector<unsigned> dist(count, UINT_MAX);             \
+  start = clock();                                           \
+  size_t sum = fun(g, dist);                                 \
+  end = clock();                                             \
+  if (sum == 1) std::cout << " ";                            \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define DIJKSTRA_TEST(len1, len2, len3)                      \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|   priority_queue    |";                    \
+  DIJKSTRA_DO_TEST(dij_lazy, len1);                          \
+  DIJKSTRA_DO_TEST(dij_lazy, len2);                          \
+  DIJKSTRA_DO_TEST(dij_lazy, len3);                          \
+  std::cout << "\n|    pairing_heap     |";                  \
+  DIJKSTRA_DO_TEST(dij_pairing, len1);                       \
+  DIJKSTRA_DO_TEST(dij_pairing, len2);                       \
+  DIJKSTRA_DO_TEST(dij_pairing, len3);
+
+void pairing_heap_test()
+{
+    std::cout<<"[===============================================================]"<<std::endl;
+    std::cout<<"[------------- Run container test : pairing_heap ---------------]"<<std::endl;
+    std::cout<<"[---------------------------API test----------------------------]"<<std::endl;
+
+    typedef mjstl::pairing_heap<int,std::greater<int>> min_heap;
+
+    mjstl::pairing_heap<int> h1;
+    min_heap h2;
+    min_heap h3;
+    min_heap::handle_type a = h2.push(50);
+    min_heap::handle_type b = h2.push(30);
+    min_heap::handle_type c = h2.emplace(40);
+    h3.push(35);
+    h3.push(20);
+
+    std::cout<<std::boolalpha;
+    FUN_VALUE(h1.empty());
+    FUN_VALUE(*h1.push(7));
+    FUN_VALUE(h1.top());
+    FUN_VALUE(h2.top());
+    FUN_VALUE(*a);
+    h2.decrease_key(a,10);
+    FUN_VALUE(h2.top());
+    FUN_VALUE((h2.top() == *a));
+    h2.erase(c);
+    FUN_VALUE(h2.size());
+    h2.meld(h3);
+    FUN_VALUE(h3.empty());
+    FUN_VALUE(h2.size());
+    h2.pop();
+    FUN_VALUE(h2.top());
+    h2.decrease_key(b,5);
+    FUN_VALUE(h2.top());
+    h2.clear();
+    FUN_VALUE(h2.size());
+    std::cout<<std::noboolalpha;
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout<<"[--------------------- Performance Testing ---------------------]"<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|  dijkstra (nodes)   |";
+    DIJKSTRA_TEST(LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    PASSED;
+#endif
+    std::cout<<"[------------- End container test : pairing_heap ---------------]"<<std::endl;
+}
+
+} // namespace pairing_heap_test
+} // namespace test
+} // namespace mjstl
+#endif // !__PAIRING_HEAP_TEST_H__
@@ -3,6 +3,7 @@
 
 #include <queue>
 #include "../queue.h"
+#include "../vector.h"
 #include "test.h"
 
 namespace mjstl
@@ -11,7 +12,274 @@ namespace test
 {
 namespace queue_test
 {
-    
+
+/*
+*   队列push/pop交替进行，队列长度保持很小，每跨过一个缓冲区就要换一块新的缓冲区。
+*   spare为0表示关闭deque的空闲缓冲区缓存。
+*/
+#define QUEUE_PINGPONG_DO_TEST(mode, count) do {             \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  size_t sum = 0;                                            \
+  std::string m = #mode;                                     \
+  if (m == "std") {                                          \
+    std::queue<int> q;                                       \
+    start = clock();                                         \
+    for (size_t i = 0; i < count; ++i) {                     \
+      q.push(int(i)); q.push(int(i));                        \
+      sum += q.front(); q.pop(); q.pop();                    \
+    }                                                        \
+    end = clock();                                           \
+  } else {                                                   \
+    mjstl::deque<int> d;                                     \
+    if (m == "nospare") d.set_spare_limit(0);                \
+    mjstl::queue<int> q(std::move(d));                       \
+    start = clock();                                         \
+    for (size_t i = 0; i < count; ++i) {                     \
+      q.push(int(i)); q.push(int(i));                        \
+      sum += q.front(); q.pop(); q.pop();                    \
+    }                                                        \
+    end = clock();                                           \
+  }                                                          \
+  if (sum == 1) std::cout << " ";                            \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define QUEUE_PINGPONG_TEST(len1, len2, len3)                \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         std         |";                    \
+  QUEUE_PINGPONG_DO_TEST(std, len1);                         \
+  QUEUE_PINGPONG_DO_TEST(std, len2);                         \
+  QUEUE_PINGPONG_DO_TEST(std, len3);                         \
+  std::cout << "\n|   mjstl(no spare)   |";                  \
+  QUEUE_PINGPONG_DO_TEST(nospare, len1);                     \
+  QUEUE_PINGPONG_DO_TEST(nospare, len2);                     \
+  QUEUE_PINGPONG_DO_TEST(nospare, len3);                     \
+  std::cout << "\n|        mjstl        |";                  \
+  QUEUE_PINGPONG_DO_TEST(spare, len1);                       \
+  QUEUE_PINGPONG_DO_TEST(spare, len2);                       \
+  QUEUE_PINGPONG_DO_TEST(spare, len3);
+
+
+/*
+*   两个队列之间按批(64个)来回搬运元素，模拟流水线各级之间的批量传递。
+*   single：逐个front/push/pop；bulk：pop_n到缓冲区后push_range。
+*/
+#define QUEUE_BATCH_DO_TEST(mode, count) do {                \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  size_t sum = 0;                                            \
+  std::string m = #mode;                                     \
+  const size_t batch = 64;                                   \
+  int tmp[64];                                               \
+  if (m == "std") {                                          \
+    std::queue<int> a, b;                                    \
+    for (size_t i = 0; i < count; ++i) a.push(int(i));       \
+    start = clock();                                         \
+    for (int r = 0; r < 10; ++r) {                           \
+      while (!a.empty())                                     \
+        for (size_t k = 0; k < batch && !a.empty(); ++k) {   \
+          b.push(a.front()); a.pop();                        \
+        }                                                    \
+      a.swap(b);                                             \
+    }                                                        \
+    end = clock();                                           \
+    sum += a.front();                                        \
+  } else {                                                   \
+    mjstl::queue<int> a, b;                                  \
+    for (size_t i = 0; i < count; ++i) a.push(int(i));       \
+    start = clock();                                         \
+    for (int r = 0; r < 10; ++r) {                           \
+      if (m == "bulk") {                                     \
+        while (!a.empty()) {                                 \
+          int* e = a.pop_n(batch, tmp);                      \
+          b.push_range(tmp, e);                              \
+        }                                                    \
+      } else {                                               \
+        while (!a.empty())                                   \
+          for (size_t k = 0; k < batch && !a.empty(); ++k) { \
+            b.push(a.front()); a.pop();                      \
+          }                                                  \
+      }                                                      \
+      a.swap(b);                                             \
+    }                                                        \
+    end = clock();                                           \
+    sum += a.front();                                        \
+  }                                                          \
+  if (sum == 1) std::cout << " ";                            \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define QUEUE_BATCH_TEST(len1, len2, len3)                   \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         std         |";                    \
+  QUEUE_BATCH_DO_TEST(std, len1);                            \
+  QUEUE_BATCH_DO_TEST(std, len2);                            \
+  QUEUE_BATCH_DO_TEST(std, len3);                            \
+  std::cout << "\n|    mjstl single     |";                  \
+  QUEUE_BATCH_DO_TEST(single, len1);                         \
+  QUEUE_BATCH_DO_TEST(single, len2);                         \
+  QUEUE_BATCH_DO_TEST(single, len3);                         \
+  std::cout << "\n|     mjstl bulk      |";                  \
+  QUEUE_BATCH_DO_TEST(bulk, len1);                           \
+  QUEUE_BATCH_DO_TEST(bulk, len2);                           \
+  QUEUE_BATCH_DO_TEST(bulk, len3);
+
+/*用vector做底层容器，push count个随机数再全部pop，比较堆的叉数arity。*/
+#define PQUEUE_ARITY_DO_TEST(arity, count) do {              \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  size_t sum = 0;                                            \
+  mjstl::priority_queue<int, mjstl::vector<int>,             \
+      std::less<int>, arity> q;                              \
+  start = clock();                                           \
+  for (size_t i = 0; i < count; ++i)                         \
+    q.push(rand());                                          \
+  while (!q.empty()) {                                       \
+    sum += q.top();                                          \
+    q.pop();                                                 \
+  }                                                          \
+  end = clock();                                             \
+  if (sum == 1) std::cout << " ";                            \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define PQUEUE_ARITY_TEST(len1, len2, len3)                  \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|       binary        |";                    \
+  PQUEUE_ARITY_DO_TEST(2, len1);                             \
+  PQUEUE_ARITY_DO_TEST(2, len2);                             \
+  PQUEUE_ARITY_DO_TEST(2, len3);                             \
+  std::cout << "\n|        4-ary        |";                  \
+  PQUEUE_ARITY_DO_TEST(4, len1);                             \
+  PQUEUE_ARITY_DO_TEST(4, len2);                             \
+  PQUEUE_ARITY_DO_TEST(4, len3);                             \
+  std::cout << "\n|        8-ary        |";                  \
+  PQUEUE_ARITY_DO_TEST(8, len1);                             \
+  PQUEUE_ARITY_DO_TEST(8, len2);                             \
+  PQUEUE_ARITY_DO_TEST(8, len3);
+
+/*push count个随机数后计时全部pop。*/
+#define PQUEUE_DRAIN_DO_TEST(mode, count) do {               \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  size_t sum = 0;                                            \
+  mode::priority_queue<int> q;                               \
+  for (size_t i = 0; i < count; ++i)                         \
+    q.push(rand());                                          \
+  start = clock();                                           \
+  while (!q.empty()) {                                       \
+    sum += q.top();                                          \
+    q.pop();                                                 \
+  }                                                          \
+  end = clock();                                             \
+  if (sum == 1) std::cout << " ";                            \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+/*count个随机数先make_heap，计时sort_heap。*/
+#define SORT_HEAP_DO_TEST(mode, count) do {                  \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  int* p = new int[count];                                   \
+  for (size_t i = 0; i < count; ++i)                         \
+    p[i] = rand();                                           \
+  mode::make_heap(p, p + count);                             \
+  start = clock();                                           \
+  mode::sort_heap(p, p + count);                             \
+  end = clock();                                             \
+  delete[] p;                                                \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define HEAP_POP_TEST(macro, len1, len2, len3)               \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         std         |";                    \
+  macro(std, len1);                                          \
+  macro(std, len2);                                          \
+  macro(std, len3);                                          \
+  std::cout << "\n|        mjstl        |";                  \
+  macro(mjstl, len1);                                        \
+  macro(mjstl, len2);                                        \
+  macro(mjstl, len3);
+
+/*
+*   shape为random：已有count个元素的堆再插入一批count个随机元素；
+*   shape为sorted：空堆插入一批count个升序元素，逐个push时每个都要上滤到堆顶。
+*   single：逐个push；bulk：push_range一次插入。
+*/
+#define PQUEUE_BATCH_DO_TEST(mode, shape, count) do {        \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  std::string m = #mode;                                     \
+  std::string s = #shape;                                    \
+  mjstl::vector<int> batch;                                  \
+  mjstl::priority_queue<int, mjstl::vector<int>> q;          \
+  for (size_t i = 0; i < count; ++i) {                       \
+    if (s == "sorted") {                                     \
+      batch.push_back(static_cast<int>(i));                  \
+    } else {                                                 \
+      q.push(rand());                                        \
+      batch.push_back(rand());                               \
+    }                                                        \
+  }                                                          \
+  start = clock();                                           \
+  if (m == "bulk") {                                         \
+    q.push_range(batch.begin(), batch.end());                \
+  } else {                                                   \
+    for (size_t i = 0; i < count; ++i)                       \
+      q.push(batch[i]);                                      \
+  }                                                          \
+  end = clock();                                             \
+  if (q.size() == 1) std::cout << " ";                       \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define PQUEUE_BATCH_TEST(shape, len1, len2, len3)           \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|   mjstl push loop   |";                    \
+  PQUEUE_BATCH_DO_TEST(single, shape, len1);                 \
+  PQUEUE_BATCH_DO_TEST(single, shape, len2);                 \
+  PQUEUE_BATCH_DO_TEST(single, shape, len3);                 \
+  std::cout << "\n|  mjstl push_range   |";                  \
+  PQUEUE_BATCH_DO_TEST(bulk, shape, len1);                   \
+  PQUEUE_BATCH_DO_TEST(bulk, shape, len2);                   \
+  PQUEUE_BATCH_DO_TEST(bulk, shape, len3);
+
 void queue_print(mjstl::queue<int> q)
 {
     while(!q.empty())
@@ -22,7 +290,8 @@ void queue_print(mjstl::queue<int> q)
     std::cout<<std::endl;
 }
 
-void priority_queue_print(mjstl::priority_queue<int> p)
+template<class PriorityQueue>
+void priority_queue_print(PriorityQueue p)
 {
     while(!p.empty())
     {
@@ -84,6 +353,8 @@ void queue_test()
     QUEUE_AFTER_FUN(q10,q10.push(100));
     QUEUE_AFTER_FUN(q10,q10.push(lval));
     QUEUE_AFTER_FUN(q10,q10.pop());
+    QUEUE_AFTER_FUN(q10,q10.push_range(a,a + 4));
+    QUEUE_AFTER_FUN(q10,q10.pop_n(3,a));
     QUEUE_AFTER_FUN(q10,q10.swap(q4));
     FUN_VALUE(q10.empty());
     QUEUE_AFTER_FUN(q10,q10.clear());
@@ -100,6 +371,18 @@ void queue_test()
 #else
     CON_TEST_P1(queue<int>,push,rand(),SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
 #endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|  push/pop pingpong  |";
+#if LARGER_TEST_DATA_ON
+    QUEUE_PINGPONG_TEST(SCALE_LL(LEN1),SCALE_LL(LEN2),SCALE_LL(LEN3));
+#else
+    QUEUE_PINGPONG_TEST(SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+#endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"| batch move (64) x10 |";
+    QUEUE_BATCH_TEST(LEN1,LEN2,LEN3);
     std::cout<<std::endl;
     std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
     PASSED;
@@ -132,11 +415,18 @@ void priority_queue_test()
     PQUEUE_AFTER_FUN(q10,q10.push(100));
     PQUEUE_AFTER_FUN(q10,q10.push(lval));
     PQUEUE_AFTER_FUN(q10,q10.pop());
+    PQUEUE_AFTER_FUN(q10,q10.push_range(a,a + 4));
+    PQUEUE_AFTER_FUN(q10,q10.pop_n(3,a));
+    FUN_VALUE(a[0]);
     PQUEUE_AFTER_FUN(q10,q10.swap(q4));
     FUN_VALUE(q10.empty());
     PQUEUE_AFTER_FUN(q10,q10.clear());
     FUN_VALUE(q10.size());
     FUN_VALUE(q10.empty());
+    mjstl::priority_queue<int,mjstl::vector<int>,std::less<int>,4> q11(a,a+sizeof(a)/sizeof(int));
+    PQUEUE_AFTER_FUN(q11,q11.push(5));
+    PQUEUE_AFTER_FUN(q11,q11.pop());
+    FUN_VALUE(q11.top());
     std::cout<<std::noboolalpha;
 
 #if PERFORMANCE_TEST_ON
@@ -148,6 +438,30 @@ void priority_queue_test()
 #else
     CON_TEST_P1(priority_queue<int>,push,rand(),SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
 #endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|     push + pop      |";
+#if LARGER_TEST_DATA_ON
+    PQUEUE_ARITY_TEST(SCALE_LL(LEN1),SCALE_LL(LEN2),SCALE_LL(LEN3));
+#else
+    PQUEUE_ARITY_TEST(SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+#endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|        drain        |";
+    HEAP_POP_TEST(PQUEUE_DRAIN_DO_TEST,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|      sort_heap      |";
+    HEAP_POP_TEST(SORT_HEAP_DO_TEST,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|   batch push (n)    |";
+    PQUEUE_BATCH_TEST(random,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|  sorted into empty  |";
+    PQUEUE_BATCH_TEST(sorted,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
     std::cout<<std::endl;
     std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
     PASSED;
@@ -0,0 +1,197 @@
+#ifndef __RING_BUFFER_TEST_H__
+#define __RING_BUFFER_TEST_H__
+
+#include "../ring_buffer.h"
+#include "../queue.h"
+#include "../stack.h"
+#include "test.h"
+
+namespace mjstl
+{
+namespace test
+{
+namespace ring_buffer_test
+{
+
+/*输出两段连续内存的长度及内容。*/
+#define RING_SPAN_COUT(r) do{                                   \
+    auto one = r.array_one();                                   \
+    auto two = r.array_two();                                   \
+    std::cout << " " << #r << ".array_one : ";                  \
+    for(size_t i = 0; i < one.second; ++i)                      \
+        std::cout << " " << one.first[i];                       \
+    std::cout << "\n " << #r << ".array_two : ";                \
+    for(size_t i = 0; i < two.second; ++i)                      \
+        std::cout << " " << two.first[i];                       \
+    std::cout << "\n";                                          \
+}while(0)
+
+typedef mjstl::queue<int,mjstl::ring_buffer<int>>               ring_queue;
+typedef mjstl::queue<int,mjstl::static_ring_buffer<int,256>>    static_ring_queue;
+
+/*
+*   性能测试辅助函数：
+*   ring_steady：队列保持100个元素，每次push一个、pop一个，是有界队列最常见的用法。
+*   ring_fill：先push count个元素再全部pop，static_ring_buffer容量固定，不参与。
+*/
+template<class Queue>
+size_t ring_steady(Queue& q,size_t count){
+    size_t sum = 0;
+    for(int i = 0; i < 100; ++i)
+        q.push(i);
+    for(size_t i = 0; i < count; ++i){
+        q.push(int(i));
+        sum += q.front();
+        q.pop();
+    }
+    return sum;
+}
+
+template<class Queue>
+size_t ring_fill(Queue& q,size_t count){
+    size_t sum = 0;
+    for(size_t i = 0; i < count; ++i)
+        q.push(int(i));
+    while(!q.empty()){
+        sum += q.front();
+        q.pop();
+    }
+    return sum;
+}
+
+#define RING_DO_TEST(mode, fun, count) do {                  \
+  clock_t start, end;                                        \
+  mode q;                                                    \
+  char buf[10];                                              \
+  size_t sum = 0;                                            \
+  start = clock();                                           \
+  sum += fun(q, count);                                      \
+  end = clock();                                             \
+  if (sum == 1) std::cout << " ";                            \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define RING_STEADY_TEST(len1, len2, len3)                   \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|    deque queue      |";                    \
+  RING_DO_TEST(mjstl::queue<int>, ring_steady, len1);        \
+  RING_DO_TEST(mjstl::queue<int>, ring_steady, len2);        \
+  RING_DO_TEST(mjstl::queue<int>, ring_steady, len3);        \
+  std::cout << "\n|  ring_buffer queue  |";                  \
+  RING_DO_TEST(ring_queue, ring_steady, len1);               \
+  RING_DO_TEST(ring_queue, ring_steady, len2);               \
+  RING_DO_TEST(ring_queue, ring_steady, len3);               \
+  std::cout << "\n| static_ring queue   |";                  \
+  RING_DO_TEST(static_ring_queue, ring_steady, len1);        \
+  RING_DO_TEST(static_ring_queue, ring_steady, len2);        \
+  RING_DO_TEST(static_ring_queue, ring_steady, len3);
+
+#define RING_FILL_TEST(len1, len2, len3)                     \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|    deque queue      |";                    \
+  RING_DO_TEST(mjstl::queue<int>, ring_fill, len1);          \
+  RING_DO_TEST(mjstl::queue<int>, ring_fill, len2);          \
+  RING_DO_TEST(mjstl::queue<int>, ring_fill, len3);          \
+  std::cout << "\n|  ring_buffer queue  |";                  \
+  RING_DO_TEST(ring_queue, ring_fill, len1);                 \
+  RING_DO_TEST(ring_queue, ring_fill, len2);                 \
+  RING_DO_TEST(ring_queue, ring_fill, len3);
+
+void ring_buffer_test()
+{
+    std::cout<<"[===============================================================]"<<std::endl;
+    std::cout<<"[------------- Run container test : ring_buffer ----------------]"<<std::endl;
+    std::cout<<"[---------------------------API test----------------------------]"<<std::endl;
+
+    int a[] = {1,2,3,4,5,6,7,8};
+
+    mjstl::ring_buffer<int> r1;
+    mjstl::ring_buffer<int> r2(5,8);
+    mjstl::ring_buffer<int> r3(a,a + 5);
+    mjstl::ring_buffer<int> r4{1,2,3};
+    mjstl::ring_buffer<int> r5(r3);
+    mjstl::ring_buffer<int> r6(std::move(r5));
+
+    std::cout<<std::boolalpha;
+    FUN_AFTER(r1,r1.reserve(6));
+    FUN_VALUE(r1.capacity());
+    FUN_AFTER(r1,r1.push_back(1));
+    FUN_AFTER(r1,r1.push_back(2));
+    FUN_AFTER(r1,r1.push_front(0));
+    FUN_AFTER(r1,r1.append(a + 2,a + 6));
+    FUN_VALUE(r1.full());
+    RING_SPAN_COUT(r1);
+    FUN_AFTER(r1,r1.pop_front_n(3,a));
+    FUN_AFTER(r1,r1.append(a,a + 3));
+    RING_SPAN_COUT(r1);
+    FUN_AFTER(r1,r1.push_back(9));
+    FUN_VALUE(r1.capacity());
+    RING_SPAN_COUT(r1);
+    FUN_AFTER(r1,r1.pop_back());
+    FUN_AFTER(r1,r1.pop_front());
+    FUN_VALUE(r1.front());
+    FUN_VALUE(r1.back());
+    FUN_VALUE(r1[2]);
+    FUN_VALUE(*(r1.end() - 2));
+    FUN_AFTER(r2,r2.swap(r4));
+    FUN_VALUE((r3 == r6));
+    FUN_AFTER(r6,r6.clear());
+    FUN_AFTER(r6,r6.shrink_to_fit());
+    FUN_VALUE(r6.capacity());
+
+    mjstl::static_ring_buffer<int,4> s1{1,2,3};
+    FUN_AFTER(s1,s1.push_back(4));
+    FUN_VALUE(s1.full());
+    FUN_AFTER(s1,s1.pop_front());
+    FUN_AFTER(s1,s1.push_back(5));
+    RING_SPAN_COUT(s1);
+    mjstl::static_ring_buffer<int,4> s2(s1);
+    FUN_AFTER(s2,s2.pop_back_n(2,a));
+    FUN_AFTER(s2,s2.swap(s1));
+
+    ring_queue q1;
+    q1.push(1);
+    q1.push(2);
+    q1.push_range(a,a + 3);
+    FUN_VALUE(q1.size());
+    FUN_VALUE(q1.front());
+    mjstl::stack<int,mjstl::static_ring_buffer<int,8>> st1{1,2,3};
+    st1.push(4);
+    FUN_VALUE(st1.top());
+    st1.pop();
+    FUN_VALUE(st1.top());
+    std::cout<<std::noboolalpha;
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout<<"[--------------------- Performance Testing ---------------------]"<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"| push/pop (depth 100)|";
+#if LARGER_TEST_DATA_ON
+    RING_STEADY_TEST(SCALE_LL(LEN1),SCALE_LL(LEN2),SCALE_LL(LEN3));
+#else
+    RING_STEADY_TEST(SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+#endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|    fill and drain   |";
+#if LARGER_TEST_DATA_ON
+    RING_FILL_TEST(SCALE_LL(LEN1),SCALE_LL(LEN2),SCALE_LL(LEN3));
+#else
+    RING_FILL_TEST(SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+#endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    PASSED;
+#endif
+    std::cout<<"[------------- End container test : ring_buffer ----------------]"<<std::endl;
+}
+
+} // namespace ring_buffer_test
+} // namespace test
+} // namespace mjstl
+#endif // !__RING_BUFFER_TEST_H__
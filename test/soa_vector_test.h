@@ -0,0 +1,140 @@
+#ifndef __SOA_VECTOR_TEST_H__
+#define __SOA_VECTOR_TEST_H__
+
+#include <string>
+#include "../soa_vector.h"
+#include "../vector.h"
+#include "test.h"
+
+namespace mjstl
+{
+namespace test
+{
+namespace soa_vector_test
+{
+
+/*按列输出，每列一行。*/
+#define SOA_COUT(sv) do{                                        \
+    std::string sv_name = #sv;                                  \
+    std::cout << " " << sv_name << ".id   : ";                  \
+    for(auto x : sv.span<0>()) std::cout << " " << x;           \
+    std::cout << "\n " << sv_name << ".name : ";                \
+    for(auto x : sv.span<1>()) std::cout << " " << x;           \
+    std::cout << "\n";                                          \
+}while(0)
+
+#define SOA_FUN_AFTER(sv,fun) do{                               \
+    std::string fun_name = #fun;                                \
+    std::cout << " After " << fun_name << " : \n";              \
+    fun;                                                        \
+    SOA_COUT(sv);                                               \
+}while(0)
+
+/*数组结构体(AoS)的记录，列扫描时只用到x。*/
+struct soa_record{
+    double x;
+    double y;
+    double z;
+    double w;
+    int id;
+};
+
+/*建立count行数据后，对第一列求和10次。*/
+#define SOA_SCAN_DO_TEST(mode, count) do {                   \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  double sum = 0;                                            \
+  std::string m = #mode;                                     \
+  if (m == "aos") {                                          \
+    mjstl::vector<soa_record> c;                             \
+    for (size_t i = 0; i < count; ++i) {                     \
+      soa_record r = { double(rand()),1.0,2.0,3.0,int(i) };  \
+      c.push_back(r);                                        \
+    }                                                        \
+    start = clock();                                         \
+    for (int k = 0; k < 10; ++k)                             \
+      for (size_t i = 0; i < c.size(); ++i)                  \
+        sum += c[i].x;                                       \
+    end = clock();                                           \
+  } else {                                                   \
+    mjstl::soa_vector<double,double,double,double,int> c;    \
+    for (size_t i = 0; i < count; ++i)                       \
+      c.emplace_back(double(rand()),1.0,2.0,3.0,int(i));     \
+    start = clock();                                         \
+    for (int k = 0; k < 10; ++k) {                           \
+      const double* x = c.column<0>();                       \
+      for (size_t i = 0; i < c.size(); ++i)                  \
+        sum += x[i];                                         \
+    }                                                        \
+    end = clock();                                           \
+  }                                                          \
+  if (sum == 1) std::cout << " ";                            \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define SOA_SCAN_TEST(len1, len2, len3)                      \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|     AoS vector      |";                    \
+  SOA_SCAN_DO_TEST(aos, len1);                               \
+  SOA_SCAN_DO_TEST(aos, len2);                               \
+  SOA_SCAN_DO_TEST(aos, len3);                               \
+  std::cout << "\n|     soa_vector      |";                  \
+  SOA_SCAN_DO_TEST(soa, len1);                               \
+  SOA_SCAN_DO_TEST(soa, len2);                               \
+  SOA_SCAN_DO_TEST(soa, len3);
+
+void soa_vector_test()
+{
+    std::cout<<"[===============================================================]"<<std::endl;
+    std::cout<<"[-------------- Run container test : soa_vector ----------------]"<<std::endl;
+    std::cout<<"[---------------------------API test----------------------------]"<<std::endl;
+
+    mjstl::soa_vector<int,std::string> s1;
+    SOA_FUN_AFTER(s1,s1.emplace_back(1,"one"));
+    SOA_FUN_AFTER(s1,s1.emplace_back(2,"two"));
+    SOA_FUN_AFTER(s1,s1.push_back(std::make_tuple(3,std::string("three"))));
+    SOA_FUN_AFTER(s1,s1.push_back(std::make_tuple(4,std::string("four"))));
+    SOA_FUN_AFTER(s1,s1.push_back(std::make_tuple(5,std::string("five"))));
+    SOA_FUN_AFTER(s1,std::get<1>(s1[0]) = "ONE");
+    SOA_FUN_AFTER(s1,s1.get<0>(1) = 20);
+    SOA_FUN_AFTER(s1,s1.erase(s1.begin() + 1));
+    SOA_FUN_AFTER(s1,s1.erase(s1.begin() + 2,s1.end()));
+    SOA_FUN_AFTER(s1,s1.pop_back());
+    mjstl::soa_vector<int,std::string> s2(s1);
+    SOA_FUN_AFTER(s2,s2.emplace_back(s2.get<0>(0),s2.get<1>(0)));
+    SOA_FUN_AFTER(s2,s2.emplace_back(6,"six"));
+    mjstl::soa_vector<int,std::string> s3(std::move(s2));
+    SOA_FUN_AFTER(s3,s3.swap(s1));
+    FUN_VALUE(s1.size());
+    FUN_VALUE(s1.capacity());
+    FUN_VALUE(std::get<1>(*(s1.end() - 1)));
+    FUN_VALUE((reinterpret_cast<size_t>(s1.column<1>()) % __SOA_ALIGN));
+    SOA_FUN_AFTER(s1,s1.clear());
+    FUN_VALUE(s1.empty());
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout<<"[--------------------- Performance Testing ---------------------]"<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|  column scan x 10   |";
+#if LARGER_TEST_DATA_ON
+    SOA_SCAN_TEST(SCALE_LL(LEN1),SCALE_LL(LEN2),SCALE_LL(LEN3));
+#else
+    SOA_SCAN_TEST(SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+#endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    PASSED;
+#endif
+    std::cout<<"[-------------- End container test : soa_vector ----------------]"<<std::endl;
+}
+
+} // namespace soa_vector_test
+} // namespace test
+} // namespace mjstl
+#endif // !__SOA_VECTOR_TEST_H__
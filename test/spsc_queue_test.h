@@ -0,0 +1,257 @@
+#ifndef __SPSC_QUEUE_TEST_H__
+#define __SPSC_QUEUE_TEST_H__
+
+#include <mutex>
+#include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "../spsc_queue.h"
+#include "../queue.h"
+#include "test.h"
+
+namespace mjstl
+{
+namespace test
+{
+namespace spsc_queue_test
+{
+
+/*
+*   把当前线程绑定到某个CPU上，非Linux平台不做处理。
+*   新线程会继承创建者的亲和性，所以只在测试自己创建的线程里调用，
+* 不绑定主线程，否则后面各个测试创建的线程都会挤在同一个CPU上。
+*/
+inline void spsc_pin_thread(unsigned cpu){
+#if defined(__linux__)
+    unsigned n = std::thread::hardware_concurrency();
+    if(n == 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % n,&set);
+    pthread_setaffinity_np(pthread_self(),sizeof(set),&set);
+#else
+    (void)cpu;
+#endif
+}
+
+/*互斥锁保护的mjstl::queue，作为比较的基准。*/
+class locked_queue{
+public:
+    void push(int x){
+        std::lock_guard<std::mutex> lock(m_);
+        q_.push(x);
+    }
+    bool try_pop(int& out){
+        std::lock_guard<std::mutex> lock(m_);
+        if(q_.empty()) return false;
+        out = q_.front();
+        q_.pop();
+        return true;
+    }
+    void pop(int& out){
+        unsigned spins = 0;
+        while(!try_pop(out)) mjstl::__spin_wait(spins);
+    }
+private:
+    std::mutex m_;
+    mjstl::queue<int> q_;
+};
+
+typedef mjstl::spsc_queue<int>              bounded_queue;
+typedef mjstl::unbounded_spsc_queue<int>    unbounded_queue;
+
+template<class Queue>
+Queue* spsc_make_queue(){ return new Queue();}
+template<>
+inline bounded_queue* spsc_make_queue<bounded_queue>(){ return new bounded_queue(1024);}
+
+inline size_t spsc_push_n(bounded_queue& q,int* buf,size_t n){ return q.try_push_n(buf,n);}
+inline size_t spsc_push_n(unbounded_queue& q,int* buf,size_t n){ q.push_n(buf,n); return n;}
+inline size_t spsc_push_n(locked_queue& q,int* buf,size_t n){
+    for(size_t k = 0; k < n; ++k) q.push(buf[k]);
+    return n;
+}
+template<class Queue>
+size_t spsc_pop_n(Queue& q,int* buf,size_t n){ return q.try_pop_n(buf,n);}
+inline size_t spsc_pop_n(locked_queue& q,int* buf,size_t n){
+    size_t k = 0;
+    while(k < n && q.try_pop(buf[k])) ++k;
+    return k;
+}
+
+/*
+*   吞吐量：生产者、消费者各在一个绑定了CPU的线程里，传递count个int。
+*   batch为true时每次try_push_n、try_pop_n 32个。
+*/
+template<class Queue>
+size_t spsc_throughput(size_t count,bool batch){
+    Queue* q = spsc_make_queue<Queue>();
+    size_t sum = 0;
+    std::thread consumer([&]{
+        spsc_pin_thread(1);
+        int buf[32];
+        size_t got = 0;
+        unsigned spins = 0;
+        while(got < count){
+            if(batch){
+                size_t n = spsc_pop_n(*q,buf,32);
+                if(n == 0) mjstl::__spin_wait(spins);
+                else spins = 0;
+                got += n;
+            }else{
+                int x;
+                q->pop(x);
+                sum += x;
+                ++got;
+            }
+        }
+    });
+    std::thread producer([&]{
+        spsc_pin_thread(0);
+        int buf[32];
+        unsigned spins = 0;
+        for(size_t i = 0; i < count;){
+            if(batch){
+                size_t n = count - i < 32 ? count - i : 32;
+                for(size_t k = 0; k < n; ++k) buf[k] = int(i + k);
+                n = spsc_push_n(*q,buf,n);
+                if(n == 0) mjstl::__spin_wait(spins);
+                else spins = 0;
+                i += n;
+            }else{
+                q->push(int(i));
+                ++i;
+            }
+        }
+    });
+    producer.join();
+    consumer.join();
+    delete q;
+    return sum;
+}
+
+/*延迟：两个队列一来一回，count次往返的总时间。*/
+template<class Queue>
+size_t spsc_pingpong(size_t count){
+    Queue* ping = spsc_make_queue<Queue>();
+    Queue* pong = spsc_make_queue<Queue>();
+    std::thread echo([&]{
+        spsc_pin_thread(1);
+        int x;
+        for(size_t i = 0; i < count; ++i){
+            ping->pop(x);
+            pong->push(x);
+        }
+    });
+    size_t sum = 0;
+    std::thread serve([&]{
+        spsc_pin_thread(0);
+        int x;
+        for(size_t i = 0; i < count; ++i){
+            ping->push(int(i));
+            pong->pop(x);
+            sum += x;
+        }
+    });
+    serve.join();
+    echo.join();
+    delete ping;
+    delete pong;
+    return sum;
+}
+
+#define SPSC_DO_TEST(mode, fun, len) do {                    \
+  std::string f = #fun;                                      \
+  WALL_TIME_DO_TEST(f == "single" ?                          \
+      spsc_throughput<mode>(len, false) : f == "batch" ?     \
+      spsc_throughput<mode>(len, true) :                     \
+      spsc_pingpong<mode>(len));                             \
+} while(0)
+
+#define SPSC_TEST(fun, len1, len2, len3)                     \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|    mutex + queue    |";                    \
+  SPSC_DO_TEST(locked_queue, fun, len1);                     \
+  SPSC_DO_TEST(locked_queue, fun, len2);                     \
+  SPSC_DO_TEST(locked_queue, fun, len3);                     \
+  std::cout << "\n|     spsc_queue      |";                  \
+  SPSC_DO_TEST(bounded_queue, fun, len1);                    \
+  SPSC_DO_TEST(bounded_queue, fun, len2);                    \
+  SPSC_DO_TEST(bounded_queue, fun, len3);                    \
+  std::cout << "\n|unbounded_spsc_queue |";                  \
+  SPSC_DO_TEST(unbounded_queue, fun, len1);                  \
+  SPSC_DO_TEST(unbounded_queue, fun, len2);                  \
+  SPSC_DO_TEST(unbounded_queue, fun, len3);
+
+void spsc_queue_test()
+{
+    std::cout<<"[===============================================================]"<<std::endl;
+    std::cout<<"[-------------- Run container test : spsc_queue ----------------]"<<std::endl;
+    std::cout<<"[---------------------------API test----------------------------]"<<std::endl;
+
+    int a[] = {1,2,3,4,5,6,7,8};
+    int b[8] = {0};
+    int x = 0;
+
+    std::cout<<std::boolalpha;
+    mjstl::spsc_queue<int> q1(6);
+    FUN_VALUE(q1.capacity());
+    FUN_VALUE(q1.try_push(1));
+    FUN_VALUE(q1.try_push_n(a,8));
+    FUN_VALUE(q1.try_push(9));
+    FUN_VALUE(q1.size());
+    FUN_VALUE(q1.try_pop(x));
+    FUN_VALUE(x);
+    FUN_VALUE(q1.try_pop_n(b,3));
+    FUN_VALUE(b[2]);
+    FUN_VALUE(q1.try_push_n(a + 4,4));
+    FUN_VALUE(q1.try_pop_n(b,8));
+    FUN_VALUE(b[0]);
+    FUN_VALUE(b[7]);
+    FUN_VALUE(q1.empty());
+
+    mjstl::unbounded_spsc_queue<std::string,mjstl::alloc,4> q2;
+    q2.push("a");
+    q2.push(std::string("b"));
+    std::string s[6] = {"c","d","e","f","g","h"};
+    q2.push_n(s,6);
+    FUN_VALUE(q2.size());
+    std::string out;
+    FUN_VALUE(q2.try_pop(out));
+    FUN_VALUE(out);
+    std::string sb[8];
+    FUN_VALUE(q2.try_pop_n(sb,8));
+    FUN_VALUE(sb[6]);
+    q2.push_n(s,6);
+    FUN_VALUE(q2.try_pop(out));
+    FUN_VALUE(out);
+    FUN_VALUE(q2.size());
+    std::cout<<std::noboolalpha;
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout<<"[--------------------- Performance Testing ---------------------]"<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|  throughput (1 by 1)|";
+    SPSC_TEST(single,SCALE_LL(LEN1),SCALE_LL(LEN2),SCALE_LL(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|  throughput (x 32)  |";
+    SPSC_TEST(batch,SCALE_LL(LEN1),SCALE_LL(LEN2),SCALE_LL(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|  ping-pong latency  |";
+    SPSC_TEST(pingpong,SCALE_S(LEN1),SCALE_S(LEN2),SCALE_S(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    PASSED;
+#endif
+    std::cout<<"[-------------- End container test : spsc_queue ----------------]"<<std::endl;
+}
+
+} // namespace spsc_queue_test
+} // namespace test
+} // namespace mjstl
+#endif // !__SPSC_QUEUE_TEST_H__
@@ -13,6 +13,18 @@
 #include "deque_test.h"
 #include "stack_test.h"
 #include "queue_test.h"
+#include "hive_test.h"
+#include "soa_vector_test.h"
+#include "ring_buffer_test.h"
+#include "spsc_queue_test.h"
+#include "mpmc_queue_test.h"
+#include "mpsc_queue_test.h"
+#include "concurrent_stack_test.h"
+#include "flat_combining_test.h"
+#include "intrusive_list_test.h"
+#include "unrolled_list_test.h"
+#include "pairing_heap_test.h"
+#include "timing_wheel_test.h"
 
 int main(){
     using namespace mjstl::test;
@@ -21,9 +33,22 @@ int main(){
     RUN_ALL_TESTS();
     
     // vector_test::vector_test();
+    // vector_test::vector_bool_test();
     // deque_test::deque_test();
     // stack_test::stack_test();
     // queue_test::queue_test();
+    // hive_test::hive_test();
+    // soa_vector_test::soa_vector_test();
+    // ring_buffer_test::ring_buffer_test();
+    // spsc_queue_test::spsc_queue_test();
+    // mpmc_queue_test::mpmc_queue_test();
+    // mpsc_queue_test::mpsc_queue_test();
+    // concurrent_stack_test::concurrent_stack_test();
+    // flat_combining_test::flat_combining_test();
+    // intrusive_list_test::intrusive_list_test();
+    // unrolled_list_test::unrolled_list_test();
+    // pairing_heap_test::pairing_heap_test();
+    // timing_wheel_test::timing_wheel_test();
     list_test::list_test();
 
 #if defined(_MSC_VER) && defined(_DEBUG)
@@ -1,6 +1,7 @@
 #ifndef __MJSTL_TEST_H__
 #define __MJSTL_TEST_H__
 
+#include<chrono>
 #include<ctime>
 #include<cstring>
 #include<iostream>
@@ -563,6 +564,26 @@ void test_len(size_t len1, size_t len2, size_t len3, size_t wide)
   std::cout << std::setw(WIDE) << t;                         \
 } while(0)
 
+/*
+*   多线程的性能测试用挂钟时间：clock()是整个进程的CPU时间，几个线程同时跑会重复计入，
+* 线程等待时又不计入。expr返回size_t，累加到sum里，防止被优化掉。
+*/
+#define WALL_TIME_DO_TEST(expr) do {                         \
+  char buf[10];                                              \
+  size_t sum = 0;                                            \
+  std::chrono::steady_clock::time_point t0 =                 \
+      std::chrono::steady_clock::now();                      \
+  sum += (expr);                                             \
+  if (sum == 1) std::cout << " ";                            \
+  int n = static_cast<int>(std::chrono::duration_cast<       \
+      std::chrono::milliseconds>(                            \
+      std::chrono::steady_clock::now() - t0).count());       \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
 #define MAP_EMPLACE_DO_TEST(mode, con, count) do {           \
   srand((int)time(0));                                       \
   clock_t start, end;                                        \
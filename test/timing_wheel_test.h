@@ -0,0 +1,170 @@
+#ifndef __TIMING_WHEEL_TEST_H__
+#define __TIMING_WHEEL_TEST_H__
+
+#include "../timing_wheel.h"
+#include "../queue.h"
+#include "../vector.h"
+#include "test.h"
+
+namespace mjstl
+{
+namespace test
+{
+namespace timing_wheel_test
+{
+
+struct conn{
+    int fd;
+    mjstl::timer_hook timer;
+
+    conn(int x = 0):fd(x){}
+};
+
+typedef mjstl::timing_wheel<conn,&conn::timer> conn_wheel;
+
+/*
+*   定时器周转：共CHURN_TIMERS个定时器，每个tick推进一次时间，再把其中一个重新定时，
+* 延迟为[1,CHURN_DELAY]里的随机值。同一个定时器每CHURN_TIMERS个tick轮到一次，
+* 还在等待的就先取消，所以大约7/8被取消，1/8到期。
+*   churn_wheel：timing_wheel的schedule、cancel都是O(1)。
+*   churn_heap：priority_queue不能删除，取消只是改掉deadline，过期的键留在堆里，弹出时跳过。
+*/
+enum { CHURN_TIMERS = 1 << 16, CHURN_DELAY = 1 << 19 };
+
+struct churn_timer{
+    mjstl::timer_hook hook;
+};
+
+inline size_t churn_wheel(size_t count){
+    mjstl::vector<churn_timer> timers(CHURN_TIMERS);
+    mjstl::timing_wheel<churn_timer,&churn_timer::hook> w;
+    size_t fired = 0;
+    for(size_t i = 1; i <= count; ++i){
+        fired += w.advance(i,[](churn_timer&){});
+        churn_timer& t = timers[i & (CHURN_TIMERS - 1)];
+        if(w.scheduled(t)) w.cancel(t);
+        w.schedule(t,i + 1 + rand() % CHURN_DELAY);
+    }
+    return fired;
+}
+
+inline size_t churn_heap(size_t count){
+    typedef unsigned long long key_type;
+    mjstl::vector<key_type> deadline(CHURN_TIMERS,0);
+    mjstl::priority_queue<key_type,mjstl::vector<key_type>,std::greater<key_type>> q;
+    size_t fired = 0;
+    for(size_t i = 1; i <= count; ++i){
+        while(!q.empty() && (q.top() >> 16) <= i){
+            key_type k = q.top();
+            q.pop();
+            size_t s = static_cast<size_t>(k & (CHURN_TIMERS - 1));
+            if(deadline[s] == (k >> 16)){
+                deadline[s] = 0;
+                ++fired;
+            }
+        }
+        size_t s = i & (CHURN_TIMERS - 1);
+        deadline[s] = i + 1 + rand() % CHURN_DELAY;
+        q.push(deadline[s] << 16 | s);
+    }
+    return fired;
+}
+
+/*fun为churn_wheel或churn_heap，同一count用同一个种子，两行的定时序列相同。*/
+#define TIMER_CHURN_DO_TEST(fun, count) do {                 \
+  srand(static_cast<unsigned>(count));                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  start = clock();                                           \
+  size_t sum = fun(count);                                   \
+  end = clock();                                             \
+  if (sum == 1) std::cout << " ";                            \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define TIMER_CHURN_TEST(len1, len2, len3)                   \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|   priority_queue    |";                    \
+  TIMER_CHURN_DO_TEST(churn_heap, len1);                     \
+  TIMER_CHURN_DO_TEST(churn_heap, len2);                     \
+  TIMER_CHURN_DO_TEST(churn_heap, len3);                     \
+  std::cout << "\n|    timing_wheel     |";                  \
+  TIMER_CHURN_DO_TEST(churn_wheel, len1);                    \
+  TIMER_CHURN_DO_TEST(churn_wheel, len2);                    \
+  TIMER_CHURN_DO_TEST(churn_wheel, len3);
+
+void timing_wheel_test()
+{
+    std::cout<<"[===============================================================]"<<std::endl;
+    std::cout<<"[------------- Run container test : timing_wheel ---------------]"<<std::endl;
+    std::cout<<"[---------------------------API test----------------------------]"<<std::endl;
+
+    conn c[4] = {conn(1),conn(2),conn(3),conn(4)};
+    conn_wheel w;
+    int fds[8];
+    int expired = 0;
+    auto record = [&](conn& x){ fds[expired++] = x.fd;};
+
+    std::cout<<std::boolalpha;
+    FUN_VALUE(w.now());
+    FUN_VALUE(conn_wheel::horizon());
+    w.schedule(c[0],10);
+    w.schedule(c[1],5000);
+    w.schedule(c[2],3);
+    w.schedule(c[3],300000);
+    FUN_VALUE(w.scheduled(c[0]));
+    FUN_VALUE(conn_wheel::expire_of(c[1]));
+    w.cancel(c[0]);
+    FUN_VALUE(w.scheduled(c[0]));
+    FUN_VALUE(w.advance(100,record));
+    FUN_VALUE(fds[0]);
+    FUN_VALUE(w.now());
+    w.schedule(c[3],4000);
+    FUN_VALUE(w.advance(10000,record));
+    FUN_VALUE(fds[1]);
+    FUN_VALUE(fds[2]);
+    w.schedule(c[0],20000);
+    {
+        conn tmp(9);
+        w.schedule(tmp,15000);
+    }
+    FUN_VALUE(w.advance(30000,record));
+    FUN_VALUE(fds[3]);
+    w.schedule(c[1],w.now() + 10);
+    w.clear();
+    FUN_VALUE(w.scheduled(c[1]));
+
+    /*超出horizon的定时器要在最高层多转几圈，不能提前到期。*/
+    typedef mjstl::timing_wheel<conn,&conn::timer,2,2> small_wheel;
+    small_wheel sw;
+    conn late(5);
+    small_wheel::tick_type fired_at = 0;
+    auto fire = [&](conn&){ fired_at = sw.now();};
+    FUN_VALUE(small_wheel::horizon());
+    sw.schedule(late,50);
+    FUN_VALUE(sw.advance(49,fire));
+    FUN_VALUE(sw.advance(100,fire));
+    FUN_VALUE(fired_at);
+    std::cout<<std::noboolalpha;
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout<<"[--------------------- Performance Testing ---------------------]"<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|  timer churn (n)    |";
+    TIMER_CHURN_TEST(SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    PASSED;
+#endif
+    std::cout<<"[------------- End container test : timing_wheel ---------------]"<<std::endl;
+}
+
+} // namespace timing_wheel_test
+} // namespace test
+} // namespace mjstl
+#endif // !__TIMING_WHEEL_TEST_H__
@@ -0,0 +1,173 @@
+#ifndef __UNROLLED_LIST_TEST_H__
+#define __UNROLLED_LIST_TEST_H__
+
+#include "../unrolled_list.h"
+#include "../list.h"
+#include "../vector.h"
+#include "test.h"
+
+namespace mjstl
+{
+namespace test
+{
+namespace unrolled_list_test
+{
+
+/*
+*   性能测试辅助函数，三种容器各自用最自然的写法：
+*   ul_fill：push_back插入count个元素。
+*   ul_insert：每隔8个元素插入一个，list、unrolled_list边走边插，vector拷贝到新vector再交换。
+*   ul_erase：删除一半元素，list、unrolled_list按迭代器逐个删除，vector用erase_if一次删除。
+*   ul_iterate：遍历求和10次。
+*/
+template<class Con>
+void ul_fill(Con& c,size_t count){
+    for(size_t i = 0; i < count; ++i)
+        c.push_back(rand());
+}
+
+template<class Con>
+void ul_insert(Con& c){
+    size_t i = 0;
+    for(auto it = c.begin(); it != c.end(); ++it){
+        if((i++ & 7) == 0){
+            it = c.insert(it,*it);
+            ++it;
+        }
+    }
+}
+
+inline void ul_insert(mjstl::vector<int>& c){
+    mjstl::vector<int> v;
+    for(size_t i = 0; i < c.size(); ++i){
+        if((i & 7) == 0) v.push_back(c[i]);
+        v.push_back(c[i]);
+    }
+    c.swap(v);
+}
+
+template<class Con>
+void ul_erase(Con& c){
+    for(auto it = c.begin(); it != c.end();){
+        if(*it & 1) it = c.erase(it);
+        else ++it;
+    }
+}
+
+inline void ul_erase(mjstl::vector<int>& c){
+    mjstl::erase_if(c,[](int x){ return x & 1;});
+}
+
+template<class Con>
+size_t ul_iterate(Con& c){
+    size_t sum = 0;
+    for(int i = 0; i < 10; ++i)
+        for(auto it = c.begin(); it != c.end(); ++it)
+            sum += *it;
+    return sum;
+}
+
+/*mode为容器类型，fun为insert、erase、iterate之一，计时前先插入count个元素。*/
+#define UNROLLED_DO_TEST(mode, fun, count) do {              \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  mode c;                                                    \
+  char buf[10];                                              \
+  size_t sum = 0;                                            \
+  std::string f = #fun;                                      \
+  ul_fill(c, count);                                         \
+  start = clock();                                           \
+  if (f == "insert") ul_insert(c);                           \
+  else if (f == "erase") ul_erase(c);                        \
+  else sum += ul_iterate(c);                                 \
+  end = clock();                                             \
+  if (sum == 1) std::cout << " ";                            \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define UNROLLED_TEST(fun, len1, len2, len3)                 \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|        list         |";                    \
+  UNROLLED_DO_TEST(mjstl::list<int>, fun, len1);             \
+  UNROLLED_DO_TEST(mjstl::list<int>, fun, len2);             \
+  UNROLLED_DO_TEST(mjstl::list<int>, fun, len3);             \
+  std::cout << "\n|       vector        |";                  \
+  UNROLLED_DO_TEST(mjstl::vector<int>, fun, len1);           \
+  UNROLLED_DO_TEST(mjstl::vector<int>, fun, len2);           \
+  UNROLLED_DO_TEST(mjstl::vector<int>, fun, len3);           \
+  std::cout << "\n|    unrolled_list    |";                  \
+  UNROLLED_DO_TEST(mjstl::unrolled_list<int>, fun, len1);    \
+  UNROLLED_DO_TEST(mjstl::unrolled_list<int>, fun, len2);    \
+  UNROLLED_DO_TEST(mjstl::unrolled_list<int>, fun, len3);
+
+void unrolled_list_test()
+{
+    std::cout<<"[===============================================================]"<<std::endl;
+    std::cout<<"[------------ Run container test : unrolled_list ---------------]"<<std::endl;
+    std::cout<<"[---------------------------API test----------------------------]"<<std::endl;
+
+    int a[] = {1,2,3,4,5,6,7,8,9,10};
+
+    mjstl::unrolled_list<int> u1;
+    mjstl::unrolled_list<int> u2(5,8);
+    mjstl::unrolled_list<int> u3(a,a + sizeof(a)/sizeof(int));
+    mjstl::unrolled_list<int> u4{1,2,3};
+    mjstl::unrolled_list<int> u5(u3);
+    mjstl::unrolled_list<int> u6(std::move(u5));
+    mjstl::unrolled_list<int,mjstl::alloc,4> u7(a,a + sizeof(a)/sizeof(int));
+    mjstl::unrolled_list<int,mjstl::alloc,4> u8{100,200};
+
+    std::cout<<std::boolalpha;
+    FUN_VALUE(u1.node_capacity());
+    FUN_VALUE(u7.node_capacity());
+    FUN_AFTER(u1,u1.push_back(2));
+    FUN_AFTER(u1,u1.push_front(1));
+    FUN_AFTER(u1,u1.emplace_back(3));
+    FUN_AFTER(u1,u1.insert(++u1.begin(),5));
+    FUN_AFTER(u1,u1.pop_front());
+    FUN_AFTER(u1,u1.pop_back());
+    FUN_AFTER(u7,u7.insert(++++u7.begin(),0));
+    FUN_AFTER(u7,u7.erase(u7.begin(),++++++u7.begin()));
+    FUN_AFTER(u7,u7.splice(++u7.begin(),u8));
+    FUN_VALUE(u8.empty());
+    FUN_VALUE(u7.front());
+    FUN_VALUE(u7.back());
+    FUN_VALUE(*u7.rbegin());
+    FUN_VALUE(u7.size());
+    FUN_AFTER(u3,u3.swap(u4));
+    FUN_VALUE((u6 == u4));
+    FUN_AFTER(u6,u6.erase(u6.begin(),u6.end()));
+    FUN_VALUE(u6.empty());
+    FUN_AFTER(u2,u2.clear());
+    FUN_VALUE(u2.size());
+    std::cout<<std::noboolalpha;
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout<<"[--------------------- Performance Testing ---------------------]"<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|    iterate x 10     |";
+    UNROLLED_TEST(iterate,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|     insert 1/8      |";
+    UNROLLED_TEST(insert,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|     erase half      |";
+    UNROLLED_TEST(erase,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    PASSED;
+#endif
+    std::cout<<"[------------ End container test : unrolled_list ---------------]"<<std::endl;
+}
+
+} // namespace unrolled_list_test
+} // namespace test
+} // namespace mjstl
+#endif // !__UNROLLED_LIST_TEST_H__
@@ -2,7 +2,9 @@
 #define __VECTOR_TEST_H__
 
 #include <vector>
+#include <algorithm>
 #include "../vector.h"
+#include "../algo.h"
 #include "test.h"
 
 namespace mjstl
@@ -19,6 +21,58 @@ void print_vector(mjstl::vector<int> v)
     std::cout<<std::endl;
 }
 
+/*
+*   erase的性能测试辅助函数：std版本用标准写法，mjstl版本用新增接口。
+*   erase_if：删掉一半的元素，std用remove_if + erase。
+*   erase_random：随机位置删除1000个元素，std用erase，mjstl用unordered_erase。
+*/
+inline void erase_if(std::vector<int>& v){
+    v.erase(std::remove_if(v.begin(),v.end(),[](int x){ return x & 1;}),v.end());
+}
+
+inline void erase_if(mjstl::vector<int>& v){
+    mjstl::erase_if(v,[](int x){ return x & 1;});
+}
+
+inline void erase_random(std::vector<int>& v){
+    for(int i = 0; i < 1000 && !v.empty(); ++i)
+        v.erase(v.begin() + rand() % v.size());
+}
+
+inline void erase_random(mjstl::vector<int>& v){
+    for(int i = 0; i < 1000 && !v.empty(); ++i)
+        v.unordered_erase(v.begin() + rand() % v.size());
+}
+
+#define VECTOR_ERASE_DO_TEST(mode, fun, count) do {          \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  mode::vector<int> v;                                       \
+  char buf[10];                                              \
+  for (size_t i = 0; i < count; ++i)                         \
+    v.push_back(rand());                                     \
+  start = clock();                                           \
+  fun(v);                                                    \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define VECTOR_ERASE_TEST(fun, len1, len2, len3)             \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         std         |";                    \
+  VECTOR_ERASE_DO_TEST(std, fun, len1);                      \
+  VECTOR_ERASE_DO_TEST(std, fun, len2);                      \
+  VECTOR_ERASE_DO_TEST(std, fun, len3);                      \
+  std::cout << "\n|        mjstl        |";                  \
+  VECTOR_ERASE_DO_TEST(mjstl, fun, len1);                    \
+  VECTOR_ERASE_DO_TEST(mjstl, fun, len2);                    \
+  VECTOR_ERASE_DO_TEST(mjstl, fun, len3);
+
 void vector_test()
 {
     std::cout<<"[===============================================================]"<<std::endl;
@@ -70,6 +124,11 @@ void vector_test()
     FUN_AFTER(v1,v1.resize(v1.size() + 10));
     FUN_AFTER(v1,v1.erase(v1.begin(),v1.end() - 1));
     FUN_AFTER(v1,v1.erase(v1.begin()));
+    FUN_AFTER(v1,v1.assign(a,a + (sizeof(a)/sizeof(int))));
+    FUN_AFTER(v1,v1.unordered_erase(v1.begin() + 1));
+    FUN_AFTER(v1,v1.unordered_erase(v1.end() - 1));
+    FUN_VALUE(mjstl::erase_if(v1,[](int x){ return x % 2 == 0;}));
+    COUT(v1);
     FUN_AFTER(v1,v1.swap(v4));
     FUN_AFTER(v1,v1.clear());
     FUN_VALUE(v1.size());
@@ -92,6 +151,14 @@ void vector_test()
 #else
     CON_TEST_P1(vector<int>,push_back,rand(),SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
 #endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|      erase_if       |";
+    VECTOR_ERASE_TEST(erase_if,LEN1,LEN2,LEN3);
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|   unordered_erase   |";
+    VECTOR_ERASE_TEST(erase_random,LEN1,LEN2,LEN3);
     std::cout<<std::endl;
     std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
     PASSED;
@@ -108,6 +175,124 @@ void vector_test()
     std::cout<<"[---------------- End container test : vector ------------------]"<<std::endl;
 }
 
+/*把find返回的迭代器、count返回的个数都变成数值，防止测试循环被优化掉。*/
+template<class V,class Iter>
+size_t bvector_sink(V& v,Iter it){ return size_t(it - v.begin()); }
+
+template<class V>
+size_t bvector_sink(V&,ptrdiff_t n){ return size_t(n); }
+
+/*对长度为count的位向量，重复调用fun统计/查找，测量按字处理的效果。*/
+#define BVECTOR_ALGO_DO_TEST(mode, fun, count) do {          \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  mode::vector<bool> v;                                      \
+  char buf[10];                                              \
+  for (size_t i = 0; i < count; ++i)                         \
+    v.push_back(false);                                      \
+  v.back() = true;                                           \
+  size_t sum = 0;                                            \
+  start = clock();                                           \
+  for (int i = 0; i < 100; ++i)                              \
+    sum += bvector_sink(v,mode::fun(v.begin(),v.end(),true));\
+  end = clock();                                             \
+  if (sum == 0) std::cout << " ";                            \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define BVECTOR_ALGO_TEST(fun, len1, len2, len3)             \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         std         |";                    \
+  BVECTOR_ALGO_DO_TEST(std, fun, len1);                      \
+  BVECTOR_ALGO_DO_TEST(std, fun, len2);                      \
+  BVECTOR_ALGO_DO_TEST(std, fun, len3);                      \
+  std::cout << "\n|        mjstl        |";                  \
+  BVECTOR_ALGO_DO_TEST(mjstl, fun, len1);                    \
+  BVECTOR_ALGO_DO_TEST(mjstl, fun, len2);                    \
+  BVECTOR_ALGO_DO_TEST(mjstl, fun, len3);
+
+void vector_bool_test()
+{
+    std::cout<<"[===============================================================]"<<std::endl;
+    std::cout<<"[------------- Run container test : vector<bool> ---------------]"<<std::endl;
+    std::cout<<"[---------------------------API test----------------------------]"<<std::endl;
+
+    bool a[] = {true,false,true,true,false};
+
+    mjstl::vector<bool> v1;
+    mjstl::vector<bool> v2(70,true);
+    mjstl::vector<bool> v3(a,a+(sizeof(a)/sizeof(bool)));
+    mjstl::vector<bool> v4{true,true,false};
+    mjstl::vector<bool> v5(v2);
+    mjstl::vector<bool> v6(std::move(v5));
+
+    std::cout<<std::boolalpha;
+    FUN_AFTER(v1,v1.push_back(true));
+    FUN_AFTER(v1,v1.push_back(false));
+    FUN_AFTER(v1,v1.insert(v1.begin(),true));
+    FUN_AFTER(v1,v1.insert(v1.begin() + 1,3,false));
+    FUN_AFTER(v1,v1.insert(v1.end(),a,a+(sizeof(a)/sizeof(bool))));
+    FUN_AFTER(v1,v1.erase(v1.begin()));
+    FUN_AFTER(v1,v1.erase(v1.begin(),v1.begin() + 2));
+    FUN_AFTER(v1,v1.flip());
+    FUN_AFTER(v1,v1[0] = false);
+    FUN_AFTER(v1,v1.pop_back());
+    FUN_AFTER(v1,v1.resize(10,true));
+    FUN_AFTER(v1,v1.swap(v4));
+    FUN_VALUE(v1.size());
+    FUN_VALUE(v1.front());
+    FUN_VALUE(v1.back());
+    FUN_VALUE(v2.size());
+    FUN_VALUE(v2.capacity());
+    FUN_VALUE(mjstl::count(v2.begin(),v2.end(),true));
+    FUN_AFTER(v2,mjstl::fill(v2.begin() + 3,v2.begin() + 67,false));
+    FUN_VALUE(mjstl::count(v2.begin(),v2.end(),true));
+    FUN_VALUE(mjstl::find(v2.begin() + 3,v2.end(),true) - v2.begin());
+    FUN_VALUE(mjstl::find(v2.begin(),v2.end(),false) - v2.begin());
+    FUN_AFTER(v6,mjstl::copy(v3.begin(),v3.end(),v6.begin() + 1));
+    FUN_VALUE((v6 == v2));
+    FUN_VALUE(v6.empty());
+    FUN_AFTER(v6,v6.clear());
+    FUN_VALUE(v6.empty());
+    std::cout<<std::noboolalpha;
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout<<"[--------------------- Performance Testing ---------------------]"<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|      push_back      |";
+#if LARGER_TEST_DATA_ON
+    CON_TEST_P1(vector<bool>,push_back,rand() & 1,SCALE_LL(LEN1),SCALE_LL(LEN2),SCALE_LL(LEN3));
+#else
+    CON_TEST_P1(vector<bool>,push_back,rand() & 1,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+#endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|     count x 100     |";
+#if LARGER_TEST_DATA_ON
+    BVECTOR_ALGO_TEST(count,SCALE_LL(LEN1),SCALE_LL(LEN2),SCALE_LL(LEN3));
+#else
+    BVECTOR_ALGO_TEST(count,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+#endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    std::cout<<"|     find x 100      |";
+#if LARGER_TEST_DATA_ON
+    BVECTOR_ALGO_TEST(find,SCALE_LL(LEN1),SCALE_LL(LEN2),SCALE_LL(LEN3));
+#else
+    BVECTOR_ALGO_TEST(find,SCALE_L(LEN1),SCALE_L(LEN2),SCALE_L(LEN3));
+#endif
+    std::cout<<std::endl;
+    std::cout<<"|---------------------|-------------|-------------|-------------|"<<std::endl;
+    PASSED;
+#endif
+    std::cout<<"[------------- End container test : vector<bool> ---------------]"<<std::endl;
+}
+
 } // namespace vector_test
 } // namespace test
 } // namespace mjstl
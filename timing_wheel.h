@@ -0,0 +1,244 @@
+#ifndef __TIMING_WHEEL_H__
+#define __TIMING_WHEEL_H__
+
+#include "bit_iterator.h"
+#include "intrusive_list.h"
+
+namespace mjstl
+{
+    /*
+    *   timing_wheel：分层时间轮，侵入式定时器容器。
+    *   时间以tick计。共Levels层，每层2^Bits个桶，第k层一个桶覆盖2^(Bits*k)个tick，
+    * 到期时间距当前不足2^(Bits*(k+1))的定时器放在第k层，最多能表示2^(Bits*Levels)个tick，
+    * 更远的先放在最高层最远的桶里，转到时再重新放置。第0层的桶到期就触发，
+    * 不能暂放还没到期的定时器，所以至少要两层。
+    *   第0层转过一圈时，把上一层当前桶里的定时器按剩余时间重新放到下面各层(cascade)，
+    * 每个定时器最多被搬动Levels-1次。
+    *
+    *   定时器是使用者的对象，里面放一个timer_hook成员，容器不申请内存、不拥有对象。
+    * timer_hook就是auto_unlink_list_hook加上到期时间：schedule是挂到一个桶上，
+    * cancel是hook.unlink()，都是O(1)；对象析构时如果还没到期会自动摘下。
+    *   每层一个64位的占用位图，推进时间时用ctz直接跳到下一个要处理的tick，不逐个tick空转。
+    * cancel不经过容器，所以位图只是提示：置位的桶可能已经空了，访问到时再清掉。
+    *
+    *   用法：
+    *     struct conn{ int fd; mjstl::timer_hook timer;};
+    *     mjstl::timing_wheel<conn,&conn::timer> w;
+    *     w.schedule(c,w.now() + 30);
+    *     w.advance(t,[](conn& c){ ... });
+    *
+    *   桶的哨兵在容器对象里，定时器指向它们，所以容器不能拷贝或移动。
+    */
+    struct timer_hook : public auto_unlink_list_hook{
+        typedef unsigned long long tick_type;
+
+        tick_type expire;
+
+        timer_hook():expire(0){}
+    };
+
+    template<class T,timer_hook T::*Member,size_t Bits = 6,size_t Levels = 4>
+    class timing_wheel{
+        static_assert(Bits > 0 && Bits <= 6,"one occupancy word per level");
+        static_assert(Levels >= 2,"far timers wait in the top level, which must not be level 0");
+        static_assert(Bits * Levels < 64,"ticks must fit in tick_type");
+
+    public:
+        typedef T                           value_type;
+        typedef timer_hook::tick_type       tick_type;
+        typedef size_t                      size_type;
+
+    protected:
+        typedef __list_hook_node*           link_type;
+
+        enum { __SLOTS = 1 << Bits };
+        static const tick_type __MASK = tick_type(__SLOTS - 1);
+
+        /*已经处理完的最后一个tick。*/
+        tick_type now_;
+        __bit_word occupied_[Levels];
+        __list_hook_node buckets_[Levels][__SLOTS];
+
+    public:
+        explicit timing_wheel(tick_type now = 0);
+        ~timing_wheel(){ clear();}
+
+        timing_wheel(const timing_wheel&) = delete;
+        timing_wheel& operator=(const timing_wheel&) = delete;
+
+    public:
+        tick_type now() const { return now_;}
+        /*能直接放下的最远时长，更远的定时器会在最高层多转几圈。*/
+        static tick_type horizon(){ return tick_type(1) << (Bits * Levels);}
+        static tick_type expire_of(const T& x){ return (x.*Member).expire;}
+        static bool scheduled(const T& x){ return (x.*Member).is_linked();}
+
+        /*
+        *   让x在expire到期，x已经在等待的话先取消。
+        *   expire不晚于now()的定时器在下一次advance推进时间时到期。
+        */
+        void schedule(T& x,tick_type expire);
+        static void cancel(T& x){ (x.*Member).unlink();}
+
+        /*
+        *   把时间推进到now，按到期时间顺序对每个到期的定时器调用callback(T&)，返回到期个数。
+        *   调用callback前定时器已经摘下，callback里可以重新schedule它，也可以cancel、schedule别的定时器。
+        */
+        template<class Callback>
+        size_type advance(tick_type now,Callback callback);
+
+        /*摘下所有定时器，不调用回调。*/
+        void clear();
+
+    protected:
+        void __place(link_type p,tick_type expire);
+        void __cascade();
+        template<class Callback>
+        size_type __expire(__list_hook_node& bucket,Callback& callback);
+        bool __next_tick(tick_type& next) const;
+    };
+
+template<class T,timer_hook T::*Member,size_t Bits,size_t Levels>
+timing_wheel<T,Member,Bits,Levels>::timing_wheel(tick_type now):now_(now){
+    for(size_t k = 0; k < Levels; ++k){
+        occupied_[k] = 0;
+        for(size_t i = 0; i < size_t(__SLOTS); ++i)
+            buckets_[k][i].prev = buckets_[k][i].next = &buckets_[k][i];
+    }
+}
+
+/*按离now_的距离选层，桶号取到期时间在该层的那几位。要求expire >= now_。*/
+template<class T,timer_hook T::*Member,size_t Bits,size_t Levels>
+void timing_wheel<T,Member,Bits,Levels>::__place(link_type p,tick_type expire){
+    if(expire - now_ >= horizon()) expire = now_ + horizon() - 1;
+    size_t k = 0;
+    while(k + 1 < Levels && (expire - now_) >> (Bits * (k + 1)) != 0)
+        ++k;
+    size_t slot = size_t((expire >> (Bits * k)) & __MASK);
+    link_type head = &buckets_[k][slot];
+    p->next = head;
+    p->prev = head->prev;
+    head->prev->next = p;
+    head->prev = p;
+    occupied_[k] |= __bit_word(1) << slot;
+}
+
+template<class T,timer_hook T::*Member,size_t Bits,size_t Levels>
+void timing_wheel<T,Member,Bits,Levels>::schedule(T& x,tick_type expire){
+    timer_hook& h = x.*Member;
+    h.unlink();
+    h.expire = expire;
+    __place(&h,expire > now_ ? expire : now_ + 1);
+}
+
+/*now_是第0层新一圈的开始：从第1层起，把当前桶里的定时器重新放置，该层的桶号不为0就停。*/
+template<class T,timer_hook T::*Member,size_t Bits,size_t Levels>
+void timing_wheel<T,Member,Bits,Levels>::__cascade(){
+    for(size_t k = 1; k < Levels; ++k){
+        size_t slot = size_t((now_ >> (Bits * k)) & __MASK);
+        link_type head = &buckets_[k][slot];
+        occupied_[k] &= ~(__bit_word(1) << slot);
+        if(head->next != head){
+            __list_hook_node tmp;
+            tmp.prev = tmp.next = &tmp;
+            __list_transfer(&tmp,head->next,head);
+            while(tmp.next != &tmp){
+                link_type p = tmp.next;
+                tmp.next = p->next;
+                __place(p,static_cast<timer_hook*>(p)->expire);
+            }
+        }
+        if(slot != 0) break;
+    }
+}
+
+/*
+*   先把桶整个转移到局部哨兵上再逐个回调，回调里schedule的定时器不会进到正在处理的这串里。
+*   回调抛出异常时，没处理的定时器已经到期，放到下一个tick的桶里，下次advance时先处理。
+*/
+template<class T,timer_hook T::*Member,size_t Bits,size_t Levels>
+template<class Callback>
+typename timing_wheel<T,Member,Bits,Levels>::size_type
+timing_wheel<T,Member,Bits,Levels>::__expire(__list_hook_node& bucket,Callback& callback){
+    if(bucket.next == &bucket) return 0;
+    __list_hook_node tmp;
+    tmp.prev = tmp.next = &tmp;
+    __list_transfer(&tmp,bucket.next,&bucket);
+    size_type n = 0;
+    try{
+        while(tmp.next != &tmp){
+            timer_hook* h = static_cast<timer_hook*>(tmp.next);
+            h->unlink();
+            ++n;
+            callback(*__hook_owner(h,Member));
+        }
+    }catch(...){
+        if(tmp.next != &tmp){
+            size_t slot = size_t((now_ + 1) & __MASK);
+            __list_transfer(&buckets_[0][slot],tmp.next,&tmp);
+            occupied_[0] |= __bit_word(1) << slot;
+        }
+        throw;
+    }
+    return n;
+}
+
+/*
+*   now_之后第一个要处理的tick：从第0层往上找，第k层当前这一圈还有占用的桶，就是转到那个桶的时刻；
+* 第k层只剩下一圈的桶，就是第k+1层下一个桶的开头(要做cascade)；第k层空着就看上一层。
+*   下面各层都空的时候才会看到第k层，所以中间那些什么都不用做的tick全部跳过。时间轮空时返回false。
+*/
+template<class T,timer_hook T::*Member,size_t Bits,size_t Levels>
+bool timing_wheel<T,Member,Bits,Levels>::__next_tick(tick_type& next) const {
+    for(size_t k = 0; k < Levels; ++k){
+        const size_t shift = Bits * k;
+        const size_t cur = size_t((now_ >> shift) & __MASK);
+        __bit_word ahead = cur + 1 == size_t(__SLOTS) ? 0 : occupied_[k] & (~__bit_word(0) << (cur + 1));
+        if(ahead != 0){
+            next = ((now_ >> shift) - cur + tick_type(__bit_ctz(ahead))) << shift;
+            return true;
+        }
+        if(occupied_[k] != 0){
+            next = ((now_ >> (shift + Bits)) + 1) << (shift + Bits);
+            return true;
+        }
+    }
+    return false;
+}
+
+template<class T,timer_hook T::*Member,size_t Bits,size_t Levels>
+template<class Callback>
+typename timing_wheel<T,Member,Bits,Levels>::size_type
+timing_wheel<T,Member,Bits,Levels>::advance(tick_type now,Callback callback){
+    size_type n = 0;
+    tick_type next;
+    while(now_ < now){
+        if(!__next_tick(next) || next > now){
+            now_ = now;
+            break;
+        }
+        now_ = next;
+        size_t slot = size_t(now_ & __MASK);
+        if(slot == 0) __cascade();
+        if(occupied_[0] & (__bit_word(1) << slot)){
+            occupied_[0] &= ~(__bit_word(1) << slot);
+            n += __expire(buckets_[0][slot],callback);
+        }
+    }
+    return n;
+}
+
+template<class T,timer_hook T::*Member,size_t Bits,size_t Levels>
+void timing_wheel<T,Member,Bits,Levels>::clear(){
+    for(size_t k = 0; k < Levels; ++k){
+        for(size_t i = 0; i < size_t(__SLOTS); ++i){
+            link_type head = &buckets_[k][i];
+            while(head->next != head)
+                static_cast<timer_hook*>(head->next)->unlink();
+        }
+        occupied_[k] = 0;
+    }
+}
+
+} // namespace mjstl
+#endif // !__TIMING_WHEEL_H__
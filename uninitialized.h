@@ -108,11 +108,17 @@ __uninitialized_fill_n_aux(ForwardIterator first,Size n,const T& x,__true_type){
 }
 
 template<class ForwardIterator,class Size, class T>
-inline void
+inline ForwardIterator
 __uninitialized_fill_n_aux(ForwardIterator first, Size n, const T& x, __false_type){
-    for(; n > 0; --n, ++first)
-        construct(&*first, x);
-    return first;
+    ForwardIterator cur = first;
+    try{
+        for(; n > 0; --n, ++cur)
+            construct(&*cur, x);
+    }catch(...){
+        destory(first,cur);
+        throw;
+    }
+    return cur;
 }
 
 template<class ForwardIterator, class Size, class T>
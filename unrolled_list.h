@@ -0,0 +1,501 @@
+#ifndef __UNROLLED_LIST_H__
+#define __UNROLLED_LIST_H__
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "iterator.h"
+#include "reverse_iterator.h"
+#include "memory.h"
+
+namespace mjstl
+{
+    /*
+    *   unrolled_list：展开链表。每个节点存放一小段连续的元素(最多N个)，节点之间是双向链表。
+    *   遍历时一个节点内的元素是连续的，一次缓存缺失换来N个元素，而list每个元素一次。
+    *   N默认按节点约两个缓存行(__UNROLLED_NODE_BYTES)计算，元素很大时至少为4。
+    *
+    *   插入：节点满了就把后一半搬到新节点(split)再插入；插在节点开头时，
+    * 如果前一个节点还有空位，直接追加到它末尾。push_back/push_front写满一个节点才开新节点。
+    *   删除：节点空了就释放；和后继节点加起来不超过N/2个元素时把后继合并进来，
+    * 保证节点平均至少1/4满。
+    *   插入、删除只移动所在节点(以及split、合并涉及的相邻节点)里的元素，代价O(N)。
+    *
+    *   迭代器是(节点,下标)，插入、删除会使所在节点和相邻节点上的迭代器失效，
+    * 其他节点上的不受影响。
+    *   splice(position,x)：在节点边界上是O(1)的重新链接，position在节点中间时先split。
+    */
+    enum { __UNROLLED_NODE_BYTES = 128 };
+
+    struct __unrolled_link{
+        __unrolled_link* prev;
+        __unrolled_link* next;
+    };
+
+    template<class T>
+    struct __unrolled_capacity{
+        enum { header = sizeof(__unrolled_link) + sizeof(size_t) };
+        enum { fit = (__UNROLLED_NODE_BYTES - header) / sizeof(T) };
+        enum { value = fit < 4 ? 4 : fit };
+    };
+
+    template<class T,size_t N>
+    struct __unrolled_node : public __unrolled_link{
+        typedef typename std::aligned_storage<sizeof(T),alignof(T)>::type slot_type;
+
+        size_t count;
+        slot_type slots[N];
+
+        T* value(size_t i){ return reinterpret_cast<T*>(slots + i);}
+    };
+
+    template<class T,class Ref,class Ptr,size_t N>
+    struct __unrolled_iterator : public iterator<bidirectional_iterator_tag,T>{
+        typedef __unrolled_iterator<T,T&,T*,N>              iterator;
+        typedef __unrolled_iterator<T,const T&,const T*,N>  const_iterator;
+        typedef __unrolled_iterator<T,Ref,Ptr,N>            self;
+
+        typedef T value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        typedef __unrolled_link*        link_type;
+        typedef __unrolled_node<T,N>*   node_pointer;
+
+        link_type node;
+        size_t index;
+
+        __unrolled_iterator():node(nullptr),index(0){}
+        __unrolled_iterator(link_type x,size_t i):node(x),index(i){}
+        __unrolled_iterator(const iterator& x):node(x.node),index(x.index){}
+
+        bool operator==(const self& x) const { return node == x.node && index == x.index;}
+        bool operator!=(const self& x) const { return !(*this == x);}
+        reference operator*() const { return *static_cast<node_pointer>(node)->value(index);}
+        pointer operator->() const { return &(operator*());}
+
+        /*走到节点末尾时进入下一个节点的第0个，end()是(哨兵,0)。*/
+        self& operator++(){
+            if(++index == static_cast<node_pointer>(node)->count){
+                node = node->next;
+                index = 0;
+            }
+            return *this;
+        }
+        self operator++(int){
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        self& operator--(){
+            if(index == 0){
+                node = node->prev;
+                index = static_cast<node_pointer>(node)->count - 1;
+            }else
+                --index;
+            return *this;
+        }
+        self operator--(int){
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+    };
+
+    template<class T,class Alloc = alloc,size_t N = __unrolled_capacity<T>::value>
+    class unrolled_list{
+    public:
+        typedef T                       value_type;
+        typedef Alloc                   allocate_type;
+        typedef value_type*             pointer;
+        typedef const value_type*       const_pointer;
+        typedef value_type&             reference;
+        typedef const value_type&       const_reference;
+        typedef size_t                  size_type;
+        typedef ptrdiff_t               difference_type;
+
+        typedef __unrolled_iterator<T,T&,T*,N>              iterator;
+        typedef __unrolled_iterator<T,const T&,const T*,N>  const_iterator;
+        typedef mjstl::reverse_iterator<iterator>           reverse_iterator;
+        typedef mjstl::reverse_iterator<const_iterator>     const_reverse_iterator;
+
+        static_assert(N >= 2,"unrolled_list needs at least 2 elements per node.");
+
+    protected:
+        typedef __unrolled_link*                link_type;
+        typedef __unrolled_node<T,N>            node_type;
+        typedef node_type*                      node_pointer;
+        typedef simple_alloc<node_type,Alloc>   node_allocator;
+
+    protected:
+        __unrolled_link head_;    /*哨兵，首尾相接。*/
+        size_type size_;
+
+    public:
+        unrolled_list(){ __initialize();}
+        unrolled_list(size_type n,const T& value);
+        unrolled_list(std::initializer_list<value_type> ilist);
+        template<class InputIterator,typename std::enable_if<
+            mjstl::is_input_iterator<InputIterator>::value,int>::type = 0>
+        unrolled_list(InputIterator first,InputIterator last);
+
+        unrolled_list(const unrolled_list& x);
+        unrolled_list(unrolled_list&& x);
+
+        unrolled_list& operator=(const unrolled_list& x);
+        unrolled_list& operator=(unrolled_list&& x);
+
+        ~unrolled_list(){ clear();}
+
+    public:
+        /*about iterator*/
+        iterator begin(){ return iterator(head_.next,0);}
+        const_iterator begin() const { return const_iterator(head_.next,0);}
+        iterator end(){ return iterator(&head_,0);}
+        const_iterator end() const { return const_iterator(const_cast<link_type>(&head_),0);}
+        reverse_iterator rbegin(){ return reverse_iterator(end());}
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end());}
+        reverse_iterator rend(){ return reverse_iterator(begin());}
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin());}
+
+        /*about container*/
+        reference front(){ return *begin();}
+        const_reference front() const { return *begin();}
+        reference back(){ return *(--end());}
+        const_reference back() const { return *(--end());}
+        bool empty() const { return size_ == 0;}
+        size_type size() const { return size_;}
+        static size_type node_capacity(){ return N;}
+
+        /*modify container*/
+        template<class ...Args>
+        iterator emplace(iterator position,Args&& ...args);
+        template<class ...Args>
+        void emplace_front(Args&& ...args){ emplace(begin(),mjstl::forward<Args>(args)...);}
+        template<class ...Args>
+        void emplace_back(Args&& ...args){ emplace(end(),mjstl::forward<Args>(args)...);}
+        iterator insert(iterator position,const T& x){ return emplace(position,x);}
+        iterator insert(iterator position,T&& x){ return emplace(position,mjstl::move(x));}
+        void push_front(const T& x){ emplace(begin(),x);}
+        void push_front(T&& x){ emplace(begin(),mjstl::move(x));}
+        void push_back(const T& x){ emplace(end(),x);}
+        void push_back(T&& x){ emplace(end(),mjstl::move(x));}
+        void pop_front(){ erase(begin());}
+        void pop_back(){ erase(--end());}
+        iterator erase(iterator position);
+        iterator erase(iterator first,iterator last);
+        void clear();
+        void swap(unrolled_list& x);
+
+        /*把x的全部元素接到position之前，x变为空。*/
+        void splice(iterator position,unrolled_list& x);
+
+    protected:
+        static node_pointer __node(link_type l){ return static_cast<node_pointer>(l);}
+        void __initialize(){
+            head_.prev = head_.next = &head_;
+            size_ = 0;
+        }
+        node_pointer __create_node();
+        void __link_before(link_type position,node_pointer p);
+        void __destory_node(node_pointer p);
+        node_pointer __split(node_pointer p,size_type at);
+        template<class ...Args>
+        iterator __emplace_back_in(node_pointer p,Args&& ...args);
+        void __insert_shift(node_pointer p,size_type i,T&& x);
+        void __take(unrolled_list& x);
+    };
+
+template<class T,class Alloc,size_t N>
+unrolled_list<T,Alloc,N>::unrolled_list(size_type n,const T& value){
+    __initialize();
+    try{
+        for(; n > 0; --n) push_back(value);
+    }catch(...){
+        clear();
+        throw;
+    }
+}
+
+template<class T,class Alloc,size_t N>
+unrolled_list<T,Alloc,N>::unrolled_list(std::initializer_list<value_type> ilist){
+    __initialize();
+    try{
+        for(const T* p = ilist.begin(); p != ilist.end(); ++p) push_back(*p);
+    }catch(...){
+        clear();
+        throw;
+    }
+}
+
+template<class T,class Alloc,size_t N>
+template<class InputIterator,typename std::enable_if<
+  mjstl::is_input_iterator<InputIterator>::value,int>::type>
+unrolled_list<T,Alloc,N>::unrolled_list(InputIterator first,InputIterator last){
+    __initialize();
+    try{
+        for(; first != last; ++first) push_back(*first);
+    }catch(...){
+        clear();
+        throw;
+    }
+}
+
+template<class T,class Alloc,size_t N>
+unrolled_list<T,Alloc,N>::unrolled_list(const unrolled_list& x){
+    __initialize();
+    try{
+        for(const_iterator it = x.begin(); it != x.end(); ++it) push_back(*it);
+    }catch(...){
+        clear();
+        throw;
+    }
+}
+
+template<class T,class Alloc,size_t N>
+unrolled_list<T,Alloc,N>::unrolled_list(unrolled_list&& x){
+    __initialize();
+    __take(x);
+}
+
+template<class T,class Alloc,size_t N>
+unrolled_list<T,Alloc,N>& unrolled_list<T,Alloc,N>::operator=(const unrolled_list& x){
+    if(this != &x){
+        unrolled_list tmp(x);
+        swap(tmp);
+    }
+    return *this;
+}
+
+template<class T,class Alloc,size_t N>
+unrolled_list<T,Alloc,N>& unrolled_list<T,Alloc,N>::operator=(unrolled_list&& x){
+    if(this != &x){
+        clear();
+        __take(x);
+    }
+    return *this;
+}
+
+/*
+*   插在某节点开头(包括end())时，前一个节点有空位就追加到它末尾；
+* 否则若所在节点已满或是end()，在它前面开一个新节点。这两种情况都不移动已有元素，
+* 直接在目标位置构造。
+*   其余情况先把元素构造到tmp里(args可能引用本容器的元素)，节点满了先split，再挪出空位放入。
+*/
+template<class T,class Alloc,size_t N>
+template<class ...Args>
+typename unrolled_list<T,Alloc,N>::iterator
+unrolled_list<T,Alloc,N>::emplace(iterator position,Args&& ...args){
+    link_type l = position.node;
+    size_type i = position.index;
+    if(i == 0){
+        if(l->prev != &head_ && __node(l->prev)->count < N)
+            return __emplace_back_in(__node(l->prev),mjstl::forward<Args>(args)...);
+        if(l == &head_ || __node(l)->count == N){
+            node_pointer p = __create_node();
+            __link_before(l,p);
+            return __emplace_back_in(p,mjstl::forward<Args>(args)...);
+        }
+    }
+    node_pointer p = __node(l);
+    value_type tmp(mjstl::forward<Args>(args)...);
+    if(p->count == N){
+        node_pointer q = __split(p,N / 2);
+        if(i > N / 2){
+            p = q;
+            i -= N / 2;
+        }
+    }
+    __insert_shift(p,i,mjstl::move(tmp));
+    ++size_;
+    return iterator(p,i);
+}
+
+/*
+*   删除后节点空了就释放；和后继合起来不超过N/2个就把后继合并进来。
+*   返回被删元素的下一个元素的迭代器。
+*/
+template<class T,class Alloc,size_t N>
+typename unrolled_list<T,Alloc,N>::iterator
+unrolled_list<T,Alloc,N>::erase(iterator position){
+    node_pointer p = __node(position.node);
+    size_type i = position.index;
+    mjstl::unchecked_move(p->value(i + 1),p->value(p->count),p->value(i));
+    mjstl::destory(p->value(p->count - 1));
+    --p->count;
+    --size_;
+    if(p->count == 0){
+        link_type next = p->next;
+        __destory_node(p);
+        return iterator(next,0);
+    }
+    if(p->next != &head_ && p->count + __node(p->next)->count <= N / 2){
+        node_pointer q = __node(p->next);
+        for(size_type j = 0; j < q->count; ++j){
+            mjstl::construct(p->value(p->count),mjstl::move(*q->value(j)));
+            ++p->count;
+        }
+        __destory_node(q);
+    }
+    if(i < p->count) return iterator(p,i);
+    return iterator(p->next,0);
+}
+
+/*删除会合并节点，last可能失效，所以先数出个数再逐个删除。*/
+template<class T,class Alloc,size_t N>
+typename unrolled_list<T,Alloc,N>::iterator
+unrolled_list<T,Alloc,N>::erase(iterator first,iterator last){
+    for(difference_type n = mjstl::distance(first,last); n > 0; --n)
+        first = erase(first);
+    return first;
+}
+
+template<class T,class Alloc,size_t N>
+void unrolled_list<T,Alloc,N>::clear(){
+    link_type l = head_.next;
+    while(l != &head_){
+        node_pointer p = __node(l);
+        l = l->next;
+        mjstl::destory(p->value(0),p->value(p->count));
+        node_allocator().deallocate(p);
+    }
+    __initialize();
+}
+
+template<class T,class Alloc,size_t N>
+void unrolled_list<T,Alloc,N>::swap(unrolled_list& x){
+    if(this == &x) return;
+    unrolled_list tmp(mjstl::move(x));
+    x.__take(*this);
+    __take(tmp);
+}
+
+template<class T,class Alloc,size_t N>
+void unrolled_list<T,Alloc,N>::splice(iterator position,unrolled_list& x){
+    if(this == &x || x.empty()) return;
+    link_type l = position.node;
+    if(position.index != 0)
+        l = __split(__node(l),position.index);
+    link_type first = x.head_.next;
+    link_type last = x.head_.prev;
+    first->prev = l->prev;
+    l->prev->next = first;
+    last->next = l;
+    l->prev = last;
+    size_ += x.size_;
+    x.__initialize();
+}
+
+template<class T,class Alloc,size_t N>
+typename unrolled_list<T,Alloc,N>::node_pointer
+unrolled_list<T,Alloc,N>::__create_node(){
+    node_pointer p = node_allocator().allocate();
+    p->prev = p->next = nullptr;
+    p->count = 0;
+    return p;
+}
+
+template<class T,class Alloc,size_t N>
+void unrolled_list<T,Alloc,N>::__link_before(link_type position,node_pointer p){
+    p->next = position;
+    p->prev = position->prev;
+    position->prev->next = p;
+    position->prev = p;
+}
+
+/*摘下并释放节点，元素已由调用者析构或移走。*/
+template<class T,class Alloc,size_t N>
+void unrolled_list<T,Alloc,N>::__destory_node(node_pointer p){
+    p->prev->next = p->next;
+    p->next->prev = p->prev;
+    node_allocator().deallocate(p);
+}
+
+/*把p的[at,count)搬到紧跟p的新节点里，返回新节点。*/
+template<class T,class Alloc,size_t N>
+typename unrolled_list<T,Alloc,N>::node_pointer
+unrolled_list<T,Alloc,N>::__split(node_pointer p,size_type at){
+    node_pointer q = __create_node();
+    try{
+        for(size_type j = at; j < p->count; ++j){
+            mjstl::construct(q->value(q->count),mjstl::move(*p->value(j)));
+            ++q->count;
+        }
+    }catch(...){
+        mjstl::destory(q->value(0),q->value(q->count));
+        node_allocator().deallocate(q);
+        throw;
+    }
+    mjstl::destory(p->value(at),p->value(p->count));
+    p->count = at;
+    __link_before(p->next,q);
+    return q;
+}
+
+/*在p末尾直接构造；p是刚建的空节点且构造失败时把它释放掉。*/
+template<class T,class Alloc,size_t N>
+template<class ...Args>
+typename unrolled_list<T,Alloc,N>::iterator
+unrolled_list<T,Alloc,N>::__emplace_back_in(node_pointer p,Args&& ...args){
+    try{
+        mjstl::construct(p->value(p->count),mjstl::forward<Args>(args)...);
+    }catch(...){
+        if(p->count == 0) __destory_node(p);
+        throw;
+    }
+    ++p->count;
+    ++size_;
+    return iterator(p,p->count - 1);
+}
+
+/*p未满，把[i,count)后移一位，x放到i。*/
+template<class T,class Alloc,size_t N>
+void unrolled_list<T,Alloc,N>::__insert_shift(node_pointer p,size_type i,T&& x){
+    size_type n = p->count;
+    if(i == n){
+        mjstl::construct(p->value(n),mjstl::move(x));
+    }else{
+        mjstl::construct(p->value(n),mjstl::move(*p->value(n - 1)));
+        for(size_type j = n - 1; j > i; --j)
+            *p->value(j) = mjstl::move(*p->value(j - 1));
+        *p->value(i) = mjstl::move(x);
+    }
+    ++p->count;
+}
+
+/*本链表为空，接管x的全部节点，x变为空。*/
+template<class T,class Alloc,size_t N>
+void unrolled_list<T,Alloc,N>::__take(unrolled_list& x){
+    if(x.empty()) return;
+    head_.next = x.head_.next;
+    head_.prev = x.head_.prev;
+    head_.next->prev = &head_;
+    head_.prev->next = &head_;
+    size_ = x.size_;
+    x.__initialize();
+}
+
+template<class T,class Alloc,size_t N>
+inline bool operator==(const unrolled_list<T,Alloc,N>& x,const unrolled_list<T,Alloc,N>& y){
+    return x.size() == y.size() && mjstl::equal(x.begin(),x.end(),y.begin(),y.end());
+}
+
+template<class T,class Alloc,size_t N>
+inline bool operator!=(const unrolled_list<T,Alloc,N>& x,const unrolled_list<T,Alloc,N>& y){
+    return !(x == y);
+}
+
+template<class T,class Alloc,size_t N>
+inline bool operator<(const unrolled_list<T,Alloc,N>& x,const unrolled_list<T,Alloc,N>& y){
+    return mjstl::lexicographical_compare(x.begin(),x.end(),y.begin(),y.end());
+}
+
+template<class T,class Alloc,size_t N>
+inline void swap(unrolled_list<T,Alloc,N>& x,unrolled_list<T,Alloc,N>& y){
+    x.swap(y);
+}
+
+} // namespace mjstl
+#endif // !__UNROLLED_LIST_H__
@@ -27,5 +27,23 @@ T&& forward(typename std::remove_reference<T>::type&& arg) noexcept
     return static_cast<T&&>(arg);
 }
 
+/*
+*   侵入式容器用：hook是对象里的一个成员，由成员指针member算出偏移，从hook找回整个对象。
+*   偏移在一块与T同样大小、对齐的静态内存上计算，不需要构造T。
+*/
+template<class T,class M>
+inline std::ptrdiff_t __member_offset(M T::*member) noexcept
+{
+    static typename std::aligned_storage<sizeof(T),alignof(T)>::type probe;
+    const T* p = reinterpret_cast<const T*>(&probe);
+    return reinterpret_cast<const char*>(&(p->*member)) - reinterpret_cast<const char*>(p);
+}
+
+template<class T,class M>
+inline T* __hook_owner(M* hook,M T::*member) noexcept
+{
+    return reinterpret_cast<T*>(reinterpret_cast<char*>(hook) - __member_offset(member));
+}
+
 } // namespace mjstl
 #endif //!__UTIL_H__
\ No newline at end of file
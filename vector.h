@@ -9,6 +9,14 @@
 
 namespace mjstl{
 
+/*
+*   扩容后的容量：原有old_size个元素，还要再放n个。
+*   n不超过old_size时翻倍(空时为n)，否则正好放下，soa_vector也用这个策略。
+*/
+inline size_t __vector_grow(size_t old_size,size_t n){
+    return old_size + mjstl::max(old_size,n);
+}
+
 template <typename T,typename Alloc = alloc>
 class vector{
 public:
@@ -24,8 +32,8 @@ public:
     /*iterator_type*/
     typedef value_type*                         iterator;
     typedef const value_type*                   const_iterator;
-    typedef reverse_iterator<const_iterator>    const_reverse_iterator;
-    typedef reverse_iterator<iterator>          reverse_iterator;
+    typedef mjstl::reverse_iterator<const_iterator>    const_reverse_iterator;
+    typedef mjstl::reverse_iterator<iterator>          reverse_iterator;
 protected:
     typedef mjstl::allocator<T>             data_allocator;
 
@@ -102,6 +110,7 @@ public:
     void pop_back();
     iterator erase(iterator position);
     iterator erase(iterator first,iterator last);
+    iterator unordered_erase(iterator position);
     void clear();
     iterator insert(iterator position,const T& x);
     iterator insert(iterator position);
@@ -317,6 +326,20 @@ vector<T,Alloc>::erase(iterator first,iterator last){
     return first;
 }
 
+/*
+*   不保持元素次序的删除：用最后一个元素覆盖position，然后析构末尾元素，
+* 不必像erase那样把position之后的元素全部往前挪，O(1)。
+*/
+template <class T, class Alloc>
+typename vector<T,Alloc>::iterator 
+vector<T,Alloc>::unordered_erase(iterator position){
+    --finish;
+    if(position != finish)
+        *position = mjstl::move(*finish);
+    data_allocator::destory(finish);
+    return position;
+}
+
 template <class T, class Alloc>
 void vector<T,Alloc>::clear(){
     data_allocator::destory(start,finish);
@@ -336,6 +359,19 @@ inline void swap(vector<T,Alloc>& x,vector<T,Alloc>& y){
     x.swap(y);
 }
 
+/*
+*   删除所有使pred为true的元素，返回删除个数。
+*   一趟扫描把保留的元素move到前面，最后尾部一次性析构，
+* 而不是每删一个元素就erase一次，把后面元素整体前移。
+*/
+template <class T, class Alloc, class Predicate>
+typename vector<T,Alloc>::size_type erase_if(vector<T,Alloc>& v,Predicate pred){
+    typename vector<T,Alloc>::iterator it = __remove_if_move(v.begin(),v.end(),pred);
+    typename vector<T,Alloc>::size_type n = v.end() - it;
+    v.erase(it,v.end());
+    return n;
+}
+
 template <class T, class Alloc>
 template<class ...Args>
 void vector<T, Alloc>::__emplace_insert_aux(iterator position,Args&& ...args){
@@ -345,8 +381,7 @@ void vector<T, Alloc>::__emplace_insert_aux(iterator position,Args&& ...args){
         copy_backward(position,finish - 2,finish - 1);
         mjstl::construct(position,mjstl::forward<Args>(args)...);
     }else{
-        const size_type old_size = size();
-        const size_type new_size = old_size == 0 ? 1 : 2 * old_size;
+        const size_type new_size = __vector_grow(size(),1);
 
         iterator new_start = data_allocator::allocate(new_size);
         iterator new_finish = new_start;
@@ -378,8 +413,7 @@ void vector<T, Alloc>::__insert_aux(iterator position, const T& x){
         T x_copy = x;
         *position = x_copy;
     }else{
-        const size_type old_size = size();
-        const size_type new_size = old_size == 0 ? 1 : 2 * old_size;
+        const size_type new_size = __vector_grow(size(),1);
 
         iterator new_start = data_allocator::allocate(new_size);
         iterator new_finish = new_start;
@@ -461,8 +495,7 @@ void vector<T, Alloc>::__fill_insert(iterator position, size_type n,const T& x){
             uninitialized_fill_n(position,after_elems,x_copy);
         }
     }else{
-        size_type old_size = size();
-        size_type new_size = old_size + mjstl::max(old_size,n);
+        size_type new_size = __vector_grow(size(),n);
 
         iterator new_start = data_allocator::allocate(new_size);
         iterator new_finish = new_start;
@@ -621,8 +654,7 @@ void vector<T,Alloc>::__range_insert(iterator position,ForwardIterator first,
                 copy(first,mid,position);
             }
         }else{
-            const size_type old_size = size();
-            const size_type new_size = old_size + mjstl::max(old_size,n);
+            const size_type new_size = __vector_grow(size(),n);
 
             iterator new_start = data_allocator::allocate(new_size);
             iterator new_finish = new_start;
@@ -630,7 +662,7 @@ void vector<T,Alloc>::__range_insert(iterator position,ForwardIterator first,
             try{
                 new_finish = uninitialized_copy(start,position,new_finish);
                 new_finish = uninitialized_copy(first,last,new_finish);
-                new_finish = uninitialized_copy(position,last,new_finish);
+                new_finish = uninitialized_copy(position,finish,new_finish);
             }catch(...){
                 destory(new_start,new_finish);
                 data_allocator::deallocate(new_start,new_size);
@@ -647,7 +679,7 @@ void vector<T,Alloc>::__range_insert(iterator position,ForwardIterator first,
 
 template<class T,class Alloc>
 inline bool operator==(vector<T,Alloc>& x,vector<T,Alloc>& y){
-    return x.size() == y.size() && equal(x.begin(),x.end(),y.begin());
+    return x.size() == y.size() && equal(x.begin(),x.end(),y.begin(),y.end());
 }
 
 template<class T,class Alloc>
@@ -676,4 +708,6 @@ inline bool operator<=(vector<T,Alloc>& x,vector<T,Alloc>& y){
 }
 
 }// namespace ZMJ
+
+#include "bvector.h"
 #endif // ！__VECTOR_H__
\ No newline at end of file